@@ -1,24 +1,39 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import binary_sensor, sensor, climate
+from esphome.components.esp32 import add_idf_sdkconfig_option
 from esphome.const import (
+    CONF_HOST,
     CONF_ID,
+    CONF_OUTPUT,
+    CONF_PLATFORM,
+    CONF_PORT,
+    CONF_TYPE,
     CONF_TEMPERATURE,
     CONF_UPDATE_INTERVAL,
+    DEVICE_CLASS_DURATION,
     DEVICE_CLASS_HEAT,
     DEVICE_CLASS_TEMPERATURE,
     DEVICE_CLASS_PRESSURE,
     DEVICE_CLASS_PROBLEM,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
     UNIT_CELSIUS,
+    UNIT_MICROSECOND,
+    UNIT_MILLISECOND,
     UNIT_PERCENT,
+    UNIT_SECOND,
     UNIT_HECTOPASCAL,
 )
 from esphome import config_validation as cv
 import esphome.core as core
+import esphome.final_validate as fv
+from .expression import ExpressionError, compile_expression, input_ids
 
 
 CODEOWNERS = ["@sakrut"]
+AUTO_LOAD = ["socket"]
 # All sensors/climate are optional, so no required dependencies
 # DEPENDENCIES = ["binary_sensor", "sensor", "climate"]
 # Component constants
@@ -51,12 +66,80 @@ CONF_OEM_FAULT_CODE = "oem_fault_code"
 CONF_OEM_DIAGNOSTIC_CODE = "oem_diagnostic_code"
 CONF_MASTER_OT_VERSION = "master_ot_version"
 CONF_SLAVE_OT_VERSION = "slave_ot_version"
+# Bus handling options
+CONF_DEFERRED_DECODING = "deferred_decoding"
+CONF_TIMER_TRANSMIT = "timer_transmit"
+CONF_BUS_TASK = "bus_task"
+CONF_PASS_THROUGH_DEADLINE = "pass_through_deadline"
+CONF_DEADLINE_MISSES = "deadline_misses"
+CONF_MAX_RESPONSE_TIME = "max_response_time"
+CONF_MERGED_WRITES = "merged_writes"
+CONF_LISTEN_ONLY = "listen_only"
+CONF_OBSERVED_IDS = "observed_ids"
+CONF_DUPLICATE_FRAMES = "duplicate_frames"
+CONF_CHANGED_FRAMES = "changed_frames"
+CONF_MAX_AGE = "max_age"
+CONF_OUT_OF_TARGET = "out_of_target"
+CONF_ALLOCATION_GUARD = "allocation_guard"
+# Telemetry stream
+CONF_TELEMETRY = "telemetry"
+CONF_MAX_DATAGRAM_SIZE = "max_datagram_size"
+CONF_MAX_BATCH_AGE = "max_batch_age"
+CONF_OTGW_SERVER = "otgw_server"
+CONF_HISTORY = "history"
+CONF_BUFFER_SIZE = "buffer_size"
+CONF_PROFILER = "profiler"
+CONF_FLIGHT_RECORDER = "flight_recorder"
+CONF_INCIDENTS = "incidents"
+CONF_MIN_INTERVAL = "min_interval"
+# Bus utilization meter
+CONF_BUS_UTILIZATION = "bus_utilization"
+CONF_CEILING = "ceiling"
+CONF_UTILIZATION = "utilization"
+CONF_PASS_THROUGH = "pass_through"
+CONF_GATEWAY = "gateway"
+CONF_THERMOSTAT = "thermostat"
+CONF_HEADROOM = "headroom"
+CONF_DEFERRED_POLLS = "deferred_polls"
+# Bus health supervisor
+CONF_BUS_SUPERVISOR = "bus_supervisor"
+CONF_FAILURE_STREAK = "failure_streak"
+CONF_THERMOSTAT_SILENCE = "thermostat_silence"
+CONF_RECOVERIES = "recoveries"
+CONF_MEAN_RECOVERY_TIME = "mean_recovery_time"
+CONF_MAX_RECOVERY_TIME = "max_recovery_time"
+# Background table sync
+CONF_TABLE_SYNC = "table_sync"
+CONF_TABLES = "tables"
+CONF_BATCH = "batch"
+CONF_INTERVAL = "interval"
+CONF_VERIFY_SAMPLE = "verify_sample"
+CONF_PROGRESS = "progress"
+CONF_FRAMES = "frames"
+# Speculative prefetch
+CONF_PREFETCH = "prefetch"
+CONF_HIT_RATE = "hit_rate"
+CONF_LATENCY_SAVED = "latency_saved"
+CONF_DERIVED_SENSORS = "derived_sensors"
+CONF_EXPRESSION = "expression"
+CONF_BYTECODE_ID = "bytecode_id"
+# Heating override controller
+CONF_HEATING_CONTROL = "heating_control"
+CONF_BASE_TEMPERATURE = "base_temperature"
+CONF_CURVE_SLOPE = "curve_slope"
+CONF_MIN_WATER_TEMPERATURE = "min_water_temperature"
+CONF_MAX_WATER_TEMPERATURE = "max_water_temperature"
+CONF_KP = "kp"
+CONF_KI = "ki"
 
 # Generate namespaces
 opentherm_ns = cg.esphome_ns.namespace("esphome::opentherm")
+OpenThermMessageID = cg.global_ns.enum("OpenThermMessageID", is_class=True)
 OpenthermComponent = opentherm_ns.class_("OpenthermComponent", cg.Component)
 OpenthermClimate = opentherm_ns.class_("OpenthermClimate", climate.Climate, cg.Component)
 ClimateType = opentherm_ns.enum("ClimateType")
+HeatingControllerType = opentherm_ns.enum("HeatingControllerType", is_class=True)
+ProfileSlot = opentherm_ns.enum("ProfileSlot", is_class=True)
 
 # Climate types mapping
 CLIMATE_TYPES = {
@@ -64,63 +147,378 @@ CLIMATE_TYPES = {
     "heating_water": ClimateType.HEATING_WATER,
 }
 
+HEATING_CONTROLLER_TYPES = {
+    "hysteresis": HeatingControllerType.HYSTERESIS,
+    "pi": HeatingControllerType.PI,
+}
+
+# ESPHome's ESP8266 flash preference store holds 128 words. Each preference takes its
+# size rounded up to words plus a CRC word. The wifi component's saved credentials and
+# other components' flash preferences come out of the same store, so part of it is left
+# to them.
+ESP8266_FLASH_PREFERENCE_WORDS = 128
+ESP8266_FLASH_PREFERENCE_RESERVE = 32
+INCIDENT_SIZE = 208  # FlightRecorder::Incident
+TABLE_SIZE = 136  # TableSync::Table
+
+
+def flash_preference_words(size):
+    return (size + 3) // 4 + 1
+
+
+# Profiler slot sensors, each reporting the max time per update interval
+PROFILE_SLOTS = {
+    "thermostat_bus": ProfileSlot.THERMOSTAT_BUS,
+    "cached_response": ProfileSlot.CACHED_RESPONSE,
+    "command": ProfileSlot.COMMAND,
+    "poll": ProfileSlot.POLL,
+    "oem_reads": ProfileSlot.OEM_READS,
+    "climate_publish": ProfileSlot.CLIMATE_PUBLISH,
+    "update": ProfileSlot.UPDATE,
+}
+
+
+def validate_heating_control(config):
+    if config[CONF_MIN_WATER_TEMPERATURE] >= config[CONF_MAX_WATER_TEMPERATURE]:
+        raise cv.Invalid(f"{CONF_MIN_WATER_TEMPERATURE} must be below {CONF_MAX_WATER_TEMPERATURE}")
+    return config
+
+
+HEATING_CONTROL_SCHEMA = cv.All(cv.Schema({
+    cv.Optional(CONF_TYPE, default="pi"): cv.enum(HEATING_CONTROLLER_TYPES, lower=True),
+    # Feed-forward: water = base + slope * (room target - outside)
+    cv.Optional(CONF_BASE_TEMPERATURE, default=25.0): cv.float_range(min=0, max=80),
+    cv.Optional(CONF_CURVE_SLOPE, default=1.4): cv.float_range(min=0, max=5),
+    cv.Optional(CONF_MIN_WATER_TEMPERATURE, default=20.0): cv.float_range(min=0, max=100),
+    cv.Optional(CONF_MAX_WATER_TEMPERATURE, default=75.0): cv.float_range(min=0, max=100),
+    # PI gains: Kp in °C water per °C room error, Ki per hour
+    cv.Optional(CONF_KP, default=8.0): cv.float_range(min=0),
+    cv.Optional(CONF_KI, default=2.0): cv.float_range(min=0),
+}), validate_heating_control)
+
+
+TELEMETRY_SCHEMA = cv.Schema({
+    cv.Required(CONF_HOST): cv.ipv4address,
+    cv.Optional(CONF_PORT, default=7411): cv.port,
+    # Header is 10 bytes, each record 5 bytes; 508 keeps datagrams unfragmented
+    cv.Optional(CONF_MAX_DATAGRAM_SIZE, default=508): cv.int_range(min=15, max=508),
+    # Record deltas are 16-bit milliseconds, so a batch can't span more than ~65 s
+    cv.Optional(CONF_MAX_BATCH_AGE, default="5s"): cv.All(
+        cv.positive_time_period_milliseconds,
+        cv.Range(max=core.TimePeriod(seconds=60)),
+    ),
+})
+
+OTGW_SERVER_SCHEMA = cv.Schema({
+    # Same port as the OTGW firmware's serial-over-TCP server
+    cv.Optional(CONF_PORT, default=25238): cv.port,
+})
+
+HISTORY_SCHEMA = cv.Schema({
+    # Split into 256-byte blocks, the oldest block is dropped when full
+    cv.Optional(CONF_BUFFER_SIZE, default=4096): cv.int_range(min=512, max=65536),
+})
+
+# Freshness target of a cached value: older values are published as unavailable
+FRESHNESS_SCHEMA = cv.Schema({
+    cv.Optional(CONF_MAX_AGE): cv.positive_time_period_milliseconds,
+})
+
+# Sensors backed by a cached data ID, see OpenthermComponent::cachedValueFor()
+FRESHNESS_IDS = {
+    CONF_EXTERNAL_TEMPERATURE: OpenThermMessageID.Toutside,
+    CONF_RETURN_TEMPERATURE: OpenThermMessageID.Tret,
+    CONF_BOILER_TEMPERATURE: OpenThermMessageID.Tboiler,
+    CONF_PRESSURE: OpenThermMessageID.CHPressure,
+    CONF_MODULATION: OpenThermMessageID.RelModLevel,
+    CONF_HEATING_TARGET_TEMPERATURE: OpenThermMessageID.TSet,
+    CONF_ROOM_TEMPERATURE: OpenThermMessageID.Tr,
+    CONF_ROOM_SETPOINT: OpenThermMessageID.TrSet,
+}
+
+
+def validate_flight_recorder(config):
+    config.setdefault(CONF_INCIDENTS, 1 if core.CORE.is_esp8266 else 2)
+    words = config[CONF_INCIDENTS] * flash_preference_words(INCIDENT_SIZE)
+    if core.CORE.is_esp8266 and words > ESP8266_FLASH_PREFERENCE_WORDS - ESP8266_FLASH_PREFERENCE_RESERVE:
+        raise cv.Invalid(f"At most 1 {CONF_FLIGHT_RECORDER} incident fits in ESP8266 flash preferences")
+    return config
+
+
+FLIGHT_RECORDER_SCHEMA = cv.All(cv.Schema({
+    # Rotating flash slots, mirrors FlightRecorder::MAX_INCIDENTS; default 2, 1 on ESP8266
+    cv.Optional(CONF_INCIDENTS): cv.int_range(min=1, max=4),
+    # Incidents closer than this to the last saved one are dropped, bounding flash writes
+    cv.Optional(CONF_MIN_INTERVAL, default="1h"): cv.positive_time_period_milliseconds,
+}), validate_flight_recorder)
+
+PROFILER_SCHEMA = cv.Schema({
+    cv.Optional(name): sensor.sensor_schema(
+        unit_of_measurement=UNIT_MICROSECOND,
+        accuracy_decimals=0,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+    for name in PROFILE_SLOTS
+})
+
+
+UTILIZATION_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_PERCENT,
+    accuracy_decimals=1,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+RECOVERY_TIME_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_SECOND,
+    accuracy_decimals=1,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+BUS_SUPERVISOR_SCHEMA = cv.Schema({
+    # Invalid or missing frames in a row before a side counts as failed
+    cv.Optional(CONF_FAILURE_STREAK, default=5): cv.int_range(min=2, max=100),
+    # The thermostat talks at least once a second, this long without a valid request fails its side
+    cv.Optional(CONF_THERMOSTAT_SILENCE, default="30s"): cv.All(
+        cv.positive_time_period_milliseconds,
+        cv.Range(min=core.TimePeriod(seconds=5)),
+    ),
+    cv.Optional(CONF_RECOVERIES): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_MEAN_RECOVERY_TIME): RECOVERY_TIME_SENSOR_SCHEMA,
+    cv.Optional(CONF_MAX_RECOVERY_TIME): RECOVERY_TIME_SENSOR_SCHEMA,
+})
+
+BUS_UTILIZATION_SCHEMA = cv.Schema({
+    # Gateway polls that would push the boiler line above this are deferred
+    cv.Optional(CONF_CEILING, default="80%"): cv.percentage,
+    # Boiler line, total and split by who originated the exchange
+    cv.Optional(CONF_UTILIZATION): UTILIZATION_SENSOR_SCHEMA,
+    cv.Optional(CONF_PASS_THROUGH): UTILIZATION_SENSOR_SCHEMA,
+    cv.Optional(CONF_GATEWAY): UTILIZATION_SENSOR_SCHEMA,
+    # Thermostat line, forwarded exchanges only
+    cv.Optional(CONF_THERMOSTAT): UTILIZATION_SENSOR_SCHEMA,
+    # Ceiling minus boiler line utilization, negative when over
+    cv.Optional(CONF_HEADROOM): UTILIZATION_SENSOR_SCHEMA,
+    cv.Optional(CONF_DEFERRED_POLLS): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+})
+
+
+TABLE_SYNC_TABLES = ["tsp", "fault_history"]
+
+TABLE_SYNC_SCHEMA = cv.Schema({
+    # TSP (Data-ID 10/11) and fault history buffer (Data-ID 12/13)
+    cv.Optional(CONF_TABLES, default=TABLE_SYNC_TABLES): cv.All(
+        cv.ensure_list(cv.one_of(*TABLE_SYNC_TABLES, lower=True)),
+        cv.Length(min=1),
+    ),
+    # Entries read per step, each one a blocking boiler exchange
+    cv.Optional(CONF_BATCH, default=2): cv.int_range(min=1, max=8),
+    cv.Optional(CONF_INTERVAL, default="2s"): cv.All(
+        cv.positive_time_period_milliseconds,
+        cv.Range(min=core.TimePeriod(milliseconds=500)),
+    ),
+    # Entries of a table stored in flash read back at boot, rotating through the table
+    cv.Optional(CONF_VERIFY_SAMPLE, default=4): cv.int_range(min=0, max=128),
+    cv.Optional(CONF_PROGRESS): sensor.sensor_schema(
+        unit_of_measurement=UNIT_PERCENT,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Boiler exchanges spent on the sync since boot
+    cv.Optional(CONF_FRAMES): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+})
+
+
+PREFETCH_SCHEMA = cv.Schema({
+    cv.Optional(CONF_HIT_RATE): sensor.sensor_schema(
+        unit_of_measurement=UNIT_PERCENT,
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Mean boiler round trip the thermostat was spared per hit
+    cv.Optional(CONF_LATENCY_SAVED): sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=0,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+})
+
+
+def validate_expression(value):
+    value = cv.string_strict(value)
+    try:
+        compile_expression(value)
+    except ExpressionError as err:
+        raise cv.Invalid(f"Invalid expression '{value}': {err}") from err
+    return value
+
+
+def validate_derived_sensors(config):
+    # Mirrors ExpressionEngine::MAX_EXPRESSIONS / MAX_INPUTS
+    if len(config) > 8:
+        raise cv.Invalid("At most 8 derived sensors are supported")
+    ids = set()
+    for conf in config:
+        ids |= input_ids(compile_expression(conf[CONF_EXPRESSION]))
+    if len(ids) > 16:
+        raise cv.Invalid("Derived sensors can read at most 16 distinct data IDs")
+    return config
+
+
+DERIVED_SENSOR_SCHEMA = sensor.sensor_schema(accuracy_decimals=1).extend({
+    cv.Required(CONF_EXPRESSION): validate_expression,
+    cv.GenerateID(CONF_BYTECODE_ID): cv.declare_id(cg.uint8),
+})
+
+
+def validate_bus_options(config):
+    if config[CONF_TIMER_TRANSMIT] and not config[CONF_DEFERRED_DECODING]:
+        raise cv.Invalid(f"{CONF_TIMER_TRANSMIT} requires {CONF_DEFERRED_DECODING}: true")
+    if config[CONF_BUS_TASK] and not core.CORE.is_esp32:
+        raise cv.Invalid(f"{CONF_BUS_TASK} is only supported on ESP32")
+    if config[CONF_LISTEN_ONLY] and CONF_PREFETCH in config:
+        raise cv.Invalid(f"{CONF_PREFETCH} sends frames to the boiler and can't be used with {CONF_LISTEN_ONLY}")
+    if config[CONF_LISTEN_ONLY] and CONF_TABLE_SYNC in config:
+        raise cv.Invalid(f"{CONF_TABLE_SYNC} sends frames to the boiler and can't be used with {CONF_LISTEN_ONLY}")
+    # Flight recorder incidents and synced tables share the ESP8266 flash preference store
+    if core.CORE.is_esp8266:
+        used = flash_preference_words(INCIDENT_SIZE) * config.get(CONF_FLIGHT_RECORDER, {}).get(CONF_INCIDENTS, 0)
+        used += flash_preference_words(TABLE_SIZE) * len(config.get(CONF_TABLE_SYNC, {}).get(CONF_TABLES, []))
+        available = ESP8266_FLASH_PREFERENCE_WORDS - ESP8266_FLASH_PREFERENCE_RESERVE
+        if used > available:
+            raise cv.Invalid(f"{CONF_FLIGHT_RECORDER} and {CONF_TABLE_SYNC} need {used * 4} bytes of ESP8266 flash "
+                             f"preferences, {available * 4} are available after leaving room for wifi and other "
+                             "components; sync one table only or drop the flight recorder")
+    return config
+
+
+def final_validate_timer_transmit(config):
+    # ESP8266 timer1 also runs the Arduino core's waveform generator behind analogWrite/tone
+    if not (core.CORE.is_esp8266 and config[CONF_TIMER_TRANSMIT]):
+        return config
+    for output in fv.full_config.get().get(CONF_OUTPUT, []):
+        if output.get(CONF_PLATFORM) == "esp8266_pwm":
+            raise cv.Invalid(f"{CONF_TIMER_TRANSMIT} takes over ESP8266 timer1, which esp8266_pwm outputs also use")
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = final_validate_timer_transmit
+
+
 # Validation schema
-CONFIG_SCHEMA = cv.Schema({
+CONFIG_SCHEMA = cv.All(cv.Schema({
     cv.GenerateID(): cv.declare_id(OpenthermComponent),
     cv.Required(CONF_IN_PIN): cv.int_,
     cv.Required(CONF_OUT_PIN): cv.int_,
     cv.Required(CONF_SLAVE_IN_PIN): cv.int_,
     cv.Required(CONF_SLAVE_OUT_PIN): cv.int_,
     cv.Optional(CONF_UPDATE_INTERVAL, default="30s"): cv.positive_time_period_milliseconds,
+    # ISRs only record edge timestamps, frames are decoded in loop()
+    cv.Optional(CONF_DEFERRED_DECODING, default=False): cv.boolean,
+    # Frames are clocked out by a hardware timer, pass-through does not block loop()
+    cv.Optional(CONF_TIMER_TRANSMIT, default=False): cv.boolean,
+    # Pass-through runs in its own pinned FreeRTOS task (ESP32 only)
+    cv.Optional(CONF_BUS_TASK, default=False): cv.boolean,
+    # Never originate boiler bus frames, entities are fed from intercepted frames only
+    cv.Optional(CONF_LISTEN_ONLY, default=False): cv.boolean,
+    # Debug: count heap allocations made by loop/update/pass-through/control after setup
+    cv.Optional(CONF_ALLOCATION_GUARD, default=False): cv.boolean,
+    # Boiler reply budget per pass-through frame, the thermostat gets a cached/DATA-INVALID reply on miss
+    cv.Optional(CONF_PASS_THROUGH_DEADLINE): cv.All(
+        cv.positive_time_period_milliseconds,
+        cv.Range(min=core.TimePeriod(milliseconds=50), max=core.TimePeriod(milliseconds=800)),
+    ),
+    # Batched binary UDP stream of every decoded frame
+    cv.Optional(CONF_TELEMETRY): TELEMETRY_SCHEMA,
+    # Every bus frame as OTGW serial lines over TCP, for OTmonitor and similar tools
+    cv.Optional(CONF_OTGW_SERVER): OTGW_SERVER_SCHEMA,
+    # Compressed rolling history of key data IDs, exported at /opentherm/history
+    cv.Optional(CONF_HISTORY): HISTORY_SCHEMA,
+    # Frames around a fault, diagnostic or BLOR saved to flash, exported at /opentherm/incidents
+    cv.Optional(CONF_FLIGHT_RECORDER): FLIGHT_RECORDER_SCHEMA,
+    # TSP and fault history tables read in the background, cached in flash, exported at /opentherm/tables
+    cv.Optional(CONF_TABLE_SYNC): TABLE_SYNC_SCHEMA,
+    # Fetch the thermostat's predicted next READ ahead of time, answer it locally on a hit
+    cv.Optional(CONF_PREFETCH): PREFETCH_SCHEMA,
+    # Rolling bus occupancy, with admission control of cache polls
+    cv.Optional(CONF_BUS_UTILIZATION): BUS_UTILIZATION_SCHEMA,
+    # Reinitializes a side of the gateway that stopped producing valid frames
+    cv.Optional(CONF_BUS_SUPERVISOR): BUS_SUPERVISOR_SCHEMA,
+    # Times the component's code paths, summary logged every update interval
+    cv.Optional(CONF_PROFILER): PROFILER_SCHEMA,
+    # Sensors computed on-device from data IDs, see expression.py
+    cv.Optional(CONF_DERIVED_SENSORS): cv.All(cv.ensure_list(DERIVED_SENSOR_SCHEMA), validate_derived_sensors),
+    # Controller choosing the CH water setpoint during a heating override
+    cv.Optional(CONF_HEATING_CONTROL, default={}): HEATING_CONTROL_SCHEMA,
     cv.Optional(CONF_EXTERNAL_TEMPERATURE): sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
         accuracy_decimals=1,
         device_class=DEVICE_CLASS_TEMPERATURE,
         state_class=STATE_CLASS_MEASUREMENT,
-    ),
+    ).extend(FRESHNESS_SCHEMA),
     cv.Optional(CONF_RETURN_TEMPERATURE): sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
         accuracy_decimals=1,
         device_class=DEVICE_CLASS_TEMPERATURE,
         state_class=STATE_CLASS_MEASUREMENT,
-    ),
+    ).extend(FRESHNESS_SCHEMA),
     cv.Optional(CONF_BOILER_TEMPERATURE): sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
         accuracy_decimals=1,
         device_class=DEVICE_CLASS_TEMPERATURE,
         state_class=STATE_CLASS_MEASUREMENT,
-    ),
+    ).extend(FRESHNESS_SCHEMA),
     cv.Optional(CONF_PRESSURE): sensor.sensor_schema(
         unit_of_measurement=UNIT_HECTOPASCAL,
         accuracy_decimals=2,
         device_class=DEVICE_CLASS_PRESSURE,
         state_class=STATE_CLASS_MEASUREMENT,
-    ),
+    ).extend(FRESHNESS_SCHEMA),
     cv.Optional(CONF_MODULATION): sensor.sensor_schema(
         unit_of_measurement=UNIT_PERCENT,
         accuracy_decimals=1,
         state_class=STATE_CLASS_MEASUREMENT,
-    ),
+    ).extend(FRESHNESS_SCHEMA),
     cv.Optional(CONF_HEATING_TARGET_TEMPERATURE): sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
         accuracy_decimals=1,
         device_class=DEVICE_CLASS_TEMPERATURE,
         state_class=STATE_CLASS_MEASUREMENT,
-    ),
+    ).extend(FRESHNESS_SCHEMA),
     # Room temperature (ID 24) — actual room temp sent by master (e.g. QAA73)
     cv.Optional(CONF_ROOM_TEMPERATURE): sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
         accuracy_decimals=1,
         device_class=DEVICE_CLASS_TEMPERATURE,
         state_class=STATE_CLASS_MEASUREMENT,
-    ),
+    ).extend(FRESHNESS_SCHEMA),
     # Room setpoint (ID 16) — desired room temp set on master (e.g. QAA73)
     cv.Optional(CONF_ROOM_SETPOINT): sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
         accuracy_decimals=1,
         device_class=DEVICE_CLASS_TEMPERATURE,
         state_class=STATE_CLASS_MEASUREMENT,
-    ),
+    ).extend(FRESHNESS_SCHEMA),
     # Phase 1 sensors - Boiler limits and diagnostics
     cv.Optional(CONF_MAX_CH_SETPOINT): sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
@@ -151,6 +549,48 @@ CONFIG_SCHEMA = cv.Schema({
     cv.Optional(CONF_SLAVE_OT_VERSION): sensor.sensor_schema(
         accuracy_decimals=2,
     ),
+    # Pass-through deadline diagnostics
+    cv.Optional(CONF_DEADLINE_MISSES): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_MAX_RESPONSE_TIME): sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        accuracy_decimals=0,
+        device_class=DEVICE_CLASS_DURATION,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Number of distinct data IDs seen on the bus
+    cv.Optional(CONF_OBSERVED_IDS): sensor.sensor_schema(
+        accuracy_decimals=0,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Frames repeating the last value of their data ID, and frames carrying a new one
+    cv.Optional(CONF_DUPLICATE_FRAMES): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    cv.Optional(CONF_CHANGED_FRAMES): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # Time all values with a max_age spent out of target
+    cv.Optional(CONF_OUT_OF_TARGET): sensor.sensor_schema(
+        unit_of_measurement=UNIT_SECOND,
+        accuracy_decimals=0,
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
+    # User commands merged into a later write to the same target
+    cv.Optional(CONF_MERGED_WRITES): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ),
     cv.Optional(CONF_FLAME): binary_sensor.binary_sensor_schema(
         device_class=DEVICE_CLASS_HEAT,
     ),
@@ -170,7 +610,7 @@ CONFIG_SCHEMA = cv.Schema({
     cv.Optional(CONF_HEATING_WATER_CLIMATE): climate.climate_schema(
         OpenthermClimate,
     ),
-}).extend(cv.COMPONENT_SCHEMA)
+}).extend(cv.COMPONENT_SCHEMA), validate_bus_options)
 
 
 
@@ -183,6 +623,114 @@ async def to_code(config):
     cg.add(var.set_out_pin(config[CONF_OUT_PIN]))
     cg.add(var.set_slave_in_pin(config[CONF_SLAVE_IN_PIN]))
     cg.add(var.set_slave_out_pin(config[CONF_SLAVE_OUT_PIN]))
+    cg.add(var.set_deferred_decoding(config[CONF_DEFERRED_DECODING]))
+    cg.add(var.set_timer_transmit(config[CONF_TIMER_TRANSMIT]))
+    if config[CONF_TIMER_TRANSMIT] and core.CORE.using_esp_idf:
+        # Transmit timer callbacks have to run from the interrupt, not the esp_timer task
+        add_idf_sdkconfig_option("CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD", True)
+    cg.add(var.set_bus_task(config[CONF_BUS_TASK]))
+    cg.add(var.set_listen_only(config[CONF_LISTEN_ONLY]))
+    if config[CONF_ALLOCATION_GUARD]:
+        cg.add_build_flag("-DOPENTHERM_ALLOCATION_GUARD")
+        cg.add_build_flag("-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc")
+    if CONF_PASS_THROUGH_DEADLINE in config:
+        cg.add(var.set_pass_through_deadline(config[CONF_PASS_THROUGH_DEADLINE]))
+
+    if CONF_TELEMETRY in config:
+        telemetry = config[CONF_TELEMETRY]
+        cg.add(var.set_telemetry(
+            str(telemetry[CONF_HOST]),
+            telemetry[CONF_PORT],
+            telemetry[CONF_MAX_DATAGRAM_SIZE],
+            telemetry[CONF_MAX_BATCH_AGE],
+        ))
+
+    if CONF_OTGW_SERVER in config:
+        cg.add(var.set_frame_server_port(config[CONF_OTGW_SERVER][CONF_PORT]))
+
+    if CONF_HISTORY in config:
+        cg.add(var.set_history_size(config[CONF_HISTORY][CONF_BUFFER_SIZE]))
+
+    if CONF_FLIGHT_RECORDER in config:
+        conf = config[CONF_FLIGHT_RECORDER]
+        cg.add(var.set_flight_recorder(conf[CONF_INCIDENTS], conf[CONF_MIN_INTERVAL]))
+
+    for conf in config.get(CONF_DERIVED_SENSORS, []):
+        code = compile_expression(conf[CONF_EXPRESSION])
+        bytecode = cg.static_const_array(conf[CONF_BYTECODE_ID], cg.ArrayInitializer(*code))
+        sens = await sensor.new_sensor(conf)
+        cg.add(var.add_derived_sensor(sens, bytecode, len(code)))
+
+    if CONF_BUS_UTILIZATION in config:
+        bus = config[CONF_BUS_UTILIZATION]
+        cg.add(var.set_bus_utilization_ceiling(bus[CONF_CEILING]))
+        for key, setter in (
+            (CONF_UTILIZATION, var.set_bus_utilization_sensor),
+            (CONF_PASS_THROUGH, var.set_pass_through_utilization_sensor),
+            (CONF_GATEWAY, var.set_gateway_utilization_sensor),
+            (CONF_THERMOSTAT, var.set_thermostat_utilization_sensor),
+            (CONF_HEADROOM, var.set_bus_headroom_sensor),
+            (CONF_DEFERRED_POLLS, var.set_deferred_polls_sensor),
+        ):
+            if key in bus:
+                sens = await sensor.new_sensor(bus[key])
+                cg.add(setter(sens))
+
+    if CONF_BUS_SUPERVISOR in config:
+        supervisor = config[CONF_BUS_SUPERVISOR]
+        cg.add(var.set_bus_supervisor(supervisor[CONF_FAILURE_STREAK], supervisor[CONF_THERMOSTAT_SILENCE]))
+        for key, setter in (
+            (CONF_RECOVERIES, var.set_bus_recoveries_sensor),
+            (CONF_MEAN_RECOVERY_TIME, var.set_mean_recovery_time_sensor),
+            (CONF_MAX_RECOVERY_TIME, var.set_max_recovery_time_sensor),
+        ):
+            if key in supervisor:
+                sens = await sensor.new_sensor(supervisor[key])
+                cg.add(setter(sens))
+
+    if CONF_TABLE_SYNC in config:
+        tables = config[CONF_TABLE_SYNC]
+        cg.add(var.set_table_sync(
+            "tsp" in tables[CONF_TABLES],
+            "fault_history" in tables[CONF_TABLES],
+            tables[CONF_BATCH],
+            tables[CONF_VERIFY_SAMPLE],
+            tables[CONF_INTERVAL],
+        ))
+        for key, setter in (
+            (CONF_PROGRESS, var.set_table_sync_progress_sensor),
+            (CONF_FRAMES, var.set_table_sync_frames_sensor),
+        ):
+            if key in tables:
+                sens = await sensor.new_sensor(tables[key])
+                cg.add(setter(sens))
+
+    if CONF_PREFETCH in config:
+        prefetch = config[CONF_PREFETCH]
+        cg.add(var.set_prefetch(True))
+        if CONF_HIT_RATE in prefetch:
+            sens = await sensor.new_sensor(prefetch[CONF_HIT_RATE])
+            cg.add(var.set_prefetch_hit_rate_sensor(sens))
+        if CONF_LATENCY_SAVED in prefetch:
+            sens = await sensor.new_sensor(prefetch[CONF_LATENCY_SAVED])
+            cg.add(var.set_prefetch_latency_saved_sensor(sens))
+
+    if CONF_PROFILER in config:
+        cg.add(var.set_profiler_enabled(True))
+        for name, slot in PROFILE_SLOTS.items():
+            if name in config[CONF_PROFILER]:
+                sens = await sensor.new_sensor(config[CONF_PROFILER][name])
+                cg.add(var.set_profile_sensor(slot, sens))
+
+    heating_control = config[CONF_HEATING_CONTROL]
+    cg.add(var.set_heating_controller_type(heating_control[CONF_TYPE]))
+    cg.add(var.set_heating_curve(
+        heating_control[CONF_BASE_TEMPERATURE],
+        heating_control[CONF_CURVE_SLOPE],
+        heating_control[CONF_MIN_WATER_TEMPERATURE],
+        heating_control[CONF_MAX_WATER_TEMPERATURE],
+    ))
+    cg.add(var.set_heating_pi_gains(heating_control[CONF_KP], heating_control[CONF_KI]))
 
     # Register sensors
     if CONF_EXTERNAL_TEMPERATURE in config:
@@ -217,6 +765,14 @@ async def to_code(config):
         sens = await sensor.new_sensor(config[CONF_ROOM_SETPOINT])
         cg.add(var.set_room_setpoint_sensor(sens))
 
+    for key, msg_id in FRESHNESS_IDS.items():
+        if key in config and CONF_MAX_AGE in config[key]:
+            cg.add(var.set_max_age(msg_id, config[key][CONF_MAX_AGE]))
+
+    if CONF_OUT_OF_TARGET in config:
+        sens = await sensor.new_sensor(config[CONF_OUT_OF_TARGET])
+        cg.add(var.set_out_of_target_sensor(sens))
+
     # Phase 1 sensors
     if CONF_MAX_CH_SETPOINT in config:
         sens = await sensor.new_sensor(config[CONF_MAX_CH_SETPOINT])
@@ -246,6 +802,30 @@ async def to_code(config):
         sens = await sensor.new_sensor(config[CONF_SLAVE_OT_VERSION])
         cg.add(var.set_slave_ot_version_sensor(sens))
 
+    if CONF_DEADLINE_MISSES in config:
+        sens = await sensor.new_sensor(config[CONF_DEADLINE_MISSES])
+        cg.add(var.set_deadline_misses_sensor(sens))
+
+    if CONF_MAX_RESPONSE_TIME in config:
+        sens = await sensor.new_sensor(config[CONF_MAX_RESPONSE_TIME])
+        cg.add(var.set_max_response_time_sensor(sens))
+
+    if CONF_OBSERVED_IDS in config:
+        sens = await sensor.new_sensor(config[CONF_OBSERVED_IDS])
+        cg.add(var.set_observed_ids_sensor(sens))
+
+    if CONF_DUPLICATE_FRAMES in config:
+        sens = await sensor.new_sensor(config[CONF_DUPLICATE_FRAMES])
+        cg.add(var.set_duplicate_frames_sensor(sens))
+
+    if CONF_CHANGED_FRAMES in config:
+        sens = await sensor.new_sensor(config[CONF_CHANGED_FRAMES])
+        cg.add(var.set_changed_frames_sensor(sens))
+
+    if CONF_MERGED_WRITES in config:
+        sens = await sensor.new_sensor(config[CONF_MERGED_WRITES])
+        cg.add(var.set_merged_writes_sensor(sens))
+
     # Register binary sensors
     if CONF_FLAME in config:
         sens = await binary_sensor.new_binary_sensor(config[CONF_FLAME])
@@ -0,0 +1,178 @@
+"""Compiler for derived-sensor expressions.
+
+Expressions are arithmetic over data IDs, compiled into the stack bytecode
+run by ExpressionEngine (opentherm_expression.h):
+
+    Tboiler - Tret
+    hb(id15) * RelModLevel / 100
+    abs(Tdhw - TdhwSet)
+
+Data IDs are referenced by name (see DATA_IDS) or as idN. A bare reference
+reads the value as signed f8.8; u16(), hb() and lb() read the raw value,
+its high byte or its low byte. min(), max() and abs() are also available.
+"""
+
+import re
+import struct
+
+OP_CONST = 0x01
+OP_LOAD_F88 = 0x02
+OP_LOAD_U16 = 0x03
+OP_LOAD_HB = 0x04
+OP_LOAD_LB = 0x05
+OP_ADD = 0x10
+OP_SUB = 0x11
+OP_MUL = 0x12
+OP_DIV = 0x13
+OP_NEG = 0x14
+OP_MIN = 0x15
+OP_MAX = 0x16
+OP_ABS = 0x17
+
+MAX_STACK = 8
+
+DATA_IDS = {
+    "Status": 0,
+    "TSet": 1,
+    "MaxCapacityMinModLevel": 15,
+    "TrSet": 16,
+    "RelModLevel": 17,
+    "CHPressure": 18,
+    "DHWFlowRate": 19,
+    "Tr": 24,
+    "Tboiler": 25,
+    "Tdhw": 26,
+    "Toutside": 27,
+    "Tret": 28,
+    "TdhwSet": 56,
+    "MaxTSet": 57,
+}
+
+BINARY_OPS = {"+": OP_ADD, "-": OP_SUB, "*": OP_MUL, "/": OP_DIV}
+LOAD_FUNCTIONS = {"u16": OP_LOAD_U16, "hb": OP_LOAD_HB, "lb": OP_LOAD_LB}
+FUNCTIONS = {"min": (OP_MIN, 2), "max": (OP_MAX, 2), "abs": (OP_ABS, 1)}
+
+TOKEN = re.compile(r"\s*(?:(\d+\.?\d*|\.\d+)|([A-Za-z_]\w*)|(.))")
+
+
+class ExpressionError(ValueError):
+    pass
+
+
+def tokenize(text):
+    tokens = []
+    for number, name, symbol in TOKEN.findall(text.strip()):
+        if number:
+            tokens.append(("num", float(number)))
+        elif name:
+            tokens.append(("name", name))
+        elif symbol.strip():
+            tokens.append(("sym", symbol))
+    return tokens
+
+
+class _Parser:
+    def __init__(self, text):
+        self.tokens = tokenize(text)
+        self.pos = 0
+        self.code = bytearray()
+        self.depth = 0
+        self.max_depth = 0
+
+    def peek(self):
+        return self.tokens[self.pos] if self.pos < len(self.tokens) else (None, None)
+
+    def take(self, symbol=None):
+        token = self.peek()
+        if token[0] is None or (symbol is not None and token != ("sym", symbol)):
+            raise ExpressionError(f"expected '{symbol}'" if symbol else "unexpected end of expression")
+        self.pos += 1
+        return token
+
+    def emit(self, op, operand=b"", push=0):
+        self.code.append(op)
+        self.code += operand
+        self.depth += push
+        self.max_depth = max(self.max_depth, self.depth)
+
+    def data_id(self, name):
+        if name in DATA_IDS:
+            return DATA_IDS[name]
+        match = re.fullmatch(r"id(\d+)", name)
+        if match and int(match.group(1)) < 256:
+            return int(match.group(1))
+        raise ExpressionError(f"unknown data ID '{name}'")
+
+    def parse(self):
+        self.expression()
+        if self.pos != len(self.tokens):
+            raise ExpressionError(f"unexpected '{self.peek()[1]}'")
+        if self.max_depth > MAX_STACK:
+            raise ExpressionError("expression too deeply nested")
+        return bytes(self.code)
+
+    def expression(self):
+        self.term()
+        while self.peek() in (("sym", "+"), ("sym", "-")):
+            op = BINARY_OPS[self.take()[1]]
+            self.term()
+            self.emit(op, push=-1)
+
+    def term(self):
+        self.unary()
+        while self.peek() in (("sym", "*"), ("sym", "/")):
+            op = BINARY_OPS[self.take()[1]]
+            self.unary()
+            self.emit(op, push=-1)
+
+    def unary(self):
+        if self.peek() == ("sym", "-"):
+            self.take()
+            self.unary()
+            self.emit(OP_NEG)
+        else:
+            self.primary()
+
+    def primary(self):
+        kind, value = self.take()
+        if kind == "num":
+            self.emit(OP_CONST, struct.pack("<f", value), push=1)
+        elif kind == "sym" and value == "(":
+            self.expression()
+            self.take(")")
+        elif kind == "name" and value in LOAD_FUNCTIONS:
+            self.take("(")
+            name = self.take()
+            if name[0] != "name":
+                raise ExpressionError(f"{value}() takes a data ID")
+            self.take(")")
+            self.emit(LOAD_FUNCTIONS[value], bytes([self.data_id(name[1])]), push=1)
+        elif kind == "name" and value in FUNCTIONS:
+            op, arity = FUNCTIONS[value]
+            self.take("(")
+            for i in range(arity):
+                if i:
+                    self.take(",")
+                self.expression()
+            self.take(")")
+            self.emit(op, push=1 - arity)
+        elif kind == "name":
+            self.emit(OP_LOAD_F88, bytes([self.data_id(value)]), push=1)
+        else:
+            raise ExpressionError(f"unexpected '{value}'")
+
+
+def compile_expression(text):
+    """Returns the bytecode for an expression, raises ExpressionError."""
+    return _Parser(text).parse()
+
+
+def input_ids(code):
+    """Data IDs read by compiled bytecode."""
+    ids, pc = set(), 0
+    while pc < len(code):
+        op = code[pc]
+        if OP_LOAD_F88 <= op <= OP_LOAD_LB:
+            ids.add(code[pc + 1])
+        pc += 1 + (4 if op == OP_CONST else 1 if OP_LOAD_F88 <= op <= OP_LOAD_LB else 0)
+    return ids
@@ -0,0 +1,77 @@
+#include "opentherm_allocation_guard.h"
+
+#ifdef OPENTHERM_ALLOCATION_GUARD
+#include <cstddef>
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // The bus task and loop() each keep their own innermost scope
+#ifdef USE_ESP32
+    static thread_local AllocationSlot current_slot = AllocationSlot::NONE;
+#else
+    static AllocationSlot current_slot = AllocationSlot::NONE;
+#endif
+    // Plain counters: a lost increment under contention only under-reports
+    static volatile uint32_t counts[static_cast<uint8_t>(AllocationSlot::COUNT)];
+
+    AllocationScope::AllocationScope(AllocationSlot slot) : previous_(current_slot) { current_slot = slot; }
+
+    AllocationScope::~AllocationScope() { current_slot = previous_; }
+
+    uint32_t AllocationScope::get_count(AllocationSlot slot) { return counts[static_cast<uint8_t>(slot)]; }
+
+    uint32_t AllocationScope::get_total()
+    {
+      uint32_t total = 0;
+      for (uint8_t i = static_cast<uint8_t>(AllocationSlot::LOOP); i < static_cast<uint8_t>(AllocationSlot::COUNT); i++)
+        total += counts[i];
+      return total;
+    }
+
+    static void note_allocation()
+    {
+#ifdef USE_ESP32
+      // Allocations made during startup run before task-local storage is set up
+      if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+        return;
+#endif
+      if (current_slot != AllocationSlot::NONE)
+        counts[static_cast<uint8_t>(current_slot)]++;
+    }
+
+  } // namespace opentherm
+} // namespace esphome
+
+// Linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+extern "C"
+{
+  void *__real_malloc(size_t size);
+  void *__real_calloc(size_t count, size_t size);
+  void *__real_realloc(void *ptr, size_t size);
+
+  void *__wrap_malloc(size_t size)
+  {
+    esphome::opentherm::note_allocation();
+    return __real_malloc(size);
+  }
+
+  void *__wrap_calloc(size_t count, size_t size)
+  {
+    esphome::opentherm::note_allocation();
+    return __real_calloc(count, size);
+  }
+
+  void *__wrap_realloc(void *ptr, size_t size)
+  {
+    esphome::opentherm::note_allocation();
+    return __real_realloc(ptr, size);
+  }
+}
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    enum class AllocationSlot : uint8_t
+    {
+      NONE, // not counted, a scope with it leaves a guarded path unguarded
+      LOOP,
+      UPDATE,
+      PASS_THROUGH,
+      CONTROL,
+      COUNT
+    };
+
+    // Debug aid for the heap-free steady state. With `allocation_guard: true`
+    // malloc, calloc and realloc (and so operator new) are wrapped at link time,
+    // and every call made while a scope is open on the calling task is counted
+    // against the innermost scope's slot. Work that has to allocate but is not
+    // part of the steady state, like accepting a frame server client, runs in a
+    // NONE scope and is not counted. Without it a scope compiles to nothing.
+    class AllocationScope
+    {
+    public:
+#ifdef OPENTHERM_ALLOCATION_GUARD
+      explicit AllocationScope(AllocationSlot slot);
+      ~AllocationScope();
+      AllocationScope(const AllocationScope &) = delete;
+      AllocationScope &operator=(const AllocationScope &) = delete;
+
+      static uint32_t get_count(AllocationSlot slot);
+      static uint32_t get_total();
+
+    protected:
+      AllocationSlot previous_;
+#else
+      explicit AllocationScope(AllocationSlot slot) {}
+
+      static uint32_t get_count(AllocationSlot slot) { return 0; }
+      static uint32_t get_total() { return 0; }
+#endif
+    };
+
+  } // namespace opentherm
+} // namespace esphome
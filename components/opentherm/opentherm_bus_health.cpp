@@ -0,0 +1,79 @@
+#include "opentherm_bus_health.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    void BusHealth::record(Side side, bool ok, uint32_t now)
+    {
+      if (!is_configured())
+        return;
+
+      State &state = sides_[static_cast<uint8_t>(side)];
+      if (ok)
+      {
+        if (state.failed)
+        {
+          uint32_t recovery = now - state.failed_since;
+          state.recoveries++;
+          state.total_recovery_ms += recovery;
+          if (recovery > state.max_recovery_ms)
+            state.max_recovery_ms = recovery;
+          state.failed = false;
+        }
+        state.streak = 0;
+        state.last_good_at = now;
+        return;
+      }
+
+      if (state.streak == 0)
+        state.first_bad_at = now;
+      if (state.streak < UINT16_MAX)
+        state.streak++;
+      if (!state.failed && state.streak >= failure_streak_)
+        fail(state, state.first_bad_at, now);
+    }
+
+    void BusHealth::fail(State &state, uint32_t onset, uint32_t now)
+    {
+      state.failed = true;
+      state.failed_since = onset;
+      state.next_reset_at = now;
+      state.backoff_ms = FIRST_BACKOFF_MS;
+      state.failures++;
+    }
+
+    bool BusHealth::reset_due(Side side, uint32_t now)
+    {
+      if (!is_configured())
+        return false;
+
+      State &state = sides_[static_cast<uint8_t>(side)];
+      if (!state.failed && side == Side::THERMOSTAT && silence_ms_ != 0)
+      {
+        // Before the first frame the silence counts from boot
+        if (now - state.last_good_at > silence_ms_)
+          fail(state, state.last_good_at, now);
+      }
+      // Wrap-safe "now >= next_reset_at"
+      return state.failed && static_cast<int32_t>(now - state.next_reset_at) >= 0;
+    }
+
+    void BusHealth::on_reset(Side side, uint32_t now)
+    {
+      State &state = sides_[static_cast<uint8_t>(side)];
+      state.resets++;
+      state.streak = 0;
+      state.next_reset_at = now + state.backoff_ms;
+      state.backoff_ms = state.backoff_ms < MAX_BACKOFF_MS / 2 ? state.backoff_ms * 2 : MAX_BACKOFF_MS;
+    }
+
+    uint32_t BusHealth::get_mean_recovery_ms(Side side) const
+    {
+      const State &state = sides_[static_cast<uint8_t>(side)];
+      return state.recoveries != 0 ? state.total_recovery_ms / state.recoveries : 0;
+    }
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Health of one side of the gateway, judged from the frames it carries.
+    // A side fails after a streak of invalid or missing frames, or, for the
+    // thermostat side, after a silence longer than the master's cycle allows.
+    // A failed side is due for a reset at once, then again with a doubling
+    // backoff until a good frame arrives. Time to recover runs from the first
+    // bad frame (or the last good one, for a silence) to the next good frame.
+    // Writers hold the bus lock.
+    class BusHealth
+    {
+    public:
+      enum class Side : uint8_t
+      {
+        BOILER,
+        THERMOSTAT,
+        COUNT
+      };
+
+      static const uint32_t FIRST_BACKOFF_MS = 10000;
+      static const uint32_t MAX_BACKOFF_MS = 300000;
+
+      // silence_ms only applies to the thermostat side, the boiler speaks when spoken to
+      void configure(uint8_t failure_streak, uint32_t silence_ms)
+      {
+        failure_streak_ = failure_streak;
+        silence_ms_ = silence_ms;
+      }
+      bool is_configured() const { return failure_streak_ != 0; }
+
+      void record(Side side, bool ok, uint32_t now);
+      // True if the side failed and its next reset is due
+      bool reset_due(Side side, uint32_t now);
+      void on_reset(Side side, uint32_t now);
+
+      bool is_healthy(Side side) const { return !sides_[static_cast<uint8_t>(side)].failed; }
+      uint32_t get_failures(Side side) const { return sides_[static_cast<uint8_t>(side)].failures; }
+      uint32_t get_resets(Side side) const { return sides_[static_cast<uint8_t>(side)].resets; }
+      uint32_t get_recoveries(Side side) const { return sides_[static_cast<uint8_t>(side)].recoveries; }
+      uint32_t get_total_recovery_ms(Side side) const { return sides_[static_cast<uint8_t>(side)].total_recovery_ms; }
+      uint32_t get_mean_recovery_ms(Side side) const;
+      uint32_t get_max_recovery_ms(Side side) const { return sides_[static_cast<uint8_t>(side)].max_recovery_ms; }
+
+    protected:
+      struct State
+      {
+        uint16_t streak;
+        bool failed;
+        uint32_t first_bad_at;  // first frame of the current bad streak
+        uint32_t last_good_at;  // 0 = none yet
+        uint32_t failed_since;  // onset of the current failure
+        uint32_t next_reset_at;
+        uint32_t backoff_ms;
+        uint32_t failures;      // failure episodes
+        uint32_t resets;
+        uint32_t recoveries;
+        uint32_t total_recovery_ms;
+        uint32_t max_recovery_ms;
+      };
+
+      void fail(State &state, uint32_t onset, uint32_t now);
+
+      uint8_t failure_streak_{0};
+      uint32_t silence_ms_{0};
+      State sides_[static_cast<uint8_t>(Side::COUNT)]{};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
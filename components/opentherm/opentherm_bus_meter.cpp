@@ -0,0 +1,86 @@
+#include "opentherm_bus_meter.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Buckets are indexed by epoch (now / BUCKET_MS) and only count while the epoch
+    // is inside the window, so an idle bus decays to zero without any writes.
+    static bool in_window(uint32_t epoch, uint32_t current)
+    {
+      return current - epoch < BusMeter::BUCKETS;
+    }
+
+    void BusMeter::record(Source source, uint32_t exchange_ms, uint32_t now)
+    {
+      uint32_t epoch = now / BUCKET_MS;
+      Bucket &bucket = buckets_[epoch % BUCKETS];
+      if (bucket.epoch != epoch)
+        bucket = Bucket{epoch, {}, 0};
+
+      uint32_t busy = exchange_ms + FRAME_GAP_MS;
+      bucket.busy_ms[static_cast<uint8_t>(source)] += busy;
+      if (source == Source::PASS_THROUGH)
+        bucket.thermostat_ms += busy + 2 * FRAME_MS;
+      else
+        poll_cost_ = (poll_cost_ * 7 + busy) / 8;
+    }
+
+    uint32_t BusMeter::window_ms(uint32_t now)
+    {
+      // Full buckets plus the running part of the current one
+      return (BUCKETS - 1) * BUCKET_MS + now % BUCKET_MS;
+    }
+
+    uint32_t BusMeter::sum_busy(int source, uint32_t now) const
+    {
+      uint32_t current = now / BUCKET_MS;
+      uint32_t total = 0;
+      for (const Bucket &bucket : buckets_)
+      {
+        if (!in_window(bucket.epoch, current))
+          continue;
+        for (uint8_t i = 0; i < static_cast<uint8_t>(Source::COUNT); i++)
+        {
+          if (source < 0 || source == i)
+            total += bucket.busy_ms[i];
+        }
+      }
+      return total;
+    }
+
+    uint32_t BusMeter::sum_thermostat(uint32_t now) const
+    {
+      uint32_t current = now / BUCKET_MS;
+      uint32_t total = 0;
+      for (const Bucket &bucket : buckets_)
+      {
+        if (in_window(bucket.epoch, current))
+          total += bucket.thermostat_ms;
+      }
+      return total;
+    }
+
+    float BusMeter::get_utilization(uint32_t now) const
+    {
+      return static_cast<float>(sum_busy(-1, now)) / window_ms(now);
+    }
+
+    float BusMeter::get_utilization(Source source, uint32_t now) const
+    {
+      return static_cast<float>(sum_busy(static_cast<int>(source), now)) / window_ms(now);
+    }
+
+    float BusMeter::get_thermostat_utilization(uint32_t now) const
+    {
+      return static_cast<float>(sum_thermostat(now)) / window_ms(now);
+    }
+
+    bool BusMeter::admit(float ceiling, uint32_t now) const
+    {
+      return sum_busy(-1, now) + poll_cost_ <= ceiling * window_ms(now);
+    }
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Bus occupancy over a rolling window of fixed buckets. Every exchange on the
+    // boiler line counts from the start of the request to the end of the response,
+    // plus the 100 ms the master must leave before its next request. The thermostat
+    // line carries forwarded exchanges only, with its own request and response
+    // frames on top. Writers hold the bus lock; readers in update() tolerate a
+    // bucket being rotated underneath them.
+    class BusMeter
+    {
+    public:
+      enum class Source : uint8_t
+      {
+        PASS_THROUGH,
+        GATEWAY,
+        COUNT
+      };
+
+      static const uint8_t BUCKETS = 6;
+      static const uint32_t BUCKET_MS = 10000;
+      static const uint32_t FRAME_MS = 34;      // 32 data bits plus start and stop at 1 kbit/s
+      static const uint32_t FRAME_GAP_MS = 100; // minimum idle time between exchanges
+
+      void record(Source source, uint32_t exchange_ms, uint32_t now);
+
+      // Busy fraction (0..1) of the boiler line, total or per source
+      float get_utilization(uint32_t now) const;
+      float get_utilization(Source source, uint32_t now) const;
+      float get_thermostat_utilization(uint32_t now) const;
+
+      // Expected boiler line time of one more gateway poll (moving average)
+      uint32_t get_poll_cost() const { return poll_cost_; }
+      // True if one more poll keeps the boiler line at or below the ceiling
+      bool admit(float ceiling, uint32_t now) const;
+
+    protected:
+      struct Bucket
+      {
+        uint32_t epoch;
+        uint32_t busy_ms[static_cast<uint8_t>(Source::COUNT)];
+        uint32_t thermostat_ms;
+      };
+
+      uint32_t sum_busy(int source, uint32_t now) const; // source < 0 sums all sources
+      uint32_t sum_thermostat(uint32_t now) const;
+      static uint32_t window_ms(uint32_t now);
+
+      Bucket buckets_[BUCKETS]{};
+      uint32_t poll_cost_{2 * FRAME_MS + FRAME_GAP_MS};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
@@ -14,15 +14,9 @@ namespace esphome
 
       if (parent_ != nullptr)
       {
-        bool success = parent_->sendBoilerReset();
-        if (success)
-        {
-          ESP_LOGI(TAG, "Boiler reset command sent successfully");
-        }
-        else
-        {
-          ESP_LOGW(TAG, "Boiler reset command failed");
-        }
+        // Sent from the component's loop ahead of any pending setpoint write
+        parent_->queueCommand(CommandType::BOILER_RESET);
+        ESP_LOGI(TAG, "Boiler reset command queued");
       }
       else
       {
@@ -1,4 +1,5 @@
 #include "opentherm_climate.h"
+#include "opentherm_allocation_guard.h"
 #include "esphome/core/log.h"
 
 namespace esphome {
@@ -35,11 +36,14 @@ climate::ClimateTraits OpenthermClimate::traits() {
 }
 
 void OpenthermClimate::control(const climate::ClimateCall &call) {
+  AllocationScope allocation_scope(AllocationSlot::CONTROL);
+  bool changed = false;
+
   if (call.get_mode().has_value()) {
     esphome::climate::ClimateMode mode = *call.get_mode(); 
     ESP_LOGD(TAG, "Setting mode to %d", mode);
     this->mode = mode;
-    this->publish_state();
+    changed = true;
   }
   
   if (call.get_target_temperature().has_value()) {
@@ -48,10 +52,14 @@ void OpenthermClimate::control(const climate::ClimateCall &call) {
     this->target_temperature = temp;
     target_temperature_initialized_ = true;  // Mark as user-set
 
-    if (target_temperature_setter_) {
-      target_temperature_setter_(temp);
+    if (target_temperature_setter_ != nullptr) {
+      target_temperature_setter_(target_temperature_context_, temp);
     }
+    changed = true;
+  }
 
+  // One publish per call, even when mode and target both change
+  if (changed) {
     this->publish_state();
   }
 }
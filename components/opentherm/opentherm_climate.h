@@ -2,7 +2,6 @@
 
 #include "esphome/core/component.h"
 #include "esphome/components/climate/climate.h"
-#include <functional>
 
 namespace esphome
 {
@@ -20,7 +19,12 @@ namespace esphome
       climate::ClimateTraits traits() override;
       void control(const climate::ClimateCall &call) override;
 
-      void set_target_temperature_callback(std::function<bool(float)> callback) { target_temperature_setter_ = callback; }
+      // Plain function pointer plus context, so the setter never allocates
+      typedef bool (*TargetTemperatureCallback)(void *context, float temperature);
+      void set_target_temperature_callback(TargetTemperatureCallback callback, void *context) {
+        target_temperature_setter_ = callback;
+        target_temperature_context_ = context;
+      }
       void set_climate_type(ClimateType type) { climate_type_ = type; }
       ClimateType get_climate_type() const { return climate_type_; }
 
@@ -34,7 +38,8 @@ namespace esphome
 
     protected:
       float default_target_temperature_{0};
-      std::function<bool(float)> target_temperature_setter_;
+      TargetTemperatureCallback target_temperature_setter_{nullptr};
+      void *target_temperature_context_{nullptr};
       ClimateType climate_type_;
       bool target_temperature_initialized_{false};
     };
@@ -0,0 +1,70 @@
+#include "opentherm_command_queue.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    uint8_t CommandQueue::priority(CommandType type)
+    {
+      switch (type)
+      {
+        case CommandType::BOILER_RESET:
+          return 3;
+        case CommandType::DHW_SETPOINT:
+        case CommandType::ROOM_SETPOINT:
+          return 2;
+        default:
+          return 0;
+      }
+    }
+
+    bool CommandQueue::push(CommandType type, float value)
+    {
+      Slot &slot = slots_[static_cast<uint8_t>(type)];
+      bool merged = slot.pending;
+
+      slot.value = value;
+      queued_++;
+      if (merged)
+      {
+        // Keep the original position in the queue, only the value changes
+        merged_++;
+        return true;
+      }
+
+      slot.sequence = sequence_++;
+      slot.pending = true;
+      pending_count_++;
+      return false;
+    }
+
+    bool CommandQueue::pop(CommandType &type, float &value)
+    {
+      int best = -1;
+      for (uint8_t i = 0; i < static_cast<uint8_t>(CommandType::COUNT); i++)
+      {
+        if (!slots_[i].pending)
+          continue;
+        if (best < 0)
+        {
+          best = i;
+          continue;
+        }
+        uint8_t p = priority(static_cast<CommandType>(i));
+        uint8_t best_p = priority(static_cast<CommandType>(best));
+        if (p > best_p || (p == best_p && slots_[i].sequence < slots_[best].sequence))
+          best = i;
+      }
+      if (best < 0)
+        return false;
+
+      slots_[best].pending = false;
+      pending_count_--;
+      type = static_cast<CommandType>(best);
+      value = slots_[best].value;
+      return true;
+    }
+
+  } // namespace opentherm
+} // namespace esphome
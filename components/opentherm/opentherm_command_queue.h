@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // User commands written to the boiler, one pending slot per target
+    enum class CommandType : uint8_t
+    {
+      BOILER_RESET,
+      DHW_SETPOINT,
+      ROOM_SETPOINT,
+      COUNT
+    };
+
+    // Coalescing priority queue for user commands. A new command for a target
+    // replaces the pending one (only the latest setpoint is written), and commands
+    // are executed by priority: BLOR > setpoints. Gateway reads issued from update()
+    // rank below both - OEM diagnostics, then background polls - and yield to any
+    // pending command.
+    class CommandQueue
+    {
+    public:
+      // Returns true if an older pending command for the same target was merged away
+      bool push(CommandType type, float value);
+      // Highest priority pending command, oldest first within a priority
+      bool pop(CommandType &type, float &value);
+      bool empty() const { return pending_count_ == 0; }
+
+      uint32_t get_queued() const { return queued_; }
+      uint32_t get_merged() const { return merged_; }
+
+    protected:
+      static uint8_t priority(CommandType type);
+
+      struct Slot
+      {
+        float value{0.0f};
+        uint32_t sequence{0};
+        bool pending{false};
+      };
+
+      Slot slots_[static_cast<uint8_t>(CommandType::COUNT)];
+      uint8_t pending_count_{0};
+      uint32_t sequence_{0};
+      uint32_t queued_{0};
+      uint32_t merged_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
@@ -1,5 +1,7 @@
 #include "opentherm_component.h"
 #include "esphome/core/log.h"
+#include <cinttypes>
+#include <new>
 
 namespace esphome
 {
@@ -8,12 +10,53 @@ namespace esphome
 
     static const char *const TAG = "opentherm.component";
 
+    // Data IDs held in CachedValue entries, see cachedValueFor()
+    static const struct
+    {
+      const char *name;
+      OpenThermMessageID id;
+    } CACHED_IDS[] = {
+        {"Toutside", OpenThermMessageID::Toutside},
+        {"Tret", OpenThermMessageID::Tret},
+        {"Tboiler", OpenThermMessageID::Tboiler},
+        {"CHPressure", OpenThermMessageID::CHPressure},
+        {"RelModLevel", OpenThermMessageID::RelModLevel},
+        {"TSet", OpenThermMessageID::TSet},
+        {"Tdhw", OpenThermMessageID::Tdhw},
+        {"TdhwSet", OpenThermMessageID::TdhwSet},
+        {"Tr", OpenThermMessageID::Tr},
+        {"TrSet", OpenThermMessageID::TrSet},
+    };
+
+    // Serializes boiler bus access between the bus task and loop()/update(). It also
+    // guards the state pass-through shares with loop(): the override flags and
+    // setpoints, the heating controller and the profiler window. Recursive, since
+    // pass-through in the task calls sendBoilerRequest() while holding it.
+    class OpenthermComponent::BusLock
+    {
+    public:
+      explicit BusLock(OpenthermComponent *parent) : parent_(parent)
+      {
+#ifdef USE_ESP32
+        if (parent_->bus_mutex_ != nullptr)
+          xSemaphoreTakeRecursive(parent_->bus_mutex_, portMAX_DELAY);
+#endif
+      }
+      ~BusLock()
+      {
+#ifdef USE_ESP32
+        if (parent_->bus_mutex_ != nullptr)
+          xSemaphoreGiveRecursive(parent_->bus_mutex_);
+#endif
+      }
+
+    protected:
+      OpenthermComponent *parent_;
+    };
+
     // Initialize static members
     OpenthermComponent *OpenthermComponent::instance_ = nullptr;
     unsigned long OpenthermComponent::last_status_response_ = 0;
-    unsigned long OpenthermComponent::last_intercepted_response_ = 0;
-    OpenThermMessageID OpenthermComponent::last_intercepted_id_ = static_cast<OpenThermMessageID>(0);
-    bool OpenthermComponent::has_new_intercepted_response_ = false;
 
     OpenthermComponent::OpenthermComponent(uint32_t update_interval) : PollingComponent(update_interval)
     {
@@ -24,95 +67,703 @@ namespace esphome
     {
       ESP_LOGD(TAG, "Setting up OpenTherm component");
 
-      // Initialize OpenTherm instances
-      ot_ = new OpenTherm(in_pin_, out_pin_, false);                  // Master
-      slave_ot_ = new OpenTherm(slave_in_pin_, slave_out_pin_, true); // Slave
+      if (heating_controller_type_ == HeatingControllerType::HYSTERESIS)
+        heating_controller_ = &hysteresis_controller_;
+      else
+        heating_controller_ = &pi_controller_;
+      heating_controller_->set_curve(heating_curve_);
+      pi_controller_.set_gains(heating_kp_, heating_ki_);
+
+      // Initialize OpenTherm instances in the component's own storage
+      ot_ = new (ot_storage_) OpenTherm(in_pin_, out_pin_, false);                        // Master
+      slave_ot_ = new (slave_ot_storage_) OpenTherm(slave_in_pin_, slave_out_pin_, true); // Slave
 
       // Start OpenTherm communication
-      ot_->begin(handleInterrupt);
-      slave_ot_->begin(slaveHandleInterrupt, processRequest);
+      if (deferred_decoding_)
+      {
+        // Library instances are only used for frame helpers, the pins are driven here
+        pinMode(in_pin_, INPUT);
+        pinMode(out_pin_, OUTPUT);
+        pinMode(slave_in_pin_, INPUT);
+        pinMode(slave_out_pin_, OUTPUT);
+        digitalWrite(out_pin_, HIGH);       // Idle state
+        digitalWrite(slave_out_pin_, HIGH); // Idle state
+        attachInterrupt(digitalPinToInterrupt(in_pin_), handleEdgeInterrupt, CHANGE);
+        attachInterrupt(digitalPinToInterrupt(slave_in_pin_), slaveHandleEdgeInterrupt, CHANGE);
+        ESP_LOGI(TAG, "Using deferred Manchester decoding");
+
+        if (timer_transmit_ && !transmitter_.setup())
+        {
+          ESP_LOGW(TAG, "Transmit timer unavailable, falling back to busy-wait transmit");
+          timer_transmit_ = false;
+        }
+      }
+      else
+      {
+        ot_->begin(handleInterrupt);
+        slave_ot_->begin(slaveHandleInterrupt, processRequest);
+      }
+
+      // Arm the startup deadlines; the guard and the freshness targets count from boot
+      uint32_t uptime = millis();
+      timers_.advance(clock_.extend(uptime));
+      if (uptime < STARTUP_GUARD_)
+        timers_.schedule(startup_guard_timer_, STARTUP_GUARD_ - uptime);
+      if (hot_water_climate_ != nullptr)
+        timers_.schedule(dhw_sync_timer_, FORCE_UPDATE_CYCLES_ * get_update_interval());
+      for (const auto &entry : CACHED_IDS)
+      {
+        CachedValue &cache = *cachedValueFor(entry.id);
+        if (cache.max_age != 0)
+          timers_.schedule(cache.freshness_timer, cache.max_age > uptime ? cache.max_age - uptime : 0);
+      }
 
       // Setup climate controllers
       if (hot_water_climate_ != nullptr)
       {
-        hot_water_climate_->set_target_temperature_callback([this](float temperature)
-                                                            { return this->setHotWaterTemperature(temperature); });
+        hot_water_climate_->set_target_temperature_callback(queueDhwSetpoint, this);
       }
 
       if (heating_water_climate_ != nullptr)
       {
-        heating_water_climate_->set_target_temperature_callback([this](float temperature)
-                                                                { return this->setHeatingTargetTemperature(temperature); });
+        heating_water_climate_->set_target_temperature_callback(queueRoomSetpoint, this);
       }
 
       // Read Phase 1 values once at startup (these don't change)
-      delay(1000); // Give OpenTherm time to initialize
-
-      // Read max CH setpoint (Data-ID 57)
-      if (max_ch_setpoint_sensor_ != nullptr)
+      if (listen_only_)
+      {
+        ESP_LOGI(TAG, "Listen-only mode: boiler limits and versions are taken from intercepted frames");
+      }
+      else
       {
-        unsigned long response = ot_->sendRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::MaxTSet, 0));
-        if (ot_->isValidResponse(response))
+        delay(1000); // Give OpenTherm time to initialize
+
+        // Read max CH setpoint (Data-ID 57)
+        if (max_ch_setpoint_sensor_ != nullptr)
         {
-          float value = ot_->getFloat(response);
-          max_ch_setpoint_sensor_->publish_state(value);
-          ESP_LOGI(TAG, "Max CH setpoint: %.1f°C", value);
+          unsigned long response = sendBoilerRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::MaxTSet, 0));
+          if (ot_->isValidResponse(response))
+          {
+            float value = ot_->getFloat(response);
+            max_ch_setpoint_sensor_->publish_state(value);
+            ESP_LOGI(TAG, "Max CH setpoint: %.1f°C", value);
+          }
         }
-      }
 
-      // Note: Min CH setpoint (Data-ID 58) is not in standard OpenTherm spec
-      // Most boilers don't support it, so we skip it
+        // Note: Min CH setpoint (Data-ID 58) is not in standard OpenTherm spec
+        // Most boilers don't support it, so we skip it
 
-      // Read max relative modulation (Data-ID 14)
-      if (max_modulation_sensor_ != nullptr)
-      {
-        unsigned long response = ot_->sendRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::MaxRelModLevelSetting, 0));
-        if (ot_->isValidResponse(response))
+        // Read max relative modulation (Data-ID 14)
+        if (max_modulation_sensor_ != nullptr)
         {
-          float value = ot_->getFloat(response);
-          max_modulation_sensor_->publish_state(value);
-          ESP_LOGI(TAG, "Max modulation: %.1f%%", value);
+          unsigned long response = sendBoilerRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::MaxRelModLevelSetting, 0));
+          if (ot_->isValidResponse(response))
+          {
+            float value = ot_->getFloat(response);
+            max_modulation_sensor_->publish_state(value);
+            ESP_LOGI(TAG, "Max modulation: %.1f%%", value);
+          }
         }
-      }
 
-      // Read OpenTherm versions (Data-ID 124, 125)
-      if (master_ot_version_sensor_ != nullptr)
-      {
-        unsigned long response = ot_->sendRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::OpenThermVersionMaster, 0));
-        if (ot_->isValidResponse(response))
+        // Read OpenTherm versions (Data-ID 124, 125)
+        if (master_ot_version_sensor_ != nullptr)
         {
-          float value = ot_->getFloat(response);
-          master_ot_version_sensor_->publish_state(value);
-          ESP_LOGI(TAG, "Master OT version: %.2f", value);
+          unsigned long response = sendBoilerRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::OpenThermVersionMaster, 0));
+          if (ot_->isValidResponse(response))
+          {
+            float value = ot_->getFloat(response);
+            master_ot_version_sensor_->publish_state(value);
+            ESP_LOGI(TAG, "Master OT version: %.2f", value);
+          }
         }
+
+        if (slave_ot_version_sensor_ != nullptr)
+        {
+          unsigned long response = sendBoilerRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::OpenThermVersionSlave, 0));
+          if (ot_->isValidResponse(response))
+          {
+            float value = ot_->getFloat(response);
+            slave_ot_version_sensor_->publish_state(value);
+            ESP_LOGI(TAG, "Slave OT version: %.2f", value);
+          }
+        }
+      }
+
+      if (telemetry_.is_configured())
+        telemetry_.setup();
+
+      if (frame_server_.is_configured())
+        frame_server_.setup();
+
+      bool history_ready = history_.is_configured() && history_.setup();
+      if (recorder_.is_configured())
+        recorder_.setup();
+      if (table_sync_.is_configured())
+        table_sync_.setup();
+#ifdef USE_WEBSERVER
+      if (web_server_base::global_web_server_base != nullptr)
+      {
+        web_server_base::global_web_server_base->add_handler(&snapshot_handler_);
+        web_server_base::global_web_server_base->add_handler(&trace_export_);
+        if (history_ready)
+          web_server_base::global_web_server_base->add_handler(&history_export_);
+        if (recorder_.is_configured())
+          web_server_base::global_web_server_base->add_handler(&incident_export_);
+        if (table_sync_.is_configured())
+          web_server_base::global_web_server_base->add_handler(&table_export_);
+      }
+#else
+      (void) history_ready;
+#endif
+
+#ifdef USE_ESP32
+      if (bus_task_)
+        startBusTask();
+#endif
+    }
+
+    void OpenthermComponent::loop()
+    {
+      AllocationScope allocation_scope(AllocationSlot::LOOP);
+
+      // Fire every deadline that passed since the last iteration
+      timers_.advance(clock_.extend(millis()));
+
+      // With a bus task running, pass-through happens there and loop() only consumes the queue
+      if (!bus_task_)
+      {
+        ProfileScope scope(profiler_, ProfileSlot::THERMOSTAT_BUS);
+        processThermostatBus();
+        runPrefetch();
+      }
+
+      // Process intercepted frames queued by the pass-through path
+      InterceptedFrame item;
+      while (intercepted_frames_.pop(item))
+      {
+        processCachedResponse(item.frame, static_cast<OpenThermMessageID>(item.id));
+      }
+
+      // One user command per iteration keeps a single loop() pass short
+      processNextCommand();
+
+      superviseBus();
+      runTableSync();
+
+      telemetry_.loop(millis());
+      frame_server_.loop();
+      recorder_.loop(millis());
+    }
+
+    bool OpenthermComponent::queueDhwSetpoint(void *context, float temperature)
+    {
+      static_cast<OpenthermComponent *>(context)->queueCommand(CommandType::DHW_SETPOINT, temperature);
+      return true;
+    }
+
+    bool OpenthermComponent::queueRoomSetpoint(void *context, float temperature)
+    {
+      static_cast<OpenthermComponent *>(context)->queueCommand(CommandType::ROOM_SETPOINT, temperature);
+      return true;
+    }
+
+    void OpenthermComponent::queueCommand(CommandType type, float value)
+    {
+      if (listen_only_)
+      {
+        ESP_LOGW(TAG, "Listen-only mode, ignoring command %d", static_cast<int>(type));
+        return;
+      }
+      uint16_t command = traceBegin(type, value);
+      uint16_t &pending = pending_trace_[static_cast<uint8_t>(type)];
+      if (commands_.push(type, value))
+      {
+        ESP_LOGD(TAG, "Merged pending command %d, latest value %.1f", static_cast<int>(type), value);
+        trace(pending, SpanEvent::MERGED, value);
+      }
+      pending = command;
+    }
+
+    bool OpenthermComponent::processNextCommand()
+    {
+      CommandType type;
+      float value;
+      if (!commands_.pop(type, value))
+        return false;
+
+      ProfileScope scope(profiler_, ProfileSlot::COMMAND);
+      uint16_t &pending = pending_trace_[static_cast<uint8_t>(type)];
+      active_trace_ = pending;
+      pending = 0;
+      trace(active_trace_, SpanEvent::STARTED, value);
+
+      switch (type)
+      {
+        case CommandType::BOILER_RESET:
+          sendBoilerReset();
+          break;
+        case CommandType::DHW_SETPOINT:
+          setHotWaterTemperature(value);
+          break;
+        case CommandType::ROOM_SETPOINT:
+          setHeatingTargetTemperature(value);
+          break;
+        default:
+          break;
+      }
+      active_trace_ = 0;
+      return true;
+    }
+
+    void OpenthermComponent::processCommands()
+    {
+      while (processNextCommand())
+      {
+      }
+    }
+
+    void OpenthermComponent::reportProfile()
+    {
+      for (uint8_t i = 0; i < static_cast<uint8_t>(ProfileSlot::COUNT); i++)
+      {
+        if (profile_sensors_[i] != nullptr)
+          profile_sensors_[i]->publish_state(profiler_.get(static_cast<ProfileSlot>(i)).max_us);
+      }
+
+      uint32_t now = millis();
+      {
+        // The window reset would race the bus task recording its hot paths
+        BusLock lock(this);
+        profiler_.log_summary(now - profile_window_start_);
+      }
+      profile_window_start_ = now;
+    }
+
+    void OpenthermComponent::captureSnapshot(void *context, GatewaySnapshot &snapshot)
+    {
+      OpenthermComponent *self = static_cast<OpenthermComponent *>(context);
+      uint32_t now = millis();
+
+      snapshot.uptime_ms = now;
+      snapshot.status = last_status_response_ & 0xFFFF;
+      snapshot.fault = self->ot_->isFault(last_status_response_);
+      snapshot.ch_active = self->ot_->isCentralHeatingActive(last_status_response_);
+      snapshot.dhw_active = self->ot_->isHotWaterActive(last_status_response_);
+      snapshot.flame = self->ot_->isFlameOn(last_status_response_);
+      snapshot.diagnostic = self->ot_->isDiagnostic(last_status_response_);
+
+      snapshot.value_count = 0;
+      for (const auto &entry : CACHED_IDS)
+      {
+        if (snapshot.value_count == GatewaySnapshot::MAX_VALUES)
+          break;
+        const CachedValue *cache = self->cachedValueFor(entry.id);
+        GatewaySnapshot::Value &value = snapshot.values[snapshot.value_count++];
+        value.name = entry.name;
+        value.value = cache->value;
+        value.age_ms = cache->received_at != 0 ? now - cache->received_at : 0;
+        value.source = valueSourceName(cache->source);
+        value.stale = cache->stale;
+        value.out_of_target_s = cache->stale_ms / 1000;
+      }
+
+      auto capture_override = [self](GatewaySnapshot::Override &state, bool active, float setpoint,
+                                     const TimerWheel::Timer &timer)
+      {
+        state.active = active;
+        state.setpoint = active ? setpoint : NAN;
+        state.expires_in_ms = active ? self->timers_.remaining_ms(timer) : 0;
+      };
+      capture_override(snapshot.dhw_override, self->user_dhw_override_active_, self->user_dhw_setpoint_,
+                       self->dhw_override_timer_);
+      capture_override(snapshot.heating_override, self->user_heating_override_active_, self->user_heating_setpoint_,
+                       self->heating_override_timer_);
+
+      snapshot.max_ch_setpoint = self->max_ch_setpoint_sensor_ != nullptr ? self->max_ch_setpoint_sensor_->state : NAN;
+      snapshot.max_modulation = self->max_modulation_sensor_ != nullptr ? self->max_modulation_sensor_->state : NAN;
+
+      snapshot.deadline_misses = self->deadline_misses_total_;
+      snapshot.max_response_time_ms = self->max_response_time_;
+      snapshot.dropped_frames = self->intercepted_frames_.get_dropped();
+      snapshot.commands_queued = self->commands_.get_queued();
+      snapshot.commands_merged = self->commands_.get_merged();
+      snapshot.listen_only = self->listen_only_;
+      snapshot.observed_ids = self->observed_count_;
+      snapshot.bus_utilization = self->bus_meter_.get_utilization(millis()) * 100.0f;
+      snapshot.deferred_polls = self->deferred_polls_;
+    }
+
+    void OpenthermComponent::observeFrame(unsigned long response, OpenThermMessageID id, uint32_t now)
+    {
+      uint8_t raw_id = static_cast<uint8_t>(id);
+      if (raw_id < MAX_TRACKED_ID)
+      {
+        if (observed_at_[raw_id] == 0)
+          observed_count_++;
+        observed_at_[raw_id] = now != 0 ? now : 1;
       }
 
-      if (slave_ot_version_sensor_ != nullptr)
+      if (!listen_only_)
+        return;
+
+      // Values the gateway would otherwise read itself
+      switch (id)
       {
-        unsigned long response = ot_->sendRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::OpenThermVersionSlave, 0));
-        if (ot_->isValidResponse(response))
+        case OpenThermMessageID::MaxTSet:
+          if (max_ch_setpoint_sensor_ != nullptr)
+            max_ch_setpoint_sensor_->publish_state(ot_->getFloat(response));
+          break;
+        case OpenThermMessageID::MaxRelModLevelSetting:
+          if (max_modulation_sensor_ != nullptr)
+            max_modulation_sensor_->publish_state(ot_->getFloat(response));
+          break;
+        case OpenThermMessageID::OpenThermVersionMaster:
+          if (master_ot_version_sensor_ != nullptr)
+            master_ot_version_sensor_->publish_state(ot_->getFloat(response));
+          break;
+        case OpenThermMessageID::OpenThermVersionSlave:
+          if (slave_ot_version_sensor_ != nullptr)
+            slave_ot_version_sensor_->publish_state(ot_->getFloat(response));
+          break;
+        case OpenThermMessageID::ASFflags:
+          if (oem_fault_code_sensor_ != nullptr)
+            oem_fault_code_sensor_->publish_state(response & 0xFF);
+          break;
+        case OpenThermMessageID::OEMDiagnosticCode:
+          if (oem_diagnostic_code_sensor_ != nullptr)
+            oem_diagnostic_code_sensor_->publish_state(response & 0xFFFF);
+          break;
+        default:
+          break;
+      }
+    }
+
+    bool OpenthermComponent::admitPoll(OpenThermMessageID msg_id)
+    {
+      // A failed boiler side only gets one probing poll per reset instead of a poll per value
+      if (!bus_health_.is_healthy(BusHealth::Side::BOILER))
+      {
+        if (!boiler_probe_pending_)
         {
-          float value = ot_->getFloat(response);
-          slave_ot_version_sensor_->publish_state(value);
-          ESP_LOGI(TAG, "Slave OT version: %.2f", value);
+          ESP_LOGV(TAG, "Skipping poll of msg_id %d, boiler side failed", static_cast<int>(msg_id));
+          return false;
         }
+        boiler_probe_pending_ = false;
       }
+      if (bus_meter_.admit(bus_ceiling_, millis()))
+        return true;
+      deferred_polls_++;
+      ESP_LOGV(TAG, "Deferring poll of msg_id %d, boiler bus at %.0f%%", static_cast<int>(msg_id),
+               bus_meter_.get_utilization(millis()) * 100.0f);
+      return false;
     }
 
-    void OpenthermComponent::loop()
+    void OpenthermComponent::runPrefetch()
+    {
+      if (!prefetch_enabled_ || listen_only_ || pass_through_state_ != PassThroughState::IDLE)
+        return;
+
+      uint32_t predicted;
+      if (!predictor_.predict(predicted) || prefetch_.sequence == predictor_.get_sequence())
+        return;
+
+      // Leave the exchange in flight and the inter-frame gap behind, and only start
+      // if the boiler should answer well before the thermostat's next request
+      uint32_t now = millis();
+      uint32_t since = now - predictor_.get_last_request_time();
+      uint32_t cost = bus_meter_.get_poll_cost();
+      if (since < cost || since + cost + PREFETCH_MARGIN_ > predictor_.get_interval())
+        return;
+
+      // Like any other gateway poll, a prefetch waits for room on the boiler bus;
+      // a deferred one is not retried for the same prediction
+      prefetch_.sequence = predictor_.get_sequence();
+      if (!admitPoll(static_cast<OpenThermMessageID>((predicted >> 16) & 0xFF)))
+      {
+        prefetch_deferred_++;
+        return;
+      }
+      prefetch_issued_++;
+      unsigned long start = millis();
+      unsigned long response = sendBoilerRequest(predicted);
+      if (!ot_->isValidResponse(response))
+      {
+        prefetch_.valid = false;
+        return;
+      }
+      prefetch_.request = predicted;
+      prefetch_.response = response;
+      prefetch_.fetched_at = millis();
+      prefetch_.exchange_ms = prefetch_.fetched_at - start;
+      prefetch_.valid = true;
+    }
+
+    bool OpenthermComponent::takePrefetched(unsigned long request, unsigned long modified_request, unsigned long &response)
     {
-      slave_ot_->process();
+      if (!prefetch_enabled_)
+        return false;
+
+      uint32_t now = millis();
+      predictor_.observe(request, now);
+      if (!prefetch_.valid)
+        return false;
 
-      // Process intercepted responses (moved from interrupt context)
-      if (has_new_intercepted_response_)
+      // Each prefetch is used at most once; a different frame (or any WRITE) goes through normally
+      prefetch_.valid = false;
+      if (request != prefetch_.request || modified_request != request || now - prefetch_.fetched_at > PREFETCH_MAX_AGE_)
       {
-        processCachedResponse(last_intercepted_response_, last_intercepted_id_);
-        has_new_intercepted_response_ = false;
+        prefetch_misses_++;
+        return false;
+      }
+
+      prefetch_hits_++;
+      prefetch_saved_ms_ += prefetch_.exchange_ms;
+      response = prefetch_.response;
+      // No boiler exchange was timed, keep the response time watermark out of it
+      last_response_time_ = 0;
+      return true;
+    }
+
+    void OpenthermComponent::reportPrefetch()
+    {
+      uint32_t decided = prefetch_hits_ + prefetch_misses_;
+      float hit_rate = decided != 0 ? 100.0f * prefetch_hits_ / decided : NAN;
+      float saved = prefetch_hits_ != 0 ? static_cast<float>(prefetch_saved_ms_) / prefetch_hits_ : NAN;
+
+      if (prefetch_issued_ != last_reported_prefetch_issued_ || prefetch_deferred_ != last_reported_prefetch_deferred_)
+      {
+        last_reported_prefetch_issued_ = prefetch_issued_;
+        last_reported_prefetch_deferred_ = prefetch_deferred_;
+        ESP_LOGD(TAG,
+                 "Prefetch: %" PRIu32 " issued, %" PRIu32 " deferred, %" PRIu32 " hits, %" PRIu32
+                 " misses, %.0f ms saved per hit",
+                 prefetch_issued_, prefetch_deferred_, prefetch_hits_, prefetch_misses_, saved);
+      }
+
+      if (prefetch_hit_rate_sensor_ != nullptr)
+        prefetch_hit_rate_sensor_->publish_state(hit_rate);
+      if (prefetch_latency_saved_sensor_ != nullptr)
+        prefetch_latency_saved_sensor_->publish_state(saved);
+    }
+
+    void OpenthermComponent::reportBusUtilization()
+    {
+      uint32_t now = millis();
+      float utilization = bus_meter_.get_utilization(now) * 100.0f;
+      float headroom = bus_ceiling_ * 100.0f - utilization;
+
+      if (deferred_polls_ != last_reported_deferred_polls_)
+      {
+        last_reported_deferred_polls_ = deferred_polls_;
+        ESP_LOGD(TAG, "Bus utilization %.0f%% (ceiling %.0f%%), %" PRIu32 " polls deferred", utilization,
+                 bus_ceiling_ * 100.0f, deferred_polls_);
+      }
+
+      if (bus_utilization_sensor_ != nullptr)
+        bus_utilization_sensor_->publish_state(utilization);
+      if (pass_through_utilization_sensor_ != nullptr)
+        pass_through_utilization_sensor_->publish_state(
+            bus_meter_.get_utilization(BusMeter::Source::PASS_THROUGH, now) * 100.0f);
+      if (gateway_utilization_sensor_ != nullptr)
+        gateway_utilization_sensor_->publish_state(bus_meter_.get_utilization(BusMeter::Source::GATEWAY, now) * 100.0f);
+      if (thermostat_utilization_sensor_ != nullptr)
+        thermostat_utilization_sensor_->publish_state(bus_meter_.get_thermostat_utilization(now) * 100.0f);
+      if (bus_headroom_sensor_ != nullptr)
+        bus_headroom_sensor_->publish_state(headroom);
+      if (deferred_polls_sensor_ != nullptr)
+        deferred_polls_sensor_->publish_state(deferred_polls_);
+    }
+
+    void OpenthermComponent::reportAllocations()
+    {
+      uint32_t total = AllocationScope::get_total();
+      if (total == last_reported_allocations_)
+        return;
+      last_reported_allocations_ = total;
+      ESP_LOGW(TAG, "Heap allocations after setup: %" PRIu32 " (loop %" PRIu32 ", update %" PRIu32
+                    ", pass-through %" PRIu32 ", climate control %" PRIu32 ")",
+               total, AllocationScope::get_count(AllocationSlot::LOOP), AllocationScope::get_count(AllocationSlot::UPDATE),
+               AllocationScope::get_count(AllocationSlot::PASS_THROUGH), AllocationScope::get_count(AllocationSlot::CONTROL));
+    }
+
+    void OpenthermComponent::reportCoverage()
+    {
+      if (observed_ids_sensor_ != nullptr)
+        observed_ids_sensor_->publish_state(observed_count_);
+
+      // Full table when a new ID shows up, otherwise every 10 minutes
+      uint32_t now = millis();
+      if (observed_count_ == last_reported_observed_ && now - last_coverage_report_ < 600000)
+        return;
+      last_reported_observed_ = observed_count_;
+      last_coverage_report_ = now;
+
+      ESP_LOGD(TAG, "Observed %u data IDs on the bus:", observed_count_);
+      for (uint8_t i = 0; i < MAX_TRACKED_ID; i++)
+      {
+        if (observed_at_[i] != 0)
+          ESP_LOGD(TAG, "  msg_id %u: last seen %" PRIu32 " s ago", i, (now - observed_at_[i]) / 1000);
+      }
+
+      if (!listen_only_)
+        return;
+
+      // Entities the thermostat never asked for stay empty in listen-only mode
+      const struct
+      {
+        bool configured;
+        OpenThermMessageID id;
+        const char *name;
+      } entities[] = {
+          {flame_ != nullptr || ch_active_ != nullptr || dhw_active_ != nullptr || fault_ != nullptr ||
+               diagnostic_ != nullptr,
+           OpenThermMessageID::Status, "status"},
+          {heating_target_temperature_sensor_ != nullptr, OpenThermMessageID::TSet, "heating target"},
+          {oem_fault_code_sensor_ != nullptr, OpenThermMessageID::ASFflags, "OEM fault code"},
+          {max_modulation_sensor_ != nullptr, OpenThermMessageID::MaxRelModLevelSetting, "max modulation"},
+          {room_setpoint_sensor_ != nullptr, OpenThermMessageID::TrSet, "room setpoint"},
+          {modulation_sensor_ != nullptr, OpenThermMessageID::RelModLevel, "modulation"},
+          {pressure_sensor_ != nullptr, OpenThermMessageID::CHPressure, "pressure"},
+          {room_temperature_sensor_ != nullptr, OpenThermMessageID::Tr, "room temperature"},
+          {boiler_temperature_ != nullptr, OpenThermMessageID::Tboiler, "boiler temperature"},
+          {hot_water_climate_ != nullptr, OpenThermMessageID::Tdhw, "DHW temperature"},
+          {external_temperature_sensor_ != nullptr, OpenThermMessageID::Toutside, "outside temperature"},
+          {return_temperature_sensor_ != nullptr, OpenThermMessageID::Tret, "return temperature"},
+          {hot_water_climate_ != nullptr, OpenThermMessageID::TdhwSet, "DHW setpoint"},
+          {max_ch_setpoint_sensor_ != nullptr, OpenThermMessageID::MaxTSet, "max CH setpoint"},
+          {oem_diagnostic_code_sensor_ != nullptr, OpenThermMessageID::OEMDiagnosticCode, "OEM diagnostic code"},
+          {master_ot_version_sensor_ != nullptr, OpenThermMessageID::OpenThermVersionMaster, "master version"},
+          {slave_ot_version_sensor_ != nullptr, OpenThermMessageID::OpenThermVersionSlave, "slave version"},
+      };
+      for (const auto &entity : entities)
+      {
+        if (entity.configured && observed_at_[static_cast<uint8_t>(entity.id)] == 0)
+          ESP_LOGD(TAG, "  msg_id %d (%s): not observed", static_cast<int>(entity.id), entity.name);
+      }
+    }
+
+    void OpenthermComponent::processThermostatBus()
+    {
+      AllocationScope allocation_scope(AllocationSlot::PASS_THROUGH);
+
+      if (timer_transmit_)
+      {
+        // Advance the pass-through as far as possible without waiting on the bus
+        while (runPassThrough())
+        {
+        }
+      }
+      else if (deferred_decoding_)
+      {
+        // Decode all thermostat frames captured since the last call
+        uint32_t request;
+        while (thermostat_decoder_.poll(thermostat_edges_, request))
+        {
+          if (slave_ot_->isValidRequest(request))
+          {
+            processRequest(request, OpenThermResponseStatus::SUCCESS);
+          }
+          else
+          {
+            bus_health_.record(BusHealth::Side::THERMOSTAT, false, millis());
+            ESP_LOGW(TAG, "Ignoring invalid thermostat frame 0x%08" PRIX32, request);
+          }
+        }
+      }
+      else
+      {
+        slave_ot_->process();
       }
     }
 
     void OpenthermComponent::update()
     {
+      AllocationScope allocation_scope(AllocationSlot::UPDATE);
+      ProfileScope update_scope(profiler_, ProfileSlot::UPDATE);
+
+      // User commands go out before any gateway read
+      processCommands();
+
+      if (commands_.get_merged() != last_reported_merged_writes_)
+      {
+        last_reported_merged_writes_ = commands_.get_merged();
+        ESP_LOGD(TAG, "Commands: %" PRIu32 " queued, %" PRIu32 " merged into a later write",
+                 commands_.get_queued(), last_reported_merged_writes_);
+      }
+      if (merged_writes_sensor_ != nullptr)
+        merged_writes_sensor_->publish_state(commands_.get_merged());
+
+      if (intercepted_frames_.get_dropped() != last_dropped_frames_)
+      {
+        last_dropped_frames_ = intercepted_frames_.get_dropped();
+        ESP_LOGW(TAG, "Intercepted frame queue full, %" PRIu32 " frames dropped so far", last_dropped_frames_);
+      }
+
+      if (deferred_decoding_)
+        logDecoderStats();
+
+      if (telemetry_.is_configured())
+      {
+        ESP_LOGV(TAG, "Telemetry: %" PRIu32 " datagrams, %" PRIu32 " records, %" PRIu32 " send errors",
+                 telemetry_.get_datagrams_sent(), telemetry_.get_records_sent(), telemetry_.get_send_errors());
+      }
+
+      if (history_.is_configured())
+      {
+        uint32_t samples;
+        size_t bytes;
+        history_.get_usage(samples, bytes);
+        ESP_LOGV(TAG, "History: %" PRIu32 " samples in %u bytes (%.2f bytes/sample), %" PRIu32 " repeats skipped",
+                 samples, static_cast<unsigned>(bytes), samples != 0 ? static_cast<float>(bytes) / samples : 0.0f,
+                 history_.get_skipped());
+      }
+
+      reportAllocations();
+
+      if (frame_server_.get_dropped() != last_reported_frame_drops_)
+      {
+        last_reported_frame_drops_ = frame_server_.get_dropped();
+        ESP_LOGW(TAG, "Frame server: %" PRIu32 " lines dropped for slow clients", last_reported_frame_drops_);
+      }
+
+      if (deadline_misses_total_ != last_reported_deadline_misses_)
+      {
+        last_reported_deadline_misses_ = deadline_misses_total_;
+        ESP_LOGD(TAG, "Pass-through: %" PRIu32 " deadline misses, worst boiler response %lu ms (msg_id %d)",
+                 deadline_misses_total_, max_response_time_, max_response_time_id_);
+        for (uint8_t i = 0; i < MAX_TRACKED_ID; i++)
+        {
+          if (deadline_misses_[i] != 0)
+            ESP_LOGD(TAG, "  msg_id %d: %u misses", i, deadline_misses_[i]);
+        }
+      }
+      if (deadline_misses_sensor_ != nullptr)
+        deadline_misses_sensor_->publish_state(deadline_misses_total_);
+      if (max_response_time_sensor_ != nullptr)
+        max_response_time_sensor_->publish_state(max_response_time_);
+
+      if (profiler_.is_enabled())
+        reportProfile();
+
+      reportCoverage();
+      reportFrameChanges();
+      if (bus_health_.is_configured())
+        reportBusHealth();
+      reportBusUtilization();
+      if (prefetch_enabled_)
+        reportPrefetch();
+      if (table_sync_.is_configured())
+        reportTableSync();
+
+      {
+        BusLock lock(this);
+        if (user_heating_override_active_)
+        {
+          ESP_LOGD(TAG, "Heating controller: max overshoot %.2f°C, %" PRIu32 " burner starts since override",
+                   heating_controller_->get_max_overshoot(), override_burner_starts_);
+        }
+      }
+
       // Read and publish sensor values
 
       // Binary sensors from status
@@ -122,65 +773,37 @@ namespace esphome
       bool is_fault = ot_->isFault(last_status_response_);
       bool is_diagnostic = ot_->isDiagnostic(last_status_response_);
 
-      if (flame_ != nullptr)
+      bool status_changed = changedSincePublish(OpenThermMessageID::Status);
+
+      if (flame_ != nullptr && status_changed)
         flame_->publish_state(is_flame_on);
 
-      if (ch_active_ != nullptr)
+      if (ch_active_ != nullptr && status_changed)
         ch_active_->publish_state(is_central_heating_active);
 
-      if (dhw_active_ != nullptr)
+      if (dhw_active_ != nullptr && status_changed)
         dhw_active_->publish_state(is_hot_water_active);
 
-      if (fault_ != nullptr)
+      if (fault_ != nullptr && status_changed)
         fault_->publish_state(is_fault);
 
-      if (diagnostic_ != nullptr)
+      if (diagnostic_ != nullptr && status_changed)
         diagnostic_->publish_state(is_diagnostic);
 
-      // Temperature and other sensors (using cache with timeout)
-      float ext_temperature = getExternalTemperature();
-      float return_temperature = getReturnTemperature();
-      float boiler_temperature = getCachedOrFetch(cached_boiler_temp_, OpenThermMessageID::Tboiler);
-      float pressure = getPressure();
-      float modulation = getModulation();
-      float heating_target_temp = getHeatingTargetTemperature();
-      float hot_water_temp = getHotWaterTemperature();
-      float room_temperature = getRoomTemperature();
-      float room_setpoint = getRoomSetpoint();
-
-      if (external_temperature_sensor_ != nullptr && !std::isnan(ext_temperature))
-        external_temperature_sensor_->publish_state(ext_temperature);
-
-      if (return_temperature_sensor_ != nullptr && !std::isnan(return_temperature))
-        return_temperature_sensor_->publish_state(return_temperature);
-
-      if (boiler_temperature_ != nullptr && !std::isnan(boiler_temperature))
-        boiler_temperature_->publish_state(boiler_temperature);
-
-      if (pressure_sensor_ != nullptr && !std::isnan(pressure))
-        pressure_sensor_->publish_state(pressure);
-
-      if (modulation_sensor_ != nullptr && !std::isnan(modulation))
-        modulation_sensor_->publish_state(modulation);
-
-      if (heating_target_temperature_sensor_ != nullptr && !std::isnan(heating_target_temp) && heating_target_temp > 0)
-        heating_target_temperature_sensor_->publish_state(heating_target_temp);
-
-      // Room temperature (ID 24) — sent by master (e.g. QAA73) as WRITE-DATA, intercepted from bus
-      if (room_temperature_sensor_ != nullptr && !std::isnan(room_temperature))
-        room_temperature_sensor_->publish_state(room_temperature);
-
-      // Room setpoint (ID 16) — sent by master (e.g. QAA73) as WRITE-DATA, intercepted from bus
-      if (room_setpoint_sensor_ != nullptr && !std::isnan(room_setpoint))
-        room_setpoint_sensor_->publish_state(room_setpoint);
-
-      // Read OEM diagnostic codes (Data-ID 5 and 115) - only if fault or diagnostic active
-      if (is_fault || is_diagnostic)
+      // Read OEM diagnostic codes (Data-ID 5 and 115) - only if fault or diagnostic active.
+      // Diagnostics rank above the background polls below, so they go out first
+      if (listen_only_)
       {
+        // Published from intercepted frames in observeFrame()
+      }
+      else if (is_fault || is_diagnostic)
+      {
+        ProfileScope scope(profiler_, ProfileSlot::OEM_READS);
+
         // OEM fault code (Data-ID 5) - Application-specific fault flags
         if (oem_fault_code_sensor_ != nullptr)
         {
-          unsigned long response = ot_->sendRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::ASFflags, 0));
+          unsigned long response = sendBoilerRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::ASFflags, 0));
           if (ot_->isValidResponse(response))
           {
             uint16_t fault_code = response & 0xFF; // Low byte contains OEM fault code
@@ -195,7 +818,7 @@ namespace esphome
         // OEM diagnostic code (Data-ID 115)
         if (oem_diagnostic_code_sensor_ != nullptr)
         {
-          unsigned long response = ot_->sendRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::OEMDiagnosticCode, 0));
+          unsigned long response = sendBoilerRequest(ot_->buildRequest(OpenThermRequestType::READ, OpenThermMessageID::OEMDiagnosticCode, 0));
           if (ot_->isValidResponse(response))
           {
             uint16_t diag_code = response & 0xFFFF; // Full 16-bit diagnostic code
@@ -216,27 +839,52 @@ namespace esphome
           oem_diagnostic_code_sensor_->publish_state(0);
       }
 
+      // Temperature and other sensors (using cache with timeout), refreshed into their caches
+      getExternalTemperature();
+      getReturnTemperature();
+      float boiler_temperature = getCachedOrFetch(cached_boiler_temp_, OpenThermMessageID::Tboiler);
+      getPressure();
+      getModulation();
+      float heating_target_temp = getHeatingTargetTemperature();
+      float hot_water_temp = getHotWaterTemperature();
+      float room_temperature = getRoomTemperature();
+      float room_setpoint = getRoomSetpoint();
+
+      // Sensors are republished only when their data ID carried a new value
+      // or their freshness target was crossed
+      checkFreshness();
+      publishCachedValue(external_temperature_sensor_, cached_external_temp_, OpenThermMessageID::Toutside);
+      publishCachedValue(return_temperature_sensor_, cached_return_temp_, OpenThermMessageID::Tret);
+      publishCachedValue(boiler_temperature_, cached_boiler_temp_, OpenThermMessageID::Tboiler);
+      publishCachedValue(pressure_sensor_, cached_pressure_, OpenThermMessageID::CHPressure);
+      publishCachedValue(modulation_sensor_, cached_modulation_, OpenThermMessageID::RelModLevel);
+      if (!(heating_target_temp <= 0))
+        publishCachedValue(heating_target_temperature_sensor_, cached_heating_target_, OpenThermMessageID::TSet);
+      // Room temperature (ID 24) and setpoint (ID 16) — sent by master (e.g. QAA73) as WRITE-DATA, intercepted from bus
+      publishCachedValue(room_temperature_sensor_, cached_room_temp_, OpenThermMessageID::Tr);
+      publishCachedValue(room_setpoint_sensor_, cached_room_setpoint_, OpenThermMessageID::TrSet);
+
       // Update climate controllers
-      if (hot_water_climate_ != nullptr)
+      ProfileScope climate_scope(profiler_, ProfileSlot::CLIMATE_PUBLISH);
+      bool dhw_syncing = dhw_sync_timer_.is_armed();
+      bool dhw_changed = status_changed || changedSincePublish(OpenThermMessageID::Tdhw) ||
+                         changedSincePublish(OpenThermMessageID::TdhwSet);
+      if (hot_water_climate_ != nullptr && (dhw_changed || dhw_syncing))
       {
         hot_water_climate_->current_temperature = hot_water_temp;
         hot_water_climate_->action = is_hot_water_active ? climate::CLIMATE_ACTION_HEATING : climate::CLIMATE_ACTION_OFF;
         
-        // Force update DHW target temperature from QAA73 during first 20 update cycles
+        // Force update DHW target temperature from QAA73 during the first 20 update intervals
         // to override any value that HA may have sent during initialization
-        static uint8_t dhw_update_counter = 0;
-        const uint8_t FORCE_UPDATE_CYCLES = 20;
-        
-        if (dhw_update_counter < FORCE_UPDATE_CYCLES)
+        if (dhw_syncing)
         {
           float dhw_target = getHotWaterTargetTemperature();
           if (!std::isnan(dhw_target) && dhw_target > 0 && dhw_target < 80)
           {
-            ESP_LOGI(TAG, "Force updating DHW target to %.1f°C from QAA73 (cycle %d/%d)", 
-                     dhw_target, dhw_update_counter + 1, FORCE_UPDATE_CYCLES);
+            ESP_LOGI(TAG, "Force updating DHW target to %.1f°C from QAA73 (%" PRIu32 " s left)",
+                     dhw_target, timers_.remaining_ms(dhw_sync_timer_) / 1000);
             hot_water_climate_->target_temperature = dhw_target;
           }
-          dhw_update_counter++;
         }
         // After force update period, only update if user hasn't overridden it
         else if (!user_dhw_override_active_)
@@ -252,7 +900,10 @@ namespace esphome
         hot_water_climate_->publish_state();
       }
 
-      if (heating_water_climate_ != nullptr)
+      bool heating_changed = status_changed || changedSincePublish(OpenThermMessageID::Tr) ||
+                             changedSincePublish(OpenThermMessageID::TrSet) ||
+                             changedSincePublish(OpenThermMessageID::Tboiler);
+      if (heating_water_climate_ != nullptr && heating_changed)
       {
         // Show room temperature (from master, e.g. QAA73) instead of boiler water temp.
         // Falls back to boiler_temperature if QAA73 hasn't sent Tr yet.
@@ -273,6 +924,176 @@ namespace esphome
         
         heating_water_climate_->publish_state();
       }
+
+      published_epoch_ = frame_tracker_.get_epoch();
+    }
+
+    bool OpenthermComponent::changedSincePublish(OpenThermMessageID id) const
+    {
+      // Everything is published on the first update, seen or not
+      return published_epoch_ == 0 || frame_tracker_.changed_since(static_cast<uint8_t>(id), published_epoch_);
+    }
+
+    const char *OpenthermComponent::valueSourceName(ValueSource source)
+    {
+      switch (source)
+      {
+        case ValueSource::SNIFFED:
+          return "sniffed";
+        case ValueSource::POLLED:
+          return "polled";
+        default:
+          return "none";
+      }
+    }
+
+    void OpenthermComponent::checkFreshness()
+    {
+      uint32_t now = millis();
+      uint32_t elapsed = last_freshness_check_ != 0 ? now - last_freshness_check_ : 0;
+      last_freshness_check_ = now;
+
+      uint32_t total_stale_ms = 0;
+      for (const auto &entry : CACHED_IDS)
+      {
+        CachedValue &cache = *cachedValueFor(entry.id);
+        if (cache.max_age == 0)
+          continue;
+
+        // A value that never arrived counts from boot
+        uint32_t age = cache.received_at != 0 ? now - cache.received_at : now;
+        bool stale = !cache.freshness_timer.is_armed();
+        cache.stale_changed = stale != cache.stale;
+        if (stale && cache.stale)
+          cache.stale_ms += elapsed;
+        cache.stale = stale;
+        total_stale_ms += cache.stale_ms;
+
+        if (cache.stale_changed && stale)
+          ESP_LOGW(TAG, "%s out of target: %" PRIu32 " s old (%s), target %" PRIu32 " s", entry.name, age / 1000,
+                   valueSourceName(cache.source), cache.max_age / 1000);
+        else if (cache.stale_changed)
+          ESP_LOGI(TAG, "%s back in target (%s)", entry.name, valueSourceName(cache.source));
+      }
+
+      if (total_stale_ms / 1000 != last_reported_stale_s_)
+      {
+        last_reported_stale_s_ = total_stale_ms / 1000;
+        for (const auto &entry : CACHED_IDS)
+        {
+          const CachedValue &cache = *cachedValueFor(entry.id);
+          if (cache.stale_ms != 0)
+            ESP_LOGD(TAG, "  %s: %" PRIu32 " s out of target", entry.name, cache.stale_ms / 1000);
+        }
+      }
+      if (out_of_target_sensor_ != nullptr)
+        out_of_target_sensor_->publish_state(total_stale_ms / 1000);
+    }
+
+    void OpenthermComponent::publishCachedValue(sensor::Sensor *sensor, const CachedValue &cache, OpenThermMessageID id)
+    {
+      if (sensor == nullptr)
+        return;
+      if (cache.stale)
+      {
+        // Shown as unavailable until a fresh value arrives
+        if (cache.stale_changed)
+          sensor->publish_state(NAN);
+        return;
+      }
+      if (!std::isnan(cache.value) && (cache.stale_changed || changedSincePublish(id)))
+        sensor->publish_state(cache.value);
+    }
+
+    void OpenthermComponent::reportBusHealth()
+    {
+      static const BusHealth::Side SIDES[] = {BusHealth::Side::BOILER, BusHealth::Side::THERMOSTAT};
+      uint32_t failures = 0;
+      uint32_t recoveries = 0;
+      uint32_t total_recovery_ms = 0;
+      uint32_t max_recovery_ms = 0;
+      for (BusHealth::Side side : SIDES)
+      {
+        failures += bus_health_.get_failures(side);
+        recoveries += bus_health_.get_recoveries(side);
+        total_recovery_ms += bus_health_.get_total_recovery_ms(side);
+        if (bus_health_.get_max_recovery_ms(side) > max_recovery_ms)
+          max_recovery_ms = bus_health_.get_max_recovery_ms(side);
+      }
+
+      if (failures != last_reported_bus_failures_ || recoveries != last_reported_recoveries_)
+      {
+        last_reported_bus_failures_ = failures;
+        last_reported_recoveries_ = recoveries;
+        for (BusHealth::Side side : SIDES)
+        {
+          ESP_LOGD(TAG, "%s side: %s, %" PRIu32 " failures, %" PRIu32 " resets, %" PRIu32
+                        " recoveries, time to recover mean %" PRIu32 " ms / max %" PRIu32 " ms",
+                   side == BusHealth::Side::BOILER ? "Boiler" : "Thermostat",
+                   bus_health_.is_healthy(side) ? "healthy" : "FAILED", bus_health_.get_failures(side),
+                   bus_health_.get_resets(side), bus_health_.get_recoveries(side),
+                   bus_health_.get_mean_recovery_ms(side), bus_health_.get_max_recovery_ms(side));
+        }
+      }
+
+      if (bus_recoveries_sensor_ != nullptr)
+        bus_recoveries_sensor_->publish_state(recoveries);
+      if (mean_recovery_time_sensor_ != nullptr && recoveries != 0)
+        mean_recovery_time_sensor_->publish_state(total_recovery_ms / recoveries / 1000.0f);
+      if (max_recovery_time_sensor_ != nullptr && recoveries != 0)
+        max_recovery_time_sensor_->publish_state(max_recovery_ms / 1000.0f);
+    }
+
+    void OpenthermComponent::reportFrameChanges()
+    {
+      if (frame_tracker_.get_changes() != last_reported_frame_changes_)
+      {
+        last_reported_frame_changes_ = frame_tracker_.get_changes();
+        ESP_LOGD(TAG, "Frames: %" PRIu32 " changed, %" PRIu32 " duplicates skipped", last_reported_frame_changes_,
+                 frame_tracker_.get_duplicates());
+      }
+      if (duplicate_frames_sensor_ != nullptr)
+        duplicate_frames_sensor_->publish_state(frame_tracker_.get_duplicates());
+      if (changed_frames_sensor_ != nullptr)
+        changed_frames_sensor_->publish_state(frame_tracker_.get_changes());
+    }
+
+    void OpenthermComponent::dump_config()
+    {
+      ESP_LOGCONFIG(TAG, "OpenTherm Gateway:");
+      ESP_LOGCONFIG(TAG, "  Boiler pins: in=%d, out=%d", in_pin_, out_pin_);
+      ESP_LOGCONFIG(TAG, "  Thermostat pins: in=%d, out=%d", slave_in_pin_, slave_out_pin_);
+      ESP_LOGCONFIG(TAG, "  Deferred decoding: %s", YESNO(deferred_decoding_));
+      ESP_LOGCONFIG(TAG, "  Timer transmit: %s", YESNO(timer_transmit_));
+      ESP_LOGCONFIG(TAG, "  Bus task: %s", YESNO(bus_task_));
+      ESP_LOGCONFIG(TAG, "  Listen-only: %s", YESNO(listen_only_));
+      if (bus_ceiling_ < 1.0f)
+        ESP_LOGCONFIG(TAG, "  Bus utilization ceiling: %.0f%%", bus_ceiling_ * 100.0f);
+      if (bus_health_.is_configured())
+        ESP_LOGCONFIG(TAG, "  Bus supervisor: YES");
+#ifdef OPENTHERM_ALLOCATION_GUARD
+      ESP_LOGCONFIG(TAG, "  Allocation guard: YES");
+#endif
+      if (frame_server_.is_configured())
+        ESP_LOGCONFIG(TAG, "  Frame server: %u clients, %" PRIu32 " lines", frame_server_.get_clients(),
+                      frame_server_.get_lines());
+      if (pass_through_deadline_ != 0)
+        ESP_LOGCONFIG(TAG, "  Pass-through deadline: %lu ms", pass_through_deadline_);
+      ESP_LOGCONFIG(TAG, "  Heating controller: %s, curve %.1f + %.2f * (target - outside), water %.0f..%.0f°C",
+                    heating_controller_type_ == HeatingControllerType::PI ? "PI" : "hysteresis",
+                    heating_curve_.base_temperature, heating_curve_.slope,
+                    heating_curve_.min_water_temperature, heating_curve_.max_water_temperature);
+      if (heating_controller_type_ == HeatingControllerType::PI)
+        ESP_LOGCONFIG(TAG, "    Kp: %.2f, Ki: %.2f/h", heating_kp_, heating_ki_);
+      ESP_LOGCONFIG(TAG, "  Profiler: %s", YESNO(profiler_.is_enabled()));
+      if (history_.is_configured())
+        ESP_LOGCONFIG(TAG, "  History: %u bytes", static_cast<unsigned>(history_.get_size()));
+      if (recorder_.is_configured())
+        ESP_LOGCONFIG(TAG, "  Flight recorder: %u incidents, %u frames each", recorder_.get_incidents(),
+                      FlightRecorder::FRAMES);
+      if (table_sync_.is_configured())
+        ESP_LOGCONFIG(TAG, "  Table sync: %u entries every %" PRIu32 " ms", table_sync_.get_batch(),
+                      table_sync_interval_);
     }
 
     void OpenthermComponent::register_climate(OpenthermClimate *climate)
@@ -343,13 +1164,15 @@ namespace esphome
 
       unsigned int data = ot_->temperatureToData(temperature);
       unsigned long request = ot_->buildRequest(OpenThermRequestType::WRITE, write_msg_id, data);
-      unsigned long response = ot_->sendRequest(request);
+      unsigned long response = sendBoilerRequest(request);
 
       if (!ot_->isValidResponse(response))
       {
         ESP_LOGE(TAG, "Failed to set %s temperature - invalid response", name);
+        trace(active_trace_, SpanEvent::FAILED, temperature);
         return false;
       }
+      trace(active_trace_, SpanEvent::WRITTEN, temperature);
 
       // Small delay to allow boiler to process the write command
       delay(100);
@@ -358,7 +1181,7 @@ namespace esphome
       const int max_retries = 3;
       for (int retry = 0; retry < max_retries; retry++)
       {
-        unsigned long read_response = ot_->sendRequest(
+        unsigned long read_response = sendBoilerRequest(
             ot_->buildRequest(OpenThermRequestType::READ, read_msg_id, 0));
 
         if (ot_->isValidResponse(read_response))
@@ -369,6 +1192,7 @@ namespace esphome
           {
             ESP_LOGI(TAG, "%s setpoint verified: %.1f°C (requested: %.1f°C)",
                      name, actual_setpoint, temperature);
+            trace(active_trace_, SpanEvent::VERIFIED, actual_setpoint);
 
             // Update climate entity immediately with verified value
             if (climate != nullptr)
@@ -382,6 +1206,7 @@ namespace esphome
             {
               ESP_LOGW(TAG, "%s setpoint was adjusted by boiler from %.1f°C to %.1f°C (min/max limits?)",
                        name, temperature, actual_setpoint);
+              trace(active_trace_, SpanEvent::CLAMPED, actual_setpoint);
             }
 
             return true;
@@ -399,6 +1224,7 @@ namespace esphome
       }
 
       ESP_LOGW(TAG, "%s setpoint write succeeded but verification failed after %d retries", name, max_retries);
+      trace(active_trace_, SpanEvent::FAILED);
       return true; // Write succeeded even if verification failed
     }
 
@@ -407,10 +1233,11 @@ namespace esphome
       ESP_LOGI(TAG, "User set DHW temperature to %.1f°C", temperature);
       
       // Ignore calls within first 30 seconds after boot - these are from HA restoring state
-      unsigned long uptime_ms = millis();
-      if (uptime_ms < 30000)
+      if (startup_guard_timer_.is_armed())
       {
-        ESP_LOGI(TAG, "Ignoring DHW temperature set during startup (uptime: %lu ms)", uptime_ms);
+        ESP_LOGI(TAG, "Ignoring DHW temperature set during startup (%" PRIu32 " ms left)",
+                 timers_.remaining_ms(startup_guard_timer_));
+        trace(active_trace_, SpanEvent::IGNORED, temperature);
         return true;
       }
       
@@ -422,15 +1249,30 @@ namespace esphome
       {
         ESP_LOGI(TAG, "DHW temperature (%.1f°C) matches QAA73 (%.1f°C), not activating override",
                  temperature, qaa73_dhw);
+        trace(active_trace_, SpanEvent::IGNORED, qaa73_dhw);
         // Deactivate override if it was active
-        user_dhw_override_active_ = false;
+        {
+          BusLock lock(this);
+          if (user_dhw_override_active_)
+            trace(dhw_override_trace_, SpanEvent::CANCELLED, temperature);
+          user_dhw_override_active_ = false;
+        }
+        timers_.cancel(dhw_override_timer_);
         return true;
       }
       
       // Activate user override - this will block QAA73 commands
-      user_dhw_override_active_ = true;
-      user_dhw_setpoint_ = temperature;
-      dhw_override_timestamp_ = millis();
+      {
+        BusLock lock(this);
+        if (user_dhw_override_active_)
+          trace(dhw_override_trace_, SpanEvent::CANCELLED, temperature);
+        dhw_override_trace_ = active_trace_;
+        dhw_rewrite_traced_ = false;
+        trace(active_trace_, SpanEvent::OVERRIDE, qaa73_dhw);
+        user_dhw_override_active_ = true;
+        user_dhw_setpoint_ = temperature;
+      }
+      timers_.schedule(dhw_override_timer_, OVERRIDE_TIMEOUT_);
       
       ESP_LOGI(TAG, "DHW override activated: %.1f°C (QAA73 wants %.1f°C)", temperature, qaa73_dhw);
       
@@ -447,10 +1289,11 @@ namespace esphome
       ESP_LOGI(TAG, "User set room temperature to %.1f°C", temperature);
       
       // Ignore calls within first 30 seconds after boot - these are from HA restoring state
-      unsigned long uptime_ms = millis();
-      if (uptime_ms < 30000)
+      if (startup_guard_timer_.is_armed())
       {
-        ESP_LOGI(TAG, "Ignoring room temperature set during startup (uptime: %lu ms)", uptime_ms);
+        ESP_LOGI(TAG, "Ignoring room temperature set during startup (%" PRIu32 " ms left)",
+                 timers_.remaining_ms(startup_guard_timer_));
+        trace(active_trace_, SpanEvent::IGNORED, temperature);
         return true;
       }
       
@@ -462,15 +1305,41 @@ namespace esphome
       {
         ESP_LOGI(TAG, "Room temperature (%.1f°C) matches QAA73 (%.1f°C), not activating override",
                  temperature, qaa73_room_setpoint);
+        trace(active_trace_, SpanEvent::IGNORED, qaa73_room_setpoint);
         // Deactivate override if it was active
-        user_heating_override_active_ = false;
+        {
+          BusLock lock(this);
+          if (user_heating_override_active_)
+            trace(heating_override_trace_, SpanEvent::CANCELLED, temperature);
+          user_heating_override_active_ = false;
+        }
+        timers_.cancel(heating_override_timer_);
         return true;
       }
       
       // Activate user override for room setpoint - this will block QAA73 commands
-      user_heating_override_active_ = true;
-      user_heating_setpoint_ = temperature;
-      heating_override_timestamp_ = millis();
+      {
+        BusLock lock(this);
+        if (!user_heating_override_active_)
+        {
+          // Tr only reaches the controller while an override is active, start it
+          // from the last sniffed values instead of waiting for the next frames
+          heating_controller_->reset();
+          heating_controller_->on_outside_temperature(cached_external_temp_.value);
+          heating_controller_->on_room_temperature(cached_room_temp_.value, temperature, millis());
+          override_burner_starts_ = 0;
+        }
+        else
+        {
+          trace(heating_override_trace_, SpanEvent::CANCELLED, temperature);
+        }
+        heating_override_trace_ = active_trace_;
+        heating_rewrite_traced_ = false;
+        trace(active_trace_, SpanEvent::OVERRIDE, qaa73_room_setpoint);
+        user_heating_override_active_ = true;
+        user_heating_setpoint_ = temperature;
+      }
+      timers_.schedule(heating_override_timer_, OVERRIDE_TIMEOUT_);
       
       ESP_LOGI(TAG, "Heating override activated: %.1f°C (QAA73 wants %.1f°C)", temperature, qaa73_room_setpoint);
       
@@ -480,13 +1349,15 @@ namespace esphome
 
       unsigned int data = ot_->temperatureToData(temperature);
       unsigned long request = ot_->buildRequest(OpenThermRequestType::WRITE, OpenThermMessageID::TrSet, data);
-      unsigned long response = ot_->sendRequest(request);
+      unsigned long response = sendBoilerRequest(request);
 
       if (!ot_->isValidResponse(response))
       {
         ESP_LOGE(TAG, "Failed to set room setpoint - invalid response");
+        trace(active_trace_, SpanEvent::FAILED, temperature);
         return false;
       }
+      trace(active_trace_, SpanEvent::WRITTEN, temperature);
 
       // Update climate entity immediately
       if (heating_water_climate_ != nullptr)
@@ -513,286 +1384,289 @@ namespace esphome
     {
       if (instance_ != nullptr && instance_->ot_ != nullptr && instance_->slave_ot_ != nullptr)
       {
-        OpenThermMessageID id = instance_->ot_->getDataID(request);
-        OpenThermMessageType msg_type = instance_->ot_->getMessageType(request);
-        
-        unsigned long modified_request = request;
-        
-        // Check if this is a DHW setpoint write from QAA73 and user has overridden it
-        if (id == OpenThermMessageID::TdhwSet && 
-            msg_type == OpenThermMessageType::WRITE_DATA &&
-            instance_->user_dhw_override_active_)
-        {
-          // Check if override is still active (timeout after 24 hours)
-          unsigned long now = millis();
-          unsigned long override_age = now - instance_->dhw_override_timestamp_;
-          const unsigned long OVERRIDE_TIMEOUT = 24UL * 60UL * 60UL * 1000UL; // 24 hours
-          
-          if (override_age < OVERRIDE_TIMEOUT)
-          {
-            // Get QAA73's DHW setpoint
-            float qaa73_dhw_temp = instance_->ot_->getFloat(request);
-            float user_dhw_temp = instance_->user_dhw_setpoint_;
-            
-            // Check if user has set the same temperature as QAA73 - if so, disable override
-            if (std::abs(qaa73_dhw_temp - user_dhw_temp) < 0.5f)
-            {
-              instance_->user_dhw_override_active_ = false;
-              ESP_LOGI(TAG, "DHW override auto-disabled: User setpoint (%.1f°C) matches QAA73 (%.1f°C)",
-                       user_dhw_temp, qaa73_dhw_temp);
-              // Don't modify request - let QAA73's value through
-            }
-            else
-            {
-              // Replace QAA73's temperature with user's setting
-              unsigned int user_data = instance_->ot_->temperatureToData(user_dhw_temp);
-              modified_request = instance_->ot_->buildRequest(
-                OpenThermRequestType::WRITE,
-                OpenThermMessageID::TdhwSet,
-                user_data
-              );
-              
-              ESP_LOGI(TAG, "DHW override: QAA73 wants %.1f°C, sending user's %.1f°C instead",
-                       qaa73_dhw_temp, user_dhw_temp);
-            }
-          }
-          else
-          {
-            // Override expired, deactivate it
-            instance_->user_dhw_override_active_ = false;
-            ESP_LOGI(TAG, "DHW override expired after 24 hours, resuming QAA73 control");
-          }
-        }
-        
-        // Check if this is CH water setpoint (TSet) from QAA73 and user has heating override active
-        // When user lowers room temp, we need to lower the CH water temperature
-        if (id == OpenThermMessageID::TSet && 
-            msg_type == OpenThermMessageType::WRITE_DATA &&
-            instance_->user_heating_override_active_)
-        {
-          // Check if override is still active (timeout after 24 hours)
-          unsigned long now = millis();
-          unsigned long override_age = now - instance_->heating_override_timestamp_;
-          const unsigned long OVERRIDE_TIMEOUT = 24UL * 60UL * 60UL * 1000UL; // 24 hours
-          
-          if (override_age < OVERRIDE_TIMEOUT)
-          {
-            // Get current room temperature and user's target
-            float current_temp = instance_->cached_room_temp_.value;
-            float target_temp = instance_->user_heating_setpoint_;
-            float qaa73_water_temp = instance_->ot_->getFloat(request);
-            float outdoor_temp = instance_->cached_external_temp_.value;
-            
-            // If current temp is above user's target + hysteresis, force low CH water temp to stop heating
-            if (!std::isnan(current_temp) && current_temp > target_temp + 0.2f)
-            {
-              // Set very low water temperature (20°C) to effectively disable heating
-              unsigned int low_temp_data = instance_->ot_->temperatureToData(20.0f);
-              modified_request = instance_->ot_->buildRequest(
-                OpenThermRequestType::WRITE,
-                OpenThermMessageID::TSet,
-                low_temp_data
-              );
-              
-              ESP_LOGI(TAG, "Heating override: Lowering CH water temp (QAA73: %.1f°C → 20°C) - room %.1f°C > target %.1f°C",
-                       qaa73_water_temp, current_temp, target_temp);
-            }
-            else if (!std::isnan(current_temp) && current_temp < target_temp - 0.5f)
-            {
-              // Room is below target - calculate water temp using heating curve
-              // Use outdoor temperature to calculate proper water temperature
-              float calculated_water_temp = qaa73_water_temp; // Default to QAA73's value
-              
-              if (!std::isnan(outdoor_temp))
-              {
-                // Heating curve calculation (typical slope 1.5, can be adjusted)
-                // Formula: water_temp = base_temp + curve_slope * (20°C - outdoor_temp)
-                // For outdoor -10°C: 30 + 1.5*(20-(-10)) = 30 + 45 = 75°C
-                // For outdoor +15°C: 30 + 1.5*(20-15) = 30 + 7.5 = 37.5°C
-                const float BASE_TEMP = 25.0f;     // Base water temperature
-                const float CURVE_SLOPE = 1.4f;    // Heating curve slope (lower = less aggressive)
-                const float DESIGN_ROOM_TEMP = 20.0f; // Design indoor temperature
-                
-                calculated_water_temp = BASE_TEMP + CURVE_SLOPE * (DESIGN_ROOM_TEMP - outdoor_temp);
-                
-                // Clamp to reasonable limits
-                if (calculated_water_temp < 25.0f) calculated_water_temp = 25.0f;
-                if (calculated_water_temp > 75.0f) calculated_water_temp = 75.0f;
-                
-                ESP_LOGI(TAG, "Heating override: Calculated water temp %.1f°C (outdoor: %.1f°C, QAA73: %.1f°C)",
-                         calculated_water_temp, outdoor_temp, qaa73_water_temp);
-              }
-              else
-              {
-                ESP_LOGW(TAG, "Heating override: No outdoor temp, using QAA73 calculation (%.1f°C)", qaa73_water_temp);
-              }
-              
-              // Send calculated water temperature
-              unsigned int water_temp_data = instance_->ot_->temperatureToData(calculated_water_temp);
-              modified_request = instance_->ot_->buildRequest(
-                OpenThermRequestType::WRITE,
-                OpenThermMessageID::TSet,
-                water_temp_data
-              );
-              
-              ESP_LOGI(TAG, "Heating override: Allowing CH (room %.1f°C < target %.1f°C, water temp %.1f°C)",
-                       current_temp, target_temp, calculated_water_temp);
-            }
-            else
-            {
-              // In hysteresis zone (target-0.5 to target+0.2) - maintain current state
-              ESP_LOGV(TAG, "Heating override: Hysteresis zone (room %.1f°C, target %.1f°C)",
-                       current_temp, target_temp);
-            }
-          }
-          else
+        instance_->bus_health_.record(BusHealth::Side::THERMOSTAT, status == OpenThermResponseStatus::SUCCESS, millis());
+        unsigned long modified_request = instance_->applyOverrides(request);
+
+        // Send the (possibly modified) request to boiler, unless it was prefetched
+        unsigned long response;
+        bool prefetched = instance_->takePrefetched(request, modified_request, response);
+        if (!prefetched)
+          response = instance_->sendBoilerRequest(modified_request, instance_->pass_through_deadline_, true);
+        unsigned long thermostat_response = instance_->checkPassThroughResponse(request, response);
+        instance_->sendThermostatResponse(thermostat_response);
+
+        instance_->recordInterceptedFrame(request, modified_request, response);
+        // A prefetched reply reaches the thermostat as the gateway's answer, its B line was logged with the prefetch
+        instance_->recordPassThrough(request, modified_request, prefetched ? 0 : response, thermostat_response);
+      }
+    }
+
+    // Override timers fire from loop(); an override cancelled in the meantime is left alone
+    void OpenthermComponent::expireDhwOverride(void *context)
+    {
+      OpenthermComponent *self = static_cast<OpenthermComponent *>(context);
+      BusLock lock(self);
+      if (!self->user_dhw_override_active_)
+        return;
+      self->user_dhw_override_active_ = false;
+      ESP_LOGI(TAG, "DHW override expired after 24 hours, resuming QAA73 control");
+      self->trace(self->dhw_override_trace_, SpanEvent::EXPIRED);
+    }
+
+    void OpenthermComponent::expireHeatingOverride(void *context)
+    {
+      OpenthermComponent *self = static_cast<OpenthermComponent *>(context);
+      BusLock lock(self);
+      if (!self->user_heating_override_active_)
+        return;
+      self->user_heating_override_active_ = false;
+      ESP_LOGI(TAG, "Heating override expired after 24 hours, resuming QAA73 control");
+      self->trace(self->heating_override_trace_, SpanEvent::EXPIRED);
+    }
+
+    unsigned long OpenthermComponent::applyOverrides(unsigned long request)
+    {
+      OpenThermMessageID id = ot_->getDataID(request);
+      OpenThermMessageType msg_type = ot_->getMessageType(request);
+
+      HotPath path = HotPath::PASS_THROUGH;
+      if (id == OpenThermMessageID::TdhwSet && user_dhw_override_active_)
+        path = HotPath::DHW_OVERRIDE;
+      else if ((id == OpenThermMessageID::TSet || id == OpenThermMessageID::TrSet) && user_heating_override_active_)
+        path = HotPath::HEATING_OVERRIDE;
+      CycleScope scope(profiler_, path);
+
+      unsigned long modified_request = request;
+
+      // Check if this is a DHW setpoint write from QAA73 and user has overridden it
+      if (id == OpenThermMessageID::TdhwSet &&
+          msg_type == OpenThermMessageType::WRITE_DATA &&
+          user_dhw_override_active_)
+      {
+        // Get QAA73's DHW setpoint
+        float qaa73_dhw_temp = ot_->getFloat(request);
+        float user_dhw_temp = user_dhw_setpoint_;
+
+        // Check if user has set the same temperature as QAA73 - if so, disable override
+        if (std::abs(qaa73_dhw_temp - user_dhw_temp) < 0.5f)
+        {
+          user_dhw_override_active_ = false;
+          ESP_LOGI(TAG, "DHW override auto-disabled: User setpoint (%.1f°C) matches QAA73 (%.1f°C)",
+                   user_dhw_temp, qaa73_dhw_temp);
+          trace(dhw_override_trace_, SpanEvent::CANCELLED, qaa73_dhw_temp);
+          // Don't modify request - let QAA73's value through
+        }
+        else
+        {
+          // Replace QAA73's temperature with user's setting
+          unsigned int user_data = ot_->temperatureToData(user_dhw_temp);
+          modified_request = ot_->buildRequest(
+            OpenThermRequestType::WRITE,
+            OpenThermMessageID::TdhwSet,
+            user_data
+          );
+
+          ESP_LOGI(TAG, "DHW override: QAA73 wants %.1f°C, sending user's %.1f°C instead",
+                   qaa73_dhw_temp, user_dhw_temp);
+          if (!dhw_rewrite_traced_)
           {
-            // Override expired, deactivate it
-            instance_->user_heating_override_active_ = false;
-            ESP_LOGI(TAG, "Heating override expired after 24 hours, resuming QAA73 control");
+            trace(dhw_override_trace_, SpanEvent::REWRITTEN, user_dhw_temp);
+            dhw_rewrite_traced_ = true;
           }
         }
-        
-        // Also override TrSet for consistency (though TSet is what actually controls heating)
-        if (id == OpenThermMessageID::TrSet && 
-            msg_type == OpenThermMessageType::WRITE_DATA &&
-            instance_->user_heating_override_active_)
-        {
-          // Check if override is still active
-          unsigned long now = millis();
-          unsigned long override_age = now - instance_->heating_override_timestamp_;
-          const unsigned long OVERRIDE_TIMEOUT = 24UL * 60UL * 60UL * 1000UL; // 24 hours
-          
-          if (override_age < OVERRIDE_TIMEOUT)
+      }
+
+      // Check if this is CH water setpoint (TSet) from QAA73 and user has heating override active
+      // When user lowers room temp, we need to lower the CH water temperature
+      if (id == OpenThermMessageID::TSet &&
+          msg_type == OpenThermMessageType::WRITE_DATA &&
+          user_heating_override_active_)
+      {
+        // Let the configured controller choose the water temperature for the user's room target
+        float current_temp = cached_room_temp_.value;
+        float target_temp = user_heating_setpoint_;
+        float qaa73_water_temp = ot_->getFloat(request);
+        float water_temp = heating_controller_->compute(target_temp, qaa73_water_temp);
+
+        if (!std::isnan(water_temp))
+        {
+          unsigned int water_temp_data = ot_->temperatureToData(water_temp);
+          modified_request = ot_->buildRequest(
+            OpenThermRequestType::WRITE,
+            OpenThermMessageID::TSet,
+            water_temp_data
+          );
+
+          ESP_LOGD(TAG, "Heating override: CH water temp %.1f°C (QAA73: %.1f°C, room %.1f°C, target %.1f°C)",
+                   water_temp, qaa73_water_temp, current_temp, target_temp);
+          if (!heating_rewrite_traced_)
           {
-            // Get QAA73's room setpoint
-            float qaa73_room_setpoint = instance_->ot_->getFloat(request);
-            float user_setpoint = instance_->user_heating_setpoint_;
-            
-            // Check if user has set the same temperature as QAA73 - if so, disable override
-            if (std::abs(qaa73_room_setpoint - user_setpoint) < 0.3f)
-            {
-              instance_->user_heating_override_active_ = false;
-              ESP_LOGI(TAG, "Heating override auto-disabled: User setpoint (%.1f°C) matches QAA73 (%.1f°C)",
-                       user_setpoint, qaa73_room_setpoint);
-              // Don't modify request - let QAA73's value through
-            }
-            else
-            {
-              // Replace QAA73's room setpoint with user's setting
-              unsigned int user_data = instance_->ot_->temperatureToData(user_setpoint);
-              modified_request = instance_->ot_->buildRequest(
-                OpenThermRequestType::WRITE,
-                OpenThermMessageID::TrSet,
-                user_data
-              );
-              
-              ESP_LOGI(TAG, "Heating override: Room setpoint QAA73 %.1f°C → user %.1f°C",
-                       qaa73_room_setpoint, user_setpoint);
-            }
+            trace(heating_override_trace_, SpanEvent::REWRITTEN, water_temp);
+            heating_rewrite_traced_ = true;
           }
         }
-        
-        // Send the (possibly modified) request to boiler
-        unsigned long response = instance_->ot_->sendRequest(modified_request);
-        instance_->slave_ot_->sendResponse(response);
+        else
+        {
+          // No room temperature yet or inside the hysteresis band - keep QAA73's value
+          ESP_LOGV(TAG, "Heating override: Keeping QAA73 water temp %.1f°C (room %.1f°C, target %.1f°C)",
+                   qaa73_water_temp, current_temp, target_temp);
+        }
+      }
 
-        // Log intercepted requests at VERBOSE level
-        ESP_LOGV(TAG, "Intercepted msg_id %d (type %d), response valid: %s",
-                 static_cast<int>(id),
-                 static_cast<int>(msg_type),
-                 instance_->ot_->isValidResponse(response) ? "yes" : "no");
+      // Also override TrSet for consistency (though TSet is what actually controls heating)
+      if (id == OpenThermMessageID::TrSet &&
+          msg_type == OpenThermMessageType::WRITE_DATA &&
+          user_heating_override_active_)
+      {
+        // Get QAA73's room setpoint
+        float qaa73_room_setpoint = ot_->getFloat(request);
+        float user_setpoint = user_heating_setpoint_;
 
-        // Update status response (critical for binary sensors)
-        if (id == OpenThermMessageID::Status)
+        // Check if user has set the same temperature as QAA73 - if so, disable override
+        if (std::abs(qaa73_room_setpoint - user_setpoint) < 0.3f)
         {
-          last_status_response_ = response;
+          user_heating_override_active_ = false;
+          ESP_LOGI(TAG, "Heating override auto-disabled: User setpoint (%.1f°C) matches QAA73 (%.1f°C)",
+                   user_setpoint, qaa73_room_setpoint);
+          trace(heating_override_trace_, SpanEvent::CANCELLED, qaa73_room_setpoint);
+          // Don't modify request - let QAA73's value through
         }
+        else
+        {
+          // Replace QAA73's room setpoint with user's setting
+          unsigned int user_data = ot_->temperatureToData(user_setpoint);
+          modified_request = ot_->buildRequest(
+            OpenThermRequestType::WRITE,
+            OpenThermMessageID::TrSet,
+            user_data
+          );
+
+          ESP_LOGI(TAG, "Heating override: Room setpoint QAA73 %.1f°C → user %.1f°C",
+                   qaa73_room_setpoint, user_setpoint);
+        }
+      }
+
+      return modified_request;
+    }
+
+    void OpenthermComponent::recordInterceptedFrame(unsigned long request, unsigned long modified_request, unsigned long response)
+    {
+      CycleScope scope(profiler_, HotPath::RECORD_FRAME);
+      OpenThermMessageID id = ot_->getDataID(request);
+      OpenThermMessageType msg_type = ot_->getMessageType(request);
+
+      // Log intercepted requests at VERBOSE level
+      ESP_LOGV(TAG, "Intercepted msg_id %d (type %d), response valid: %s",
+               static_cast<int>(id),
+               static_cast<int>(msg_type),
+               ot_->isValidResponse(response) ? "yes" : "no");
+
+      // Update status response (critical for binary sensors)
+      if (id == OpenThermMessageID::Status)
+      {
+        last_status_response_ = response;
+      }
 
-        // Store response for processing in loop() (outside interrupt context)
-        if (instance_->ot_->isValidResponse(response))
+      // Queue response for processing in loop() (outside the pass-through path)
+      if (ot_->isValidResponse(response))
+      {
+        intercepted_frames_.push({static_cast<uint32_t>(response), static_cast<uint8_t>(id)});
+      }
+      // Also cache WRITE-DATA requests (thermostat setting values).
+      // This is how we capture Tr (ID 24) and TrSet (ID 16) from the master (e.g. QAA73).
+      // The master sends these to the boiler; we sniff them off the bus here.
+      else if (msg_type == OpenThermMessageType::WRITE_DATA)
+      {
+        // For WRITE requests, cache the MODIFIED request if override is active
+        unsigned long cached_frame = request; // Use original request
+        if (id == OpenThermMessageID::TdhwSet && user_dhw_override_active_)
         {
-          last_intercepted_response_ = response;
-          last_intercepted_id_ = id;
-          has_new_intercepted_response_ = true;
+          cached_frame = modified_request;
         }
-        // Also cache WRITE-DATA requests (thermostat setting values).
-        // This is how we capture Tr (ID 24) and TrSet (ID 16) from the master (e.g. QAA73).
-        // The master sends these to the boiler; we sniff them off the bus here.
-        else if (msg_type == OpenThermMessageType::WRITE_DATA)
+        else if (id == OpenThermMessageID::TrSet && user_heating_override_active_)
         {
-          // For WRITE requests, cache the MODIFIED request if override is active
-          if (id == OpenThermMessageID::TdhwSet && instance_->user_dhw_override_active_)
-          {
-            last_intercepted_response_ = modified_request;
-          }
-          else if (id == OpenThermMessageID::TrSet && instance_->user_heating_override_active_)
-          {
-            last_intercepted_response_ = modified_request;
-          }
-          else
-          {
-            last_intercepted_response_ = request; // Use original request
-          }
-          last_intercepted_id_ = id;
-          has_new_intercepted_response_ = true;
-          ESP_LOGV(TAG, "Caching WRITE-DATA request for msg_id %d", static_cast<int>(id));
+          cached_frame = modified_request;
         }
+        intercepted_frames_.push({static_cast<uint32_t>(cached_frame), static_cast<uint8_t>(id)});
+        ESP_LOGV(TAG, "Caching WRITE-DATA request for msg_id %d", static_cast<int>(id));
       }
     }
 
     void OpenthermComponent::processCachedResponse(unsigned long response, OpenThermMessageID id)
     {
       // This runs in loop(), not interrupt context - safe to do complex operations
+      ProfileScope scope(profiler_, ProfileSlot::CACHED_RESPONSE, static_cast<uint8_t>(id));
+      CycleScope cycles(profiler_, HotPath::CACHED_RESPONSE);
       unsigned long now = millis();
 
+      // Every decoded frame goes to the telemetry stream, including IDs that are not cached
+      telemetry_.add(static_cast<uint8_t>(id), response & 0xFFFF, now);
+      history_.add(static_cast<uint8_t>(id), response & 0xFFFF, now);
+      recorder_.add(response, now);
+      observeFrame(response, id, now);
+
+      CachedValue *cache = cachedValueFor(id);
+      if (cache != nullptr)
+        markReceived(*cache, ValueSource::SNIFFED, now);
+
+      if (!frame_tracker_.update(static_cast<uint8_t>(id), response))
+      {
+        // Repeated frame: the cached value is current, only its timestamps moved
+        // The PI controller integrates over time and still needs every room temperature sample
+        if (id == OpenThermMessageID::Tr)
+        {
+          BusLock lock(this);
+          if (user_heating_override_active_)
+            heating_controller_->on_room_temperature(cached_room_temp_.value, user_heating_setpoint_, now);
+        }
+        return;
+      }
+
+      expressions_.on_value(static_cast<uint8_t>(id), response & 0xFFFF);
+
       switch (id)
       {
         case OpenThermMessageID::Toutside:
+        {
+          BusLock lock(this);
           cached_external_temp_.value = ot_->getFloat(response);
-          cached_external_temp_.last_update = now;
+          heating_controller_->on_outside_temperature(cached_external_temp_.value);
+        }
           ESP_LOGV(TAG, "Cached external temp: %.1f°C", cached_external_temp_.value);
           break;
 
         case OpenThermMessageID::Tret:
           cached_return_temp_.value = ot_->getFloat(response);
-          cached_return_temp_.last_update = now;
           ESP_LOGV(TAG, "Cached return temp: %.1f°C", cached_return_temp_.value);
           break;
 
         case OpenThermMessageID::Tboiler:
           cached_boiler_temp_.value = ot_->getFloat(response);
-          cached_boiler_temp_.last_update = now;
           ESP_LOGV(TAG, "Cached boiler temp: %.1f°C", cached_boiler_temp_.value);
           break;
 
         case OpenThermMessageID::CHPressure:
           cached_pressure_.value = ot_->getFloat(response);
-          cached_pressure_.last_update = now;
           ESP_LOGV(TAG, "Cached pressure: %.1f bar", cached_pressure_.value);
           break;
 
         case OpenThermMessageID::RelModLevel:
           cached_modulation_.value = ot_->getFloat(response);
-          cached_modulation_.last_update = now;
           ESP_LOGV(TAG, "Cached modulation: %.1f%%", cached_modulation_.value);
           break;
 
         case OpenThermMessageID::TSet:
           cached_heating_target_.value = ot_->getFloat(response);
-          cached_heating_target_.last_update = now;
           ESP_LOGV(TAG, "Cached heating target: %.1f°C", cached_heating_target_.value);
           break;
 
         case OpenThermMessageID::Tdhw:
           cached_dhw_temp_.value = ot_->getFloat(response);
-          cached_dhw_temp_.last_update = now;
           ESP_LOGV(TAG, "Cached DHW temp: %.1f°C", cached_dhw_temp_.value);
           break;
 
         case OpenThermMessageID::TdhwSet:
           cached_dhw_target_.value = ot_->getFloat(response);
-          cached_dhw_target_.last_update = now;
           ESP_LOGV(TAG, "Cached DHW target: %.1f°C", cached_dhw_target_.value);
           break;
 
@@ -800,8 +1674,13 @@ namespace esphome
         // The master periodically sends the actual room temperature it measures
         // (or receives from a connected room sensor) to the boiler.
         case OpenThermMessageID::Tr:
+        {
+          // applyOverrides() reads both from the bus task
+          BusLock lock(this);
           cached_room_temp_.value = ot_->getFloat(response);
-          cached_room_temp_.last_update = now;
+          if (user_heating_override_active_)
+            heating_controller_->on_room_temperature(cached_room_temp_.value, user_heating_setpoint_, now);
+        }
           ESP_LOGV(TAG, "Cached room temp: %.1f°C", cached_room_temp_.value);
           break;
 
@@ -810,14 +1689,37 @@ namespace esphome
         // to the boiler. This is the target the QAA73 is currently trying to reach.
         case OpenThermMessageID::TrSet:
           cached_room_setpoint_.value = ot_->getFloat(response);
-          cached_room_setpoint_.last_update = now;
           ESP_LOGV(TAG, "Cached room setpoint: %.1f°C", cached_room_setpoint_.value);
           break;
 
         case OpenThermMessageID::Status:
+        {
           // Already handled in processRequest for immediate binary sensor updates
           ESP_LOGD(TAG, "Updated status response: %lu", response);
+
+          // A fault or diagnostic bit going high freezes the flight recorder window
+          uint8_t fault_flags = (ot_->isFault(response) ? 0x01 : 0) | (ot_->isDiagnostic(response) ? 0x02 : 0);
+          if (last_fault_flags_ != 0xFF)
+          {
+            uint8_t raised = fault_flags & ~last_fault_flags_;
+            if (raised & 0x01)
+              recorder_.trigger(IncidentTrigger::FAULT, response & 0xFFFF, now);
+            else if (raised & 0x02)
+              recorder_.trigger(IncidentTrigger::DIAGNOSTIC, response & 0xFFFF, now);
+          }
+          last_fault_flags_ = fault_flags;
+
+          // Count burner starts during a heating override to judge controller behaviour
+          bool flame_on = ot_->isFlameOn(response);
+          if (flame_on && !last_flame_on_)
+          {
+            BusLock lock(this);
+            if (user_heating_override_active_)
+              override_burner_starts_++;
+          }
+          last_flame_on_ = flame_on;
           break;
+        }
 
         default:
           // Other message IDs not cached
@@ -825,70 +1727,550 @@ namespace esphome
       }
     }
 
+    OpenthermComponent::CachedValue *OpenthermComponent::cachedValueFor(OpenThermMessageID id)
+    {
+      switch (id)
+      {
+        case OpenThermMessageID::Toutside:
+          return &cached_external_temp_;
+        case OpenThermMessageID::Tret:
+          return &cached_return_temp_;
+        case OpenThermMessageID::Tboiler:
+          return &cached_boiler_temp_;
+        case OpenThermMessageID::CHPressure:
+          return &cached_pressure_;
+        case OpenThermMessageID::RelModLevel:
+          return &cached_modulation_;
+        case OpenThermMessageID::TSet:
+          return &cached_heating_target_;
+        case OpenThermMessageID::Tdhw:
+          return &cached_dhw_temp_;
+        case OpenThermMessageID::TdhwSet:
+          return &cached_dhw_target_;
+        case OpenThermMessageID::Tr:
+          return &cached_room_temp_;
+        case OpenThermMessageID::TrSet:
+          return &cached_room_setpoint_;
+        default:
+          return nullptr;
+      }
+    }
+
     float OpenthermComponent::getCachedOrFetch(CachedValue &cache, OpenThermMessageID msg_id)
     {
-      unsigned long now = millis();
+      ProfileScope scope(profiler_, ProfileSlot::POLL, static_cast<uint8_t>(msg_id));
+      uint32_t start_cycles = profiler_.is_enabled() ? arch_get_cpu_cycle_count() : 0;
+
+      // Listen-only: values only ever come from intercepted frames, NAN until observed
+      if (listen_only_)
+        return cache.value;
+
+      // The poll timer is armed for CACHE_TIMEOUT_ after a value arrived and for
+      // MIN_FETCH_INTERVAL_ after a failed fetch left no value; until it runs out
+      // the cached value (or NAN) is returned without touching the bus
+      if (cache.poll_timer.is_armed())
+      {
+        ESP_LOGV(TAG, "Using cached value for msg_id %d: %.2f", static_cast<int>(msg_id), cache.value);
+        if (profiler_.is_enabled())
+          profiler_.record_cycles(HotPath::CACHE_HIT, arch_get_cpu_cycle_count() - start_cycles);
+        return cache.value;
+      }
+
+      // Deferred polls leave the timer disarmed and are retried on the next call
+      if (!admitPoll(msg_id))
+        return cache.value;
+
+      ESP_LOGV(TAG, "Cache expired for msg_id %d, fetching from boiler", static_cast<int>(msg_id));
+      unsigned long response = sendBoilerRequest(ot_->buildRequest(OpenThermRequestType::READ, msg_id, 0));
+
+      if (ot_->isValidResponse(response))
+      {
+        cache.value = ot_->getFloat(response);
+        markReceived(cache, ValueSource::POLLED, millis());
+        if (frame_tracker_.update(static_cast<uint8_t>(msg_id), response))
+          expressions_.on_value(static_cast<uint8_t>(msg_id), response & 0xFFFF);
+        ESP_LOGV(TAG, "Fetched value for msg_id %d: %.2f", static_cast<int>(msg_id), cache.value);
+        return cache.value;
+      }
+
+      ESP_LOGW(TAG, "Failed to fetch value for msg_id %d, using stale cache if available", static_cast<int>(msg_id));
+      // Rearm even on failure to prevent continuous retry spam
+      timers_.schedule(cache.poll_timer, std::isnan(cache.value) ? MIN_FETCH_INTERVAL_ : CACHE_TIMEOUT_);
+      return cache.value; // Return stale value or NAN
+    }
+
+    void OpenthermComponent::markReceived(CachedValue &cache, ValueSource source, uint32_t now)
+    {
+      cache.received_at = now;
+      cache.source = source;
+      timers_.schedule(cache.poll_timer, CACHE_TIMEOUT_);
+      if (cache.max_age != 0)
+        timers_.schedule(cache.freshness_timer, cache.max_age);
+    }
+
+    // Locked, since override events are traced from the bus task
+    uint16_t OpenthermComponent::traceBegin(CommandType type, float value)
+    {
+      BusLock lock(this);
+      return tracer_.begin(type, value, millis());
+    }
+
+    void OpenthermComponent::trace(uint16_t command, SpanEvent event, float value)
+    {
+      BusLock lock(this);
+      tracer_.add(command, event, value, millis());
+    }
+
+#ifdef USE_ESP32
+    void OpenthermComponent::startBusTask()
+    {
+      bus_mutex_ = xSemaphoreCreateRecursiveMutex();
+      // Above the Arduino loop task priority, so pass-through preempts a busy main loop
+      BaseType_t result = xTaskCreatePinnedToCore(busTask, "opentherm", BUS_TASK_STACK_SIZE, this,
+                                                  BUS_TASK_PRIORITY, &bus_task_handle_, BUS_TASK_CORE);
+      if (result != pdPASS)
+      {
+        ESP_LOGE(TAG, "Failed to start OpenTherm bus task, handling pass-through in loop()");
+        bus_task_ = false;
+        return;
+      }
+      ESP_LOGI(TAG, "OpenTherm bus task started on core %d", BUS_TASK_CORE);
+    }
 
-      // Handle first fetch (cache never updated) - last_update will be 0
-      if (cache.last_update == 0)
+    void OpenthermComponent::busTask(void *arg)
+    {
+      auto *self = static_cast<OpenthermComponent *>(arg);
+      for (;;)
       {
-        ESP_LOGV(TAG, "First fetch for msg_id %d", static_cast<int>(msg_id));
-        unsigned long response = ot_->sendRequest(ot_->buildRequest(OpenThermRequestType::READ, msg_id, 0));
+        {
+          BusLock lock(self);
+          self->processThermostatBus();
+          self->runPrefetch();
+        }
+        vTaskDelay(1);
+      }
+    }
+#endif
+
+    unsigned long OpenthermComponent::exchangeBoilerFrame(unsigned long request, unsigned long timeout)
+    {
+      BusLock lock(this);
+
+      if (timeout == 0)
+        timeout = RESPONSE_TIMEOUT_;
 
-        if (ot_->isValidResponse(response))
+      if (!deferred_decoding_)
+      {
+        // A reply that arrived after an earlier missed deadline may still hold the bus.
+        // The library returns to READY within its 1 s timeout, longer means it is stuck
+        unsigned long wait_start = millis();
+        while (!ot_->isReady())
         {
-          cache.value = ot_->getFloat(response);
-          cache.last_update = now;
-          ESP_LOGV(TAG, "First fetch for msg_id %d: %.2f", static_cast<int>(msg_id), cache.value);
-          return cache.value;
+          if (millis() - wait_start > 2 * RESPONSE_TIMEOUT_)
+          {
+            ESP_LOGD(TAG, "Boiler line not ready after %lu ms", millis() - wait_start);
+            last_response_time_ = timeout;
+            return 0;
+          }
+          ot_->process();
+          yield();
         }
-        else
+
+        // The library waits up to its own 1 s timeout, only take the async route for shorter budgets
+        if (timeout >= RESPONSE_TIMEOUT_)
+        {
+          unsigned long start = millis();
+          unsigned long response = ot_->sendRequest(request);
+          last_response_time_ = millis() - start;
+          // On timeout the library hands back whatever bits it had shifted in
+          if (ot_->getLastResponseStatus() == OpenThermResponseStatus::TIMEOUT)
+            return 0;
+          return response;
+        }
+
+        if (!ot_->sendRequestAync(request))
+          return 0;
+
+        unsigned long start = millis();
+        while (millis() - start < timeout)
         {
-          ESP_LOGW(TAG, "First fetch failed for msg_id %d", static_cast<int>(msg_id));
-          cache.last_update = now; // Set timestamp to prevent immediate retry
-          return NAN;
+          ot_->process();
+          if (ot_->getLastResponseStatus() != OpenThermResponseStatus::NONE)
+          {
+            last_response_time_ = millis() - start;
+            return ot_->getLastResponse();
+          }
+          yield();
         }
+        last_response_time_ = timeout;
+        return 0;
+      }
+
+      // Let an in-flight pass-through finish first, the bus carries one transaction at a time
+      while (pass_through_state_ != PassThroughState::IDLE)
+      {
+        runPassThrough();
+        yield();
       }
 
-      // Unsigned arithmetic handles millis() overflow correctly (wraps at 2^32)
-      unsigned long cache_age = now - cache.last_update;
+      transmit(out_pin_, request);
 
-      // Check if cache is fresh (updated within last minute)
-      if (!std::isnan(cache.value) && cache_age < CACHE_TIMEOUT_)
+      // Drop anything seen while transmitting (adapter echo) and wait for the reply
+      boiler_edges_.clear();
+      boiler_decoder_.reset();
+      unsigned long start = millis();
+      while (millis() - start < timeout)
       {
-        ESP_LOGV(TAG, "Using cached value for msg_id %d: %.2f (age: %lu ms)",
-                 static_cast<int>(msg_id), cache.value, cache_age);
-        return cache.value;
+        uint32_t response;
+        if (boiler_decoder_.poll(boiler_edges_, response))
+        {
+          last_response_time_ = millis() - start;
+          return response;
+        }
+        yield();
+      }
+
+      ESP_LOGV(TAG, "No boiler response within %lu ms", timeout);
+      last_response_time_ = timeout;
+      return 0;
+    }
+
+    unsigned long OpenthermComponent::sendBoilerRequest(unsigned long request, unsigned long timeout, bool pass_through)
+    {
+      // Held across the exchange and the record, so frame server lines keep bus order
+      BusLock lock(this);
+      unsigned long start = millis();
+      unsigned long response = exchangeBoilerFrame(request, timeout);
+      unsigned long end = millis();
+      bus_meter_.record(pass_through ? BusMeter::Source::PASS_THROUGH : BusMeter::Source::GATEWAY, end - start, end);
+      bus_health_.record(BusHealth::Side::BOILER, isFrame(response), end);
+      if (!pass_through && frame_server_.is_configured())
+      {
+        FrameServer::Line lines[2] = {{'R', static_cast<uint32_t>(request)}, {'B', static_cast<uint32_t>(response)}};
+        frame_server_.add(lines, response != 0 ? 2 : 1);
+      }
+      return response;
+    }
+
+    void OpenthermComponent::runTableSync()
+    {
+      if (!table_sync_.is_configured() || listen_only_ || table_sync_timer_.is_armed() || table_sync_.is_done())
+        return;
+      // Between thermostat exchanges only; with a bus task the bus lock keeps the two apart
+      if (!bus_task_ && pass_through_state_ != PassThroughState::IDLE)
+        return;
+      timers_.schedule(table_sync_timer_, table_sync_interval_);
+
+      uint8_t id;
+      uint16_t data;
+      for (uint8_t i = 0; i < table_sync_.get_batch() && table_sync_.next_request(id, data); i++)
+      {
+        // Polls come first, a step the bus has no room for is retried on the next one
+        OpenThermMessageID msg_id = static_cast<OpenThermMessageID>(id);
+        if (!admitPoll(msg_id))
+          break;
+        unsigned long response = sendBoilerRequest(ot_->buildRequest(OpenThermRequestType::READ, msg_id, data));
+        table_sync_.on_response(ot_->isValidResponse(response) && ot_->getDataID(response) == msg_id,
+                                response & 0xFFFF);
+      }
+    }
+
+    void OpenthermComponent::reportTableSync()
+    {
+      if (table_sync_progress_sensor_ != nullptr)
+        table_sync_progress_sensor_->publish_state(table_sync_.get_progress());
+      if (table_sync_frames_sensor_ != nullptr)
+        table_sync_frames_sensor_->publish_state(table_sync_.get_frames());
+    }
+
+    void OpenthermComponent::superviseBus()
+    {
+      uint32_t now = millis();
+      if (!bus_health_.is_configured() || now - last_health_check_ < HEALTH_CHECK_INTERVAL_)
+        return;
+      last_health_check_ = now;
+
+      // Keeps the bus task out while an instance is torn down and rebuilt
+      BusLock lock(this);
+      if (bus_health_.reset_due(BusHealth::Side::BOILER, now) && resetBoilerSide())
+      {
+        bus_health_.on_reset(BusHealth::Side::BOILER, now);
+        boiler_probe_pending_ = true;
+        ESP_LOGW(TAG, "Boiler side failed, reinitialized (reset %" PRIu32 ")",
+                 bus_health_.get_resets(BusHealth::Side::BOILER));
+      }
+      if (bus_health_.reset_due(BusHealth::Side::THERMOSTAT, now) && resetThermostatSide())
+      {
+        bus_health_.on_reset(BusHealth::Side::THERMOSTAT, now);
+        ESP_LOGW(TAG, "Thermostat side failed, reinitialized (reset %" PRIu32 ")",
+                 bus_health_.get_resets(BusHealth::Side::THERMOSTAT));
+      }
+    }
+
+    // Called with the bus lock held. False if the side is mid-frame, retried on the next check
+    bool OpenthermComponent::resetBoilerSide()
+    {
+      if (deferred_decoding_)
+      {
+        // Never cut a frame the timer is clocking out
+        if (transmitter_.is_busy())
+          return false;
+        detachInterrupt(digitalPinToInterrupt(in_pin_));
+        pinMode(in_pin_, INPUT);
+        pinMode(out_pin_, OUTPUT);
+        digitalWrite(out_pin_, HIGH); // Idle state
+        boiler_edges_.clear();
+        boiler_decoder_.reset();
+        attachInterrupt(digitalPinToInterrupt(in_pin_), handleEdgeInterrupt, CHANGE);
+        return true;
       }
 
-      // Rate limiting: Don't fetch if we just fetched recently (prevents spam if cache keeps expiring)
-      if (cache_age < MIN_FETCH_INTERVAL_)
+      ot_->end();
+      ot_->~OpenTherm();
+      ot_ = new (ot_storage_) OpenTherm(in_pin_, out_pin_, false);
+      ot_->begin(handleInterrupt);
+      return true;
+    }
+
+    bool OpenthermComponent::resetThermostatSide()
+    {
+      if (deferred_decoding_)
       {
-        ESP_LOGV(TAG, "Rate limited fetch for msg_id %d (last fetch %lu ms ago, min interval %lu ms)",
-                 static_cast<int>(msg_id), cache_age, MIN_FETCH_INTERVAL_);
-        return cache.value; // Return stale value rather than spam the bus
+        // The thermostat decoder is only idle between exchanges
+        if (transmitter_.is_busy() || pass_through_state_ != PassThroughState::IDLE)
+          return false;
+        detachInterrupt(digitalPinToInterrupt(slave_in_pin_));
+        pinMode(slave_in_pin_, INPUT);
+        pinMode(slave_out_pin_, OUTPUT);
+        digitalWrite(slave_out_pin_, HIGH); // Idle state
+        thermostat_edges_.clear();
+        thermostat_decoder_.reset();
+        attachInterrupt(digitalPinToInterrupt(slave_in_pin_), slaveHandleEdgeInterrupt, CHANGE);
+        return true;
       }
 
-      // Cache is stale - fetch from boiler
-      ESP_LOGV(TAG, "Cache stale for msg_id %d (age: %lu ms), fetching from boiler",
-               static_cast<int>(msg_id), cache_age);
-      unsigned long response = ot_->sendRequest(ot_->buildRequest(OpenThermRequestType::READ, msg_id, 0));
+      slave_ot_->end();
+      slave_ot_->~OpenTherm();
+      slave_ot_ = new (slave_ot_storage_) OpenTherm(slave_in_pin_, slave_out_pin_, true);
+      slave_ot_->begin(slaveHandleInterrupt, processRequest);
+      return true;
+    }
+
+    // Called with the bus lock held (bus task) or from loop() when there is no task
+    void OpenthermComponent::recordPassThrough(unsigned long request, unsigned long modified_request,
+                                               unsigned long response, unsigned long thermostat_response)
+    {
+      if (!frame_server_.is_configured())
+        return;
+
+      FrameServer::Line lines[FrameServer::MAX_GROUP];
+      uint8_t count = 0;
+      lines[count++] = {'T', static_cast<uint32_t>(request)};
+      if (modified_request != request)
+        lines[count++] = {'R', static_cast<uint32_t>(modified_request)};
+      if (response != 0)
+        lines[count++] = {'B', static_cast<uint32_t>(response)};
+      if (thermostat_response != response)
+        lines[count++] = {'A', static_cast<uint32_t>(thermostat_response)};
+      frame_server_.add(lines, count);
+    }
+
+    unsigned long OpenthermComponent::checkPassThroughResponse(unsigned long request, unsigned long response)
+    {
+      OpenThermMessageID id = ot_->getDataID(request);
+      uint8_t index = static_cast<uint8_t>(id);
+
+      if (last_response_time_ > max_response_time_)
+      {
+        max_response_time_ = last_response_time_;
+        max_response_time_id_ = index;
+      }
 
+      bool is_read = ot_->getMessageType(request) == OpenThermMessageType::READ_DATA;
       if (ot_->isValidResponse(response))
       {
-        cache.value = ot_->getFloat(response);
-        cache.last_update = now;
-        ESP_LOGV(TAG, "Fetched value for msg_id %d: %.2f", static_cast<int>(msg_id), cache.value);
-        return cache.value;
+        if (is_read && index < MAX_TRACKED_ID)
+          fallback_replies_[index] = {static_cast<uint32_t>(response), millis(), static_cast<uint16_t>(request & 0xFFFF)};
+        return response;
       }
-      else
+
+      // Without a deadline keep the previous behaviour and forward whatever came back
+      if (pass_through_deadline_ == 0)
+        return response;
+
+      // The boiler answered in time, only not with an ACK: its DATA-INVALID or UNKNOWN-DATAID
+      // is the thermostat's to see. Types 4-7 are the response types.
+      if (response != 0 && !OpenTherm::parity(response) && (response & (1UL << 30)) != 0 &&
+          ot_->getDataID(response) == id)
+        return response;
+
+      deadline_misses_total_++;
+      if (index < MAX_TRACKED_ID)
+        deadline_misses_[index]++;
+
+      // READs are answered from a recent boiler reply to the same READ. Indexed tables
+      // (TSP, fault history) carry the index in the data-value and are never substituted.
+      if (is_read && index < MAX_TRACKED_ID && id != OpenThermMessageID::TSPindexTSPvalue &&
+          id != OpenThermMessageID::FHBindexFHBvalue)
       {
-        ESP_LOGW(TAG, "Failed to fetch value for msg_id %d, using stale cache if available", static_cast<int>(msg_id));
-        // Update timestamp even on failure to prevent continuous retry spam
-        cache.last_update = now;
+        const FallbackReply &fallback = fallback_replies_[index];
+        if (fallback.response != 0 && fallback.request_data == (request & 0xFFFF) &&
+            millis() - fallback.received_at <= FALLBACK_MAX_AGE_)
+        {
+          ESP_LOGD(TAG, "Boiler missed %lu ms deadline for msg_id %d, answering from cache",
+                   pass_through_deadline_, static_cast<int>(id));
+          return fallback.response;
+        }
       }
 
-      return cache.value; // Return stale value or NAN
+      ESP_LOGD(TAG, "Boiler missed %lu ms deadline for msg_id %d, answering DATA-INVALID",
+               pass_through_deadline_, static_cast<int>(id));
+      return ot_->buildResponse(OpenThermMessageType::DATA_INVALID, id, request & 0xFFFF);
+    }
+
+    void OpenthermComponent::sendThermostatResponse(unsigned long response)
+    {
+      if (!deferred_decoding_)
+      {
+        slave_ot_->sendResponse(response);
+        return;
+      }
+
+      transmit(slave_out_pin_, response);
+      thermostat_edges_.clear();
+      thermostat_decoder_.reset();
+    }
+
+    void OpenthermComponent::transmit(int out_pin, unsigned long frame)
+    {
+      if (!timer_transmit_)
+      {
+        transmitFrame(out_pin, frame);
+        return;
+      }
+
+      // Blocking callers still wait for the frame, but yield instead of spinning
+      transmitter_.start(out_pin, frame);
+      while (transmitter_.is_busy())
+        yield();
+    }
+
+    bool OpenthermComponent::runPassThrough()
+    {
+      switch (pass_through_state_)
+      {
+        case PassThroughState::IDLE:
+        {
+          uint32_t request;
+          if (!thermostat_decoder_.poll(thermostat_edges_, request))
+            return false;
+          bool valid = slave_ot_->isValidRequest(request);
+          bus_health_.record(BusHealth::Side::THERMOSTAT, valid, millis());
+          if (!valid)
+          {
+            ESP_LOGW(TAG, "Ignoring invalid thermostat frame 0x%08" PRIX32, request);
+            return true;
+          }
+
+          pass_through_request_ = request;
+          pass_through_modified_request_ = applyOverrides(request);
+
+          unsigned long prefetched;
+          if (takePrefetched(request, pass_through_modified_request_, prefetched))
+          {
+            // Answered without touching the boiler line, the reply still refreshes the fallback cache
+            unsigned long thermostat_response = checkPassThroughResponse(request, prefetched);
+            transmitter_.start(slave_out_pin_, thermostat_response);
+            recordInterceptedFrame(request, pass_through_modified_request_, prefetched);
+            recordPassThrough(request, pass_through_modified_request_, 0, thermostat_response);
+            pass_through_state_ = PassThroughState::THERMOSTAT_RESPONSE;
+            return true;
+          }
+
+          transmitter_.start(out_pin_, pass_through_modified_request_);
+          pass_through_state_ = PassThroughState::BOILER_REQUEST;
+          return true;
+        }
+
+        case PassThroughState::BOILER_REQUEST:
+          if (transmitter_.is_busy())
+            return false;
+          // Drop adapter echo of our own request, then wait for the boiler
+          boiler_edges_.clear();
+          boiler_decoder_.reset();
+          pass_through_timestamp_ = millis();
+          pass_through_state_ = PassThroughState::BOILER_RESPONSE;
+          return true;
+
+        case PassThroughState::BOILER_RESPONSE:
+        {
+          unsigned long timeout = pass_through_deadline_ != 0 ? pass_through_deadline_ : RESPONSE_TIMEOUT_;
+          uint32_t response;
+          if (!boiler_decoder_.poll(boiler_edges_, response))
+          {
+            if (millis() - pass_through_timestamp_ < timeout)
+              return false;
+            ESP_LOGV(TAG, "No boiler response within %lu ms", timeout);
+            response = 0;
+          }
+          last_response_time_ = millis() - pass_through_timestamp_;
+          // The timestamp is taken after our request frame went out
+          bus_meter_.record(BusMeter::Source::PASS_THROUGH, BusMeter::FRAME_MS + last_response_time_, millis());
+          bus_health_.record(BusHealth::Side::BOILER, isFrame(response), millis());
+
+          unsigned long thermostat_response = checkPassThroughResponse(pass_through_request_, response);
+          transmitter_.start(slave_out_pin_, thermostat_response);
+          recordInterceptedFrame(pass_through_request_, pass_through_modified_request_, response);
+          recordPassThrough(pass_through_request_, pass_through_modified_request_, response, thermostat_response);
+          pass_through_state_ = PassThroughState::THERMOSTAT_RESPONSE;
+          return true;
+        }
+
+        case PassThroughState::THERMOSTAT_RESPONSE:
+          if (transmitter_.is_busy())
+            return false;
+          thermostat_edges_.clear();
+          thermostat_decoder_.reset();
+          pass_through_state_ = PassThroughState::IDLE;
+          return true;
+      }
+      return false;
+    }
+
+    void OpenthermComponent::transmitFrame(int out_pin, unsigned long frame)
+    {
+      // Active level is LOW on the adapter output.
+      // A '1' is active for the first half bit and idle for the second half.
+      auto send_bit = [out_pin](bool high)
+      {
+        digitalWrite(out_pin, high ? LOW : HIGH);
+        delayMicroseconds(500);
+        digitalWrite(out_pin, high ? HIGH : LOW);
+        delayMicroseconds(500);
+      };
+
+      send_bit(true); // Start bit
+      for (int i = 31; i >= 0; i--)
+        send_bit((frame >> i) & 1UL);
+      send_bit(true); // Stop bit
+      digitalWrite(out_pin, HIGH); // Back to idle
+    }
+
+    void OpenthermComponent::logDecoderStats()
+    {
+      uint32_t errors = boiler_decoder_.get_timing_errors() + boiler_decoder_.get_parity_errors() +
+                        boiler_edges_.get_overflows() + thermostat_decoder_.get_timing_errors() +
+                        thermostat_decoder_.get_parity_errors() + thermostat_edges_.get_overflows();
+      if (errors == last_decode_errors_)
+        return;
+      last_decode_errors_ = errors;
+
+      ESP_LOGD(TAG, "Boiler decoder: %" PRIu32 " frames, %" PRIu32 " timing, %" PRIu32 " parity, %" PRIu32 " overflow",
+               boiler_decoder_.get_frames(), boiler_decoder_.get_timing_errors(),
+               boiler_decoder_.get_parity_errors(), boiler_edges_.get_overflows());
+      ESP_LOGD(TAG, "Thermostat decoder: %" PRIu32 " frames, %" PRIu32 " timing, %" PRIu32 " parity, %" PRIu32 " overflow",
+               thermostat_decoder_.get_frames(), thermostat_decoder_.get_timing_errors(),
+               thermostat_decoder_.get_parity_errors(), thermostat_edges_.get_overflows());
     }
 
     void IRAM_ATTR OpenthermComponent::handleInterrupt()
@@ -907,6 +2289,22 @@ namespace esphome
       }
     }
 
+    void IRAM_ATTR OpenthermComponent::handleEdgeInterrupt()
+    {
+      if (instance_ != nullptr)
+      {
+        instance_->boiler_edges_.push(micros(), digitalRead(instance_->in_pin_) == HIGH);
+      }
+    }
+
+    void IRAM_ATTR OpenthermComponent::slaveHandleEdgeInterrupt()
+    {
+      if (instance_ != nullptr)
+      {
+        instance_->thermostat_edges_.push(micros(), digitalRead(instance_->slave_in_pin_) == HIGH);
+      }
+    }
+
     bool OpenthermComponent::sendBoilerReset()
     {
       ESP_LOGW(TAG, "Sending Boiler Lock-Out Reset (BLOR) command");
@@ -918,7 +2316,10 @@ namespace esphome
           0x0100);                      // HB=1 (BLOR command), LB=0
 
       ESP_LOGD(TAG, "BLOR request: 0x%08lX", request);
-      unsigned long response = ot_->sendRequest(request);
+      recorder_.trigger(IncidentTrigger::BOILER_RESET, last_status_response_ & 0xFFFF, millis());
+      recorder_.add(request, millis());
+      unsigned long response = sendBoilerRequest(request);
+      recorder_.add(response, millis());
       ESP_LOGD(TAG, "BLOR response: 0x%08lX", response);
 
       if (ot_->isValidResponse(response))
@@ -936,16 +2337,19 @@ namespace esphome
         if (low_byte >= 128 || high_byte == 1)
         {
           ESP_LOGI(TAG, "Boiler reset command completed successfully (HB=%d, LB=%d)", high_byte, low_byte);
+          trace(active_trace_, SpanEvent::WRITTEN, low_byte);
           return true;
         }
         else
         {
           ESP_LOGW(TAG, "Boiler reset command failed or not supported (HB=%d, LB=%d)", high_byte, low_byte);
+          trace(active_trace_, SpanEvent::FAILED, low_byte);
           return false;
         }
       }
 
       ESP_LOGE(TAG, "Boiler reset command - no valid response");
+      trace(active_trace_, SpanEvent::FAILED);
       return false;
     }
 
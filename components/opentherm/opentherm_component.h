@@ -5,6 +5,32 @@
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #include "OpenTherm.h"
 #include "opentherm_climate.h"
+#include "opentherm_edge_decoder.h"
+#include "opentherm_transmitter.h"
+#include "opentherm_frame_queue.h"
+#include "opentherm_heating_controller.h"
+#include "opentherm_telemetry.h"
+#include "opentherm_command_queue.h"
+#include "opentherm_history.h"
+#include "opentherm_profiler.h"
+#include "opentherm_snapshot.h"
+#include "opentherm_expression.h"
+#include "opentherm_frame_server.h"
+#include "opentherm_allocation_guard.h"
+#include "opentherm_bus_meter.h"
+#include "opentherm_prefetch.h"
+#include "opentherm_trace.h"
+#include "opentherm_frame_tracker.h"
+#include "opentherm_flight_recorder.h"
+#include "opentherm_bus_health.h"
+#include "opentherm_timer_wheel.h"
+#include "opentherm_table_sync.h"
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#endif
 
 namespace esphome
 {
@@ -31,6 +57,7 @@ namespace esphome
       void setup() override;
       void loop() override;
       void update() override;
+      void dump_config() override;
 
       // Pin configurations
       void set_in_pin(int pin) { in_pin_ = pin; }
@@ -38,6 +65,39 @@ namespace esphome
       void set_slave_in_pin(int pin) { slave_in_pin_ = pin; }
       void set_slave_out_pin(int pin) { slave_out_pin_ = pin; }
 
+      // Receive path: record edge timestamps in the ISR and decode frames in loop()
+      void set_deferred_decoding(bool deferred) { deferred_decoding_ = deferred; }
+      // Transmit path: clock frames out from a hardware timer, pass-through runs as a state machine
+      void set_timer_transmit(bool timer_transmit) { timer_transmit_ = timer_transmit; }
+      // ESP32 only: run pass-through in a dedicated pinned task instead of loop()
+      void set_bus_task(bool bus_task) { bus_task_ = bus_task; }
+      // Boiler reply budget for pass-through frames, 0 = wait for the protocol timeout
+      void set_pass_through_deadline(uint32_t deadline) { pass_through_deadline_ = deadline; }
+      // Stream decoded frames as batched binary UDP datagrams
+      void set_telemetry(const std::string &host, uint16_t port, uint32_t max_size, uint32_t max_age)
+      {
+        telemetry_.configure(host, port, max_size, max_age);
+      }
+      void set_frame_server_port(uint16_t port) { frame_server_.configure(port); }
+      void set_history_size(size_t size) { history_.configure(size); }
+      // Frames around a fault, diagnostic or BLOR kept in flash across reboots
+      void set_flight_recorder(uint8_t incidents, uint32_t min_interval) { recorder_.configure(incidents, min_interval); }
+
+      // Heating override controller
+      void set_heating_controller_type(HeatingControllerType type) { heating_controller_type_ = type; }
+      void set_heating_curve(float base_temperature, float slope, float min_water_temperature, float max_water_temperature)
+      {
+        heating_curve_.base_temperature = base_temperature;
+        heating_curve_.slope = slope;
+        heating_curve_.min_water_temperature = min_water_temperature;
+        heating_curve_.max_water_temperature = max_water_temperature;
+      }
+      void set_heating_pi_gains(float kp, float ki)
+      {
+        heating_kp_ = kp;
+        heating_ki_ = ki;
+      }
+
       // Sensor setters
       void set_external_temperature_sensor(sensor::Sensor *sensor) { external_temperature_sensor_ = sensor; }
       void set_return_temperature_sensor(sensor::Sensor *sensor) { return_temperature_sensor_ = sensor; }
@@ -57,6 +117,57 @@ namespace esphome
       void set_master_ot_version_sensor(sensor::Sensor *sensor) { master_ot_version_sensor_ = sensor; }
       void set_slave_ot_version_sensor(sensor::Sensor *sensor) { slave_ot_version_sensor_ = sensor; }
 
+      // Pass-through deadline diagnostics
+      void set_deadline_misses_sensor(sensor::Sensor *sensor) { deadline_misses_sensor_ = sensor; }
+      void set_max_response_time_sensor(sensor::Sensor *sensor) { max_response_time_sensor_ = sensor; }
+      void set_merged_writes_sensor(sensor::Sensor *sensor) { merged_writes_sensor_ = sensor; }
+      void set_observed_ids_sensor(sensor::Sensor *sensor) { observed_ids_sensor_ = sensor; }
+      void set_duplicate_frames_sensor(sensor::Sensor *sensor) { duplicate_frames_sensor_ = sensor; }
+      void set_changed_frames_sensor(sensor::Sensor *sensor) { changed_frames_sensor_ = sensor; }
+      // Freshness target per value; time out of target is summed over all values
+      void set_max_age(OpenThermMessageID id, uint32_t max_age) { cachedValueFor(id)->max_age = max_age; }
+      void set_out_of_target_sensor(sensor::Sensor *sensor) { out_of_target_sensor_ = sensor; }
+
+      // Never originate frames on the boiler bus: no discovery reads, polls, commands or overrides
+      void set_listen_only(bool listen_only) { listen_only_ = listen_only; }
+
+      // Derived sensor, bytecode compiled from its expression at code generation
+      void add_derived_sensor(sensor::Sensor *sensor, const uint8_t *code, size_t length) { expressions_.add(sensor, code, length); }
+
+      // Loop profiler, sensors report the max time per code path over each update interval
+      void set_profiler_enabled(bool enabled) { profiler_.set_enabled(enabled); }
+      void set_profile_sensor(ProfileSlot slot, sensor::Sensor *sensor) { profile_sensors_[static_cast<uint8_t>(slot)] = sensor; }
+
+      // Bus utilization meter; polls beyond the ceiling (0..1) are deferred
+      void set_bus_utilization_ceiling(float ceiling) { bus_ceiling_ = ceiling; }
+      void set_bus_utilization_sensor(sensor::Sensor *sensor) { bus_utilization_sensor_ = sensor; }
+      void set_pass_through_utilization_sensor(sensor::Sensor *sensor) { pass_through_utilization_sensor_ = sensor; }
+      void set_gateway_utilization_sensor(sensor::Sensor *sensor) { gateway_utilization_sensor_ = sensor; }
+      void set_thermostat_utilization_sensor(sensor::Sensor *sensor) { thermostat_utilization_sensor_ = sensor; }
+      void set_bus_headroom_sensor(sensor::Sensor *sensor) { bus_headroom_sensor_ = sensor; }
+      void set_deferred_polls_sensor(sensor::Sensor *sensor) { deferred_polls_sensor_ = sensor; }
+
+      // Bus health supervisor: a side failing for failure_streak frames in a row, or a
+      // thermostat silent for longer than silence, gets its OpenTherm instance and interrupt reinitialized
+      void set_bus_supervisor(uint8_t failure_streak, uint32_t silence) { bus_health_.configure(failure_streak, silence); }
+      void set_bus_recoveries_sensor(sensor::Sensor *sensor) { bus_recoveries_sensor_ = sensor; }
+      void set_mean_recovery_time_sensor(sensor::Sensor *sensor) { mean_recovery_time_sensor_ = sensor; }
+      void set_max_recovery_time_sensor(sensor::Sensor *sensor) { max_recovery_time_sensor_ = sensor; }
+
+      // Background sync of the TSP and fault history tables, batch entries every interval
+      void set_table_sync(bool tsp, bool fault_history, uint8_t batch, uint8_t sample, uint32_t interval)
+      {
+        table_sync_.configure(tsp, fault_history, batch, sample);
+        table_sync_interval_ = interval;
+      }
+      void set_table_sync_progress_sensor(sensor::Sensor *sensor) { table_sync_progress_sensor_ = sensor; }
+      void set_table_sync_frames_sensor(sensor::Sensor *sensor) { table_sync_frames_sensor_ = sensor; }
+
+      // Speculative prefetch of the thermostat's next READ
+      void set_prefetch(bool enabled) { prefetch_enabled_ = enabled; }
+      void set_prefetch_hit_rate_sensor(sensor::Sensor *sensor) { prefetch_hit_rate_sensor_ = sensor; }
+      void set_prefetch_latency_saved_sensor(sensor::Sensor *sensor) { prefetch_latency_saved_sensor_ = sensor; }
+
       // Binary sensor setters
       void set_flame_sensor(binary_sensor::BinarySensor *sensor) { flame_ = sensor; }
       void set_ch_active_sensor(binary_sensor::BinarySensor *sensor) { ch_active_ = sensor; }
@@ -83,6 +194,10 @@ namespace esphome
       // Boiler lockout reset (BLOR command)
       bool sendBoilerReset();
 
+      // Queue a user command, executed from loop() - a newer value for the same
+      // target replaces a pending one
+      void queueCommand(CommandType type, float value = NAN);
+
       // Process OpenTherm requests - needs to be static for the interrupt handler
       static void processRequest(unsigned long request, OpenThermResponseStatus status);
 
@@ -95,9 +210,47 @@ namespace esphome
       int slave_in_pin_{12};
       int slave_out_pin_{13};
 
-      // OpenTherm instances
+      // OpenTherm instances, constructed in setup() into storage owned by the component
       OpenTherm *ot_{nullptr};
       OpenTherm *slave_ot_{nullptr};
+      alignas(OpenTherm) uint8_t ot_storage_[sizeof(OpenTherm)];
+      alignas(OpenTherm) uint8_t slave_ot_storage_[sizeof(OpenTherm)];
+
+      // Deferred decoding: ISRs only timestamp edges, frames are decoded in batches from loop()
+      bool deferred_decoding_{false};
+      EdgeRingBuffer boiler_edges_;
+      EdgeRingBuffer thermostat_edges_;
+      ManchesterDecoder boiler_decoder_;
+      ManchesterDecoder thermostat_decoder_;
+      uint32_t last_decode_errors_{0};
+
+      // Timer-driven transmit: pass-through frames advance one step per loop() without blocking
+      enum class PassThroughState : uint8_t
+      {
+        IDLE,
+        BOILER_REQUEST,
+        BOILER_RESPONSE,
+        THERMOSTAT_RESPONSE
+      };
+
+      bool timer_transmit_{false};
+      FrameTransmitter transmitter_;
+      PassThroughState pass_through_state_{PassThroughState::IDLE};
+      unsigned long pass_through_request_{0};
+      unsigned long pass_through_modified_request_{0};
+      unsigned long pass_through_timestamp_{0};
+      const unsigned long RESPONSE_TIMEOUT_{800};  // Max slave response time per spec, in ms
+      static constexpr uint32_t OVERRIDE_TIMEOUT_ = 24UL * 60UL * 60UL * 1000UL;  // User overrides expire after 24 hours
+      static constexpr uint32_t STARTUP_GUARD_ = 30000;  // Setpoints from HA restoring state are ignored until 30 s uptime
+      static constexpr uint8_t FORCE_UPDATE_CYCLES_ = 20;  // DHW target follows QAA73 for the first 20 update intervals
+
+      // Every deadline of the component lives on one timer wheel, advanced at the
+      // top of loop(). Paths that run per frame only read the flags and armed
+      // states the timers leave behind.
+      MonotonicClock clock_;
+      TimerWheel timers_;
+      TimerWheel::Timer startup_guard_timer_;
+      TimerWheel::Timer dhw_sync_timer_;
 
       // Sensors
       sensor::Sensor *external_temperature_sensor_{nullptr};
@@ -117,6 +270,27 @@ namespace esphome
       sensor::Sensor *oem_diagnostic_code_sensor_{nullptr};
       sensor::Sensor *master_ot_version_sensor_{nullptr};
       sensor::Sensor *slave_ot_version_sensor_{nullptr};
+      sensor::Sensor *deadline_misses_sensor_{nullptr};
+      sensor::Sensor *max_response_time_sensor_{nullptr};
+      sensor::Sensor *merged_writes_sensor_{nullptr};
+      sensor::Sensor *observed_ids_sensor_{nullptr};
+      sensor::Sensor *duplicate_frames_sensor_{nullptr};
+      sensor::Sensor *changed_frames_sensor_{nullptr};
+      sensor::Sensor *out_of_target_sensor_{nullptr};
+      sensor::Sensor *profile_sensors_[static_cast<uint8_t>(ProfileSlot::COUNT)]{};
+      sensor::Sensor *bus_utilization_sensor_{nullptr};
+      sensor::Sensor *pass_through_utilization_sensor_{nullptr};
+      sensor::Sensor *gateway_utilization_sensor_{nullptr};
+      sensor::Sensor *thermostat_utilization_sensor_{nullptr};
+      sensor::Sensor *bus_headroom_sensor_{nullptr};
+      sensor::Sensor *deferred_polls_sensor_{nullptr};
+      sensor::Sensor *prefetch_hit_rate_sensor_{nullptr};
+      sensor::Sensor *bus_recoveries_sensor_{nullptr};
+      sensor::Sensor *mean_recovery_time_sensor_{nullptr};
+      sensor::Sensor *max_recovery_time_sensor_{nullptr};
+      sensor::Sensor *prefetch_latency_saved_sensor_{nullptr};
+      sensor::Sensor *table_sync_progress_sensor_{nullptr};
+      sensor::Sensor *table_sync_frames_sensor_{nullptr};
 
       // Binary Sensors
       binary_sensor::BinarySensor *flame_{nullptr};
@@ -132,20 +306,219 @@ namespace esphome
       // Last status response
       static unsigned long last_status_response_;
 
-      // Last intercepted response (set by processRequest, processed in loop)
-      static unsigned long last_intercepted_response_;
-      static OpenThermMessageID last_intercepted_id_;
-      static bool has_new_intercepted_response_;
+      // Pass-through deadline: last valid boiler reply per data ID for fallback answers.
+      // A fallback is only given for a READ with the same data-value, within FALLBACK_MAX_AGE_.
+      static const uint8_t MAX_TRACKED_ID = 128;
+      static const uint32_t FALLBACK_MAX_AGE_ = 120000; // 2 minutes in ms
+      struct FallbackReply
+      {
+        uint32_t response;     // 0 = none
+        uint32_t received_at;
+        uint16_t request_data; // data-value of the READ it answered
+      };
+      unsigned long pass_through_deadline_{0};
+      FallbackReply fallback_replies_[MAX_TRACKED_ID]{};
+      uint16_t deadline_misses_[MAX_TRACKED_ID]{};
+      uint32_t deadline_misses_total_{0};
+      uint32_t last_reported_deadline_misses_{0};
+      unsigned long last_response_time_{0};
+      unsigned long max_response_time_{0};
+      uint8_t max_response_time_id_{0};
+
+      // Listen-only mode and per-ID observation of intercepted frames
+      bool listen_only_{false};
+      uint32_t observed_at_[MAX_TRACKED_ID]{};
+      uint8_t observed_count_{0};
+      uint8_t last_reported_observed_{0};
+      uint32_t last_coverage_report_{0};
+      void observeFrame(unsigned long response, OpenThermMessageID id, uint32_t now);
+      void reportCoverage();
+
+      // Change detection: repeated frames only refresh their cache timestamp,
+      // update() republishes entities whose data IDs changed since the last run
+      FrameTracker frame_tracker_;
+      uint32_t published_epoch_{0};
+      uint32_t last_reported_frame_changes_{0};
+      bool changedSincePublish(OpenThermMessageID id) const;
+      void reportFrameChanges();
+
+      // Bus occupancy and admission control of gateway polls
+      BusMeter bus_meter_;
+      float bus_ceiling_{1.0f};
+      uint32_t deferred_polls_{0};
+      uint32_t last_reported_deferred_polls_{0};
+      bool admitPoll(OpenThermMessageID msg_id);
+      void reportBusUtilization();
+
+      // Bus health: invalid/missing frame streaks per side, reinitialization of the failed side
+      BusHealth bus_health_;
+      uint32_t last_health_check_{0};
+      uint32_t last_reported_bus_failures_{0};
+      uint32_t last_reported_recoveries_{0};
+      bool boiler_probe_pending_{false}; // one poll may go out after each boiler side reset
+      static const uint32_t HEALTH_CHECK_INTERVAL_ = 1000;
+      static bool isFrame(unsigned long frame) { return frame != 0 && !OpenTherm::parity(frame); }
+      void superviseBus();
+      bool resetBoilerSide();
+      bool resetThermostatSide();
+      void reportBusHealth();
+
+      // Speculative prefetch: the predicted next READ is fetched in the idle gap
+      // after an exchange and answered locally if the thermostat sends exactly it
+      struct Prefetch
+      {
+        uint32_t request;
+        uint32_t response;
+        uint32_t fetched_at;
+        uint32_t exchange_ms; // boiler round trip the thermostat is spared on a hit
+        uint32_t sequence;    // predictor sequence the prefetch was made for
+        bool valid;
+      };
+      bool prefetch_enabled_{false};
+      SequencePredictor predictor_;
+      Prefetch prefetch_{};
+      uint32_t prefetch_issued_{0};
+      uint32_t prefetch_deferred_{0}; // predictions the bus ceiling or a failed boiler side held back
+      uint32_t prefetch_hits_{0};
+      uint32_t prefetch_misses_{0};
+      uint32_t prefetch_saved_ms_{0};
+      uint32_t last_reported_prefetch_issued_{0};
+      uint32_t last_reported_prefetch_deferred_{0};
+      static const uint32_t PREFETCH_MAX_AGE_ = 1500; // Older prefetched replies are never used
+      static const uint32_t PREFETCH_MARGIN_ = 100;   // Slack before the thermostat's next request is due
+      void runPrefetch();
+      bool takePrefetched(unsigned long request, unsigned long modified_request, unsigned long &response);
+      void reportPrefetch();
+
+      // Trace spans of user commands, from the climate call to the boiler's reply
+      CommandTracer tracer_;
+      uint16_t pending_trace_[static_cast<uint8_t>(CommandType::COUNT)]{};
+      uint16_t active_trace_{0};           // command being executed by processNextCommand()
+      uint16_t dhw_override_trace_{0};     // command that activated the DHW override
+      uint16_t heating_override_trace_{0}; // command that activated the heating override
+      bool dhw_rewrite_traced_{false};
+      bool heating_rewrite_traced_{false};
+      uint16_t traceBegin(CommandType type, float value);
+      void trace(uint16_t command, SpanEvent event, float value = NAN);
+
+      // Allocations counted by the optional allocation guard
+      uint32_t last_reported_allocations_{0};
+      void reportAllocations();
+
+      // User commands (setpoints, BLOR) waiting for the bus
+      CommandQueue commands_;
+      // Climate target temperature callbacks
+      static bool queueDhwSetpoint(void *context, float temperature);
+      static bool queueRoomSetpoint(void *context, float temperature);
+      uint32_t last_reported_merged_writes_{0};
+      bool processNextCommand();
+      void processCommands();
+
+      // Optional UDP telemetry stream fed from processCachedResponse()
+      TelemetryStream telemetry_;
+
+      // Derived sensors, re-evaluated when one of their input data IDs changes
+      ExpressionEngine expressions_;
+
+      // Optional timing of the component's code paths
+      LoopProfiler profiler_;
+      uint32_t profile_window_start_{0};
+      void reportProfile();
+
+      // Optional OTGW-format TCP stream of all bus frames
+      FrameServer frame_server_;
+      uint32_t last_reported_frame_drops_{0};
+
+      // Optional compressed history of key data IDs, exported over the web server
+      HistoryBuffer history_;
+
+      // Optional flight recorder, fed from processCachedResponse()
+      FlightRecorder recorder_;
+      uint8_t last_fault_flags_{0xFF}; // fault (bit 0) and diagnostic (bit 1) of the last Status, 0xFF = unknown
+
+      // Optional table sync, a few boiler READs per step from loop(), steps paced by the timer
+      TableSync table_sync_;
+      uint32_t table_sync_interval_{0};
+      TimerWheel::Timer table_sync_timer_;
+      void runTableSync();
+      void reportTableSync();
+#ifdef USE_WEBSERVER
+      HistoryExportHandler history_export_{&history_};
+      // Stored incidents at /opentherm/incidents
+      IncidentExportHandler incident_export_{&recorder_};
+      // Synced tables at /opentherm/tables
+      TableExportHandler table_export_{&table_sync_};
+      // Command trace spans at /opentherm/trace
+      TraceExportHandler trace_export_{&tracer_};
+      // Whole gateway state as JSON at /opentherm/snapshot
+      SnapshotHandler snapshot_handler_{captureSnapshot, this};
+#endif
+      static void captureSnapshot(void *context, GatewaySnapshot &snapshot);
+
+      // Intercepted frames (queued by the pass-through path, processed in loop)
+      FrameQueue intercepted_frames_;
+      uint32_t last_dropped_frames_{0};
+
+      // Dedicated bus task (ESP32 only)
+      class BusLock;
+      bool bus_task_{false};
+#ifdef USE_ESP32
+      static const uint32_t BUS_TASK_STACK_SIZE = 4096;
+      static const UBaseType_t BUS_TASK_PRIORITY = 5;
+      static const BaseType_t BUS_TASK_CORE = 1;
+      SemaphoreHandle_t bus_mutex_{nullptr};
+      TaskHandle_t bus_task_handle_{nullptr};
+      void startBusTask();
+      static void busTask(void *arg);
+#endif
+
+      // Override and controller state below is shared with pass-through in the bus
+      // task; loop() and update() touch it under BusLock only.
 
       // User override for DHW temperature (to block QAA73 commands)
       bool user_dhw_override_active_{false};
       float user_dhw_setpoint_{40.0f};
-      unsigned long dhw_override_timestamp_{0};
+      TimerWheel::Timer dhw_override_timer_{expireDhwOverride, this};
+      static void expireDhwOverride(void *context);
+
+      // User override for room temperature (drives TSet/TrSet rewriting in processRequest)
+      bool user_heating_override_active_{false};
+      float user_heating_setpoint_{20.0f};
+      TimerWheel::Timer heating_override_timer_{expireHeatingOverride, this};
+      static void expireHeatingOverride(void *context);
+
+      // Controller choosing TSet while the heating override is active
+      HeatingControllerType heating_controller_type_{HeatingControllerType::PI};
+      HeatingCurve heating_curve_;
+      float heating_kp_{8.0f};
+      float heating_ki_{2.0f};
+      HysteresisController hysteresis_controller_;
+      WeatherPIController pi_controller_;
+      HeatingController *heating_controller_{&pi_controller_};
+      bool last_flame_on_{false};
+      uint32_t override_burner_starts_{0};
+
+      // Where a cached value last came from
+      enum class ValueSource : uint8_t
+      {
+        NONE,    // never received
+        SNIFFED, // intercepted thermostat/boiler exchange
+        POLLED,  // the gateway's own READ
+      };
+      static const char *valueSourceName(ValueSource source);
 
       // Cached sensor values with timestamps (value updated by processRequest or explicit poll)
       struct CachedValue {
         float value{NAN};
-        unsigned long last_update{0};
+        unsigned long received_at{0};  // last time the value itself arrived, 0 = never
+        TimerWheel::Timer poll_timer;  // armed after a receive or fetch attempt, polled again once it ran out
+        TimerWheel::Timer freshness_timer;  // armed for max_age after a receive, out of target once it ran out
+        ValueSource source{ValueSource::NONE};
+        // Freshness target: older values are published as unavailable
+        uint32_t max_age{0};           // 0 = no target
+        bool stale{false};             // freshness timer ran out, as of the last update()
+        bool stale_changed{false};     // stale flipped at the last update()
+        uint32_t stale_ms{0};          // total time out of target
       };
 
       CachedValue cached_external_temp_;
@@ -159,11 +532,26 @@ namespace esphome
       CachedValue cached_room_temp_;
       CachedValue cached_room_setpoint_;
 
-      const unsigned long CACHE_TIMEOUT_{60000};  // 1 minute in ms
-      const unsigned long MIN_FETCH_INTERVAL_{5000};  // Minimum 5s between fetch requests for same sensor
+      const uint32_t CACHE_TIMEOUT_{60000};  // 1 minute in ms
+      const uint32_t MIN_FETCH_INTERVAL_{5000};  // Minimum 5s between fetch requests for same sensor
 
       // Helper to get cached value or fetch if stale
       float getCachedOrFetch(CachedValue &cache, OpenThermMessageID msg_id);
+      // Stamps a value that just arrived and rearms its poll and freshness timers
+      void markReceived(CachedValue &cache, ValueSource source, uint32_t now);
+      // Freshness of every cached value, checked once per update()
+      uint32_t last_freshness_check_{0};
+      uint32_t last_reported_stale_s_{0};
+      void checkFreshness();
+      // Publishes a cached value when it changed or came back in target, NAN when it left it
+      void publishCachedValue(sensor::Sensor *sensor, const CachedValue &cache, OpenThermMessageID id);
+      // Cache entry filled from a data ID, nullptr for IDs that are not cached
+      CachedValue *cachedValueFor(OpenThermMessageID id);
+
+      // Pass-through steps: rewrite the thermostat request for active overrides,
+      // then record the exchanged frames for caching and status
+      unsigned long applyOverrides(unsigned long request);
+      void recordInterceptedFrame(unsigned long request, unsigned long modified_request, unsigned long response);
 
       // Process intercepted response (called from loop, not interrupt)
       void processCachedResponse(unsigned long response, OpenThermMessageID id);
@@ -176,9 +564,30 @@ namespace esphome
           OpenthermClimate *climate,
           const char *name);
 
+      // Bus access - routed through the library or the deferred decoding path.
+      // Gateway-originated exchanges are reported to the frame server as R/B lines.
+      unsigned long sendBoilerRequest(unsigned long request, unsigned long timeout = 0, bool pass_through = false);
+      unsigned long exchangeBoilerFrame(unsigned long request, unsigned long timeout);
+      // Reports a forwarded thermostat exchange to the frame server as T/R/B/A lines
+      void recordPassThrough(unsigned long request, unsigned long modified_request, unsigned long response,
+                             unsigned long thermostat_response);
+      // Keeps the last valid reply and the response time watermark, and substitutes a
+      // cached or DATA-INVALID reply when no well-formed boiler reply came in time. A prompt
+      // DATA-INVALID or UNKNOWN-DATAID is forwarded as is. Prefetch hits go through it as
+      // well; they leave last_response_time_ at 0
+      unsigned long checkPassThroughResponse(unsigned long request, unsigned long response);
+      void sendThermostatResponse(unsigned long response);
+      void transmit(int out_pin, unsigned long frame);
+      void transmitFrame(int out_pin, unsigned long frame);
+      bool runPassThrough();
+      void processThermostatBus();
+      void logDecoderStats();
+
       // Interrupt handlers
       static void IRAM_ATTR handleInterrupt();
       static void IRAM_ATTR slaveHandleInterrupt();
+      static void IRAM_ATTR handleEdgeInterrupt();
+      static void IRAM_ATTR slaveHandleEdgeInterrupt();
     };
 
   } // namespace opentherm
@@ -0,0 +1,135 @@
+#include "opentherm_edge_decoder.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const uint32_t HALF_BIT_MIN_US = OT_BIT_MIN_US / 2 - OT_EDGE_JITTER_US;
+    static const uint32_t HALF_BIT_MAX_US = OT_BIT_MAX_US / 2 + OT_EDGE_JITTER_US;
+    static const uint32_t BIT_MIN_US = OT_BIT_MIN_US - OT_EDGE_JITTER_US;
+    static const uint32_t BIT_MAX_US = OT_BIT_MAX_US + OT_EDGE_JITTER_US;
+
+    bool EdgeRingBuffer::pop(uint32_t &timestamp_us, bool &level)
+    {
+      uint16_t tail = tail_;
+      if (tail == head_)
+        return false;
+
+      uint32_t entry = entries_[tail];
+      tail_ = (tail + 1) & (SIZE - 1);
+
+      timestamp_us = entry & ~1UL;
+      level = (entry & 1UL) != 0;
+      return true;
+    }
+
+    void ManchesterDecoder::restart(uint32_t timestamp_us, bool level)
+    {
+      // A rising edge after a broken frame may already be the next start bit
+      state_ = level ? State::START_BIT : State::IDLE;
+      last_edge_us_ = timestamp_us;
+      level_ = level;
+    }
+
+    bool ManchesterDecoder::feed(uint32_t timestamp_us, bool level, uint32_t &frame)
+    {
+      switch (state_)
+      {
+        case State::IDLE:
+          // Start bit is a '1' - line goes active (HIGH on adapter input) for the first half
+          restart(timestamp_us, level);
+          return false;
+
+        case State::START_BIT:
+        {
+          uint32_t dt = timestamp_us - last_edge_us_;
+          if (!level && dt >= HALF_BIT_MIN_US && dt <= HALF_BIT_MAX_US)
+          {
+            state_ = State::DATA;
+            last_mid_us_ = timestamp_us;
+            level_ = level;
+            frame_ = 0;
+            bit_count_ = 0;
+            return false;
+          }
+          timing_errors_++;
+          restart(timestamp_us, level);
+          return false;
+        }
+
+        case State::DATA:
+        {
+          // Levels must alternate - same level twice means a missed edge or a glitch
+          if (level == level_)
+          {
+            timing_errors_++;
+            restart(timestamp_us, level);
+            return false;
+          }
+          level_ = level;
+
+          uint32_t dt = timestamp_us - last_mid_us_;
+          if (dt < OT_MID_BIT_THRESHOLD_US)
+          {
+            // Bit boundary edge (between two equal bits), only timing to check
+            if (dt < HALF_BIT_MIN_US || dt > HALF_BIT_MAX_US)
+            {
+              timing_errors_++;
+              restart(timestamp_us, level);
+            }
+            return false;
+          }
+
+          if (dt < BIT_MIN_US || dt > BIT_MAX_US)
+          {
+            timing_errors_++;
+            restart(timestamp_us, level);
+            return false;
+          }
+          last_mid_us_ = timestamp_us;
+
+          // After the mid-bit transition the line is idle for a '1' and active for a '0'
+          bool bit = !level;
+          if (bit_count_ < 32)
+          {
+            frame_ = (frame_ << 1) | (bit ? 1UL : 0UL);
+            bit_count_++;
+            return false;
+          }
+
+          // 33rd mid-bit transition is the stop bit, which must be a '1'
+          state_ = State::IDLE;
+          if (!bit)
+          {
+            timing_errors_++;
+            return false;
+          }
+          // Bit 31 is chosen so the whole frame has even parity
+          if (__builtin_parity(frame_))
+          {
+            parity_errors_++;
+            return false;
+          }
+          frames_++;
+          frame = frame_;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool ManchesterDecoder::poll(EdgeRingBuffer &edges, uint32_t &frame)
+    {
+      uint32_t timestamp_us;
+      bool level;
+      while (edges.pop(timestamp_us, level))
+      {
+        if (feed(timestamp_us, level, frame))
+          return true;
+      }
+      return false;
+    }
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/hal.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // OpenTherm physical layer timing (Protocol v2.2, section 4.3.1).
+    // Bit period is 1 ms nominal (900..1150 us), every bit has a mid-bit transition.
+    static const uint32_t OT_BIT_MIN_US = 900;
+    static const uint32_t OT_BIT_MAX_US = 1150;
+    // Extra tolerance for interrupt latency (WiFi/flash activity on ESP8266)
+    static const uint32_t OT_EDGE_JITTER_US = 100;
+    // Edges closer than 3/4 bit to the last mid-bit transition are bit-boundary edges
+    static const uint32_t OT_MID_BIT_THRESHOLD_US = 750;
+
+    // Lock-free single-producer/single-consumer ring of line edges.
+    // The producer is the pin interrupt (timestamp only), the consumer is loop().
+    class EdgeRingBuffer
+    {
+    public:
+      // Power of two, holds roughly two complete frames (max 68 edges each)
+      static const uint16_t SIZE = 128;
+
+      // Called from interrupt context. Line level is packed into bit 0 of the timestamp.
+      inline void IRAM_ATTR push(uint32_t timestamp_us, bool level)
+      {
+        uint16_t head = head_;
+        uint16_t next = (head + 1) & (SIZE - 1);
+        if (next == tail_)
+        {
+          overflows_++;
+          return;
+        }
+        entries_[head] = (timestamp_us & ~1UL) | (level ? 1UL : 0UL);
+        head_ = next;
+      }
+
+      bool pop(uint32_t &timestamp_us, bool &level);
+
+      // Discard everything captured so far (consumer side only)
+      void clear() { tail_ = head_; }
+
+      uint32_t get_overflows() const { return overflows_; }
+
+    protected:
+      volatile uint32_t entries_[SIZE];
+      volatile uint16_t head_{0};
+      volatile uint16_t tail_{0};
+      volatile uint32_t overflows_{0};
+    };
+
+    // Manchester frame decoder working on recorded edge timestamps instead of
+    // live pin reads. Validates half-bit/bit timing, stop bit and even parity.
+    class ManchesterDecoder
+    {
+    public:
+      // Feed a single edge, returns true when a complete valid frame was decoded
+      bool feed(uint32_t timestamp_us, bool level, uint32_t &frame);
+
+      // Drain pending edges from the ring in one batch, stops at the first complete frame
+      bool poll(EdgeRingBuffer &edges, uint32_t &frame);
+
+      void reset() { state_ = State::IDLE; }
+
+      uint32_t get_frames() const { return frames_; }
+      uint32_t get_timing_errors() const { return timing_errors_; }
+      uint32_t get_parity_errors() const { return parity_errors_; }
+
+    protected:
+      enum class State : uint8_t
+      {
+        IDLE,
+        START_BIT,
+        DATA
+      };
+
+      void restart(uint32_t timestamp_us, bool level);
+
+      State state_{State::IDLE};
+      uint32_t last_edge_us_{0};
+      uint32_t last_mid_us_{0};
+      uint32_t frame_{0};
+      uint8_t bit_count_{0};
+      bool level_{false};
+
+      uint32_t frames_{0};
+      uint32_t timing_errors_{0};
+      uint32_t parity_errors_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
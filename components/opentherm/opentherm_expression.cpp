@@ -0,0 +1,174 @@
+#include "opentherm_expression.h"
+#include "esphome/core/log.h"
+#include <cmath>
+#include <cstring>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.expression";
+
+    static inline size_t operand_size(uint8_t op)
+    {
+      if (op == OP_CONST)
+        return 4;
+      if (op >= OP_LOAD_F88 && op <= OP_LOAD_LB)
+        return 1;
+      return 0;
+    }
+
+    int ExpressionEngine::find_input(uint8_t id) const
+    {
+      for (uint8_t i = 0; i < input_count_; i++)
+      {
+        if (input_ids_[i] == id)
+          return i;
+      }
+      return -1;
+    }
+
+    bool ExpressionEngine::add(sensor::Sensor *sensor, const uint8_t *code, size_t length)
+    {
+      if (expression_count_ == MAX_EXPRESSIONS || length > 0xFF)
+      {
+        ESP_LOGE(TAG, "Too many derived sensors");
+        return false;
+      }
+
+      uint16_t inputs = 0;
+      for (size_t pc = 0; pc < length; pc += 1 + operand_size(code[pc]))
+      {
+        if (code[pc] < OP_LOAD_F88 || code[pc] > OP_LOAD_LB)
+          continue;
+
+        uint8_t id = code[pc + 1];
+        int slot = find_input(id);
+        if (slot < 0)
+        {
+          if (input_count_ == MAX_INPUTS)
+          {
+            ESP_LOGE(TAG, "Derived sensors read more than %u data IDs", MAX_INPUTS);
+            return false;
+          }
+          slot = input_count_++;
+          input_ids_[slot] = id;
+        }
+        inputs |= 1 << slot;
+      }
+
+      expressions_[expression_count_++] = Expression{sensor, code, static_cast<uint8_t>(length), inputs};
+      return true;
+    }
+
+    void ExpressionEngine::on_value(uint8_t id, uint16_t value)
+    {
+      int slot = find_input(id);
+      if (slot < 0)
+        return;
+
+      uint16_t bit = 1 << slot;
+      if ((input_valid_ & bit) && input_values_[slot] == value)
+        return;
+      input_values_[slot] = value;
+      input_valid_ |= bit;
+
+      for (uint8_t i = 0; i < expression_count_; i++)
+      {
+        const Expression &expression = expressions_[i];
+        // Publish once every input has been seen at least once
+        if ((expression.inputs & bit) == 0 || (expression.inputs & input_valid_) != expression.inputs)
+          continue;
+
+        float result = evaluate(expression);
+        if (!std::isnan(result))
+          expression.sensor->publish_state(result);
+      }
+    }
+
+    float ExpressionEngine::evaluate(const Expression &expression) const
+    {
+      float stack[MAX_STACK];
+      uint8_t sp = 0;
+      const uint8_t *code = expression.code;
+
+      for (uint8_t pc = 0; pc < expression.length;)
+      {
+        uint8_t op = code[pc++];
+        if (op == OP_CONST)
+        {
+          if (sp == MAX_STACK)
+            return NAN;
+          memcpy(&stack[sp++], code + pc, sizeof(float));
+          pc += 4;
+          continue;
+        }
+
+        if (op >= OP_LOAD_F88 && op <= OP_LOAD_LB)
+        {
+          if (sp == MAX_STACK)
+            return NAN;
+          uint16_t raw = input_values_[find_input(code[pc++])];
+          switch (op)
+          {
+            case OP_LOAD_F88:
+              stack[sp++] = static_cast<int16_t>(raw) / 256.0f;
+              break;
+            case OP_LOAD_U16:
+              stack[sp++] = raw;
+              break;
+            case OP_LOAD_HB:
+              stack[sp++] = raw >> 8;
+              break;
+            default:
+              stack[sp++] = raw & 0xFF;
+              break;
+          }
+          continue;
+        }
+
+        if (op == OP_NEG || op == OP_ABS)
+        {
+          if (sp < 1)
+            return NAN;
+          stack[sp - 1] = op == OP_NEG ? -stack[sp - 1] : std::fabs(stack[sp - 1]);
+          continue;
+        }
+
+        if (sp < 2)
+          return NAN;
+        float b = stack[--sp];
+        float &a = stack[sp - 1];
+        switch (op)
+        {
+          case OP_ADD:
+            a += b;
+            break;
+          case OP_SUB:
+            a -= b;
+            break;
+          case OP_MUL:
+            a *= b;
+            break;
+          case OP_DIV:
+            if (b == 0.0f)
+              return NAN;
+            a /= b;
+            break;
+          case OP_MIN:
+            a = a < b ? a : b;
+            break;
+          case OP_MAX:
+            a = a > b ? a : b;
+            break;
+          default:
+            return NAN;
+        }
+      }
+
+      return sp == 1 ? stack[0] : NAN;
+    }
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "esphome/components/sensor/sensor.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Bytecode of derived-sensor expressions, compiled by the Python code generator.
+    // A stack machine over floats; loads take the data ID as operand.
+    enum ExpressionOp : uint8_t
+    {
+      OP_CONST = 0x01,    // f32 little-endian operand
+      OP_LOAD_F88 = 0x02, // data ID operand, signed f8.8 value
+      OP_LOAD_U16 = 0x03, // data ID operand, raw 16-bit value
+      OP_LOAD_HB = 0x04,  // data ID operand, high byte
+      OP_LOAD_LB = 0x05,  // data ID operand, low byte
+      OP_ADD = 0x10,
+      OP_SUB = 0x11,
+      OP_MUL = 0x12,
+      OP_DIV = 0x13,
+      OP_NEG = 0x14,
+      OP_MIN = 0x15,
+      OP_MAX = 0x16,
+      OP_ABS = 0x17,
+    };
+
+    // Evaluates derived sensors when one of their input data IDs changes.
+    // Inputs and expressions live in fixed tables, nothing is allocated.
+    class ExpressionEngine
+    {
+    public:
+      static const uint8_t MAX_INPUTS = 16;
+      static const uint8_t MAX_EXPRESSIONS = 8;
+      static const uint8_t MAX_STACK = 8;
+
+      // Registers the inputs used by the bytecode, returns false if a table is full
+      bool add(sensor::Sensor *sensor, const uint8_t *code, size_t length);
+      bool empty() const { return expression_count_ == 0; }
+
+      // New value for a data ID, re-evaluates the expressions that read it
+      void on_value(uint8_t id, uint16_t value);
+
+    protected:
+      struct Expression
+      {
+        sensor::Sensor *sensor;
+        const uint8_t *code;
+        uint8_t length;
+        uint16_t inputs; // bit mask of input slots
+      };
+
+      int find_input(uint8_t id) const;
+      float evaluate(const Expression &expression) const;
+
+      uint8_t input_ids_[MAX_INPUTS]{};
+      uint16_t input_values_[MAX_INPUTS]{};
+      uint16_t input_valid_{0};
+      uint8_t input_count_{0};
+
+      Expression expressions_[MAX_EXPRESSIONS]{};
+      uint8_t expression_count_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
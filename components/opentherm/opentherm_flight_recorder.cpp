@@ -0,0 +1,169 @@
+#include "opentherm_flight_recorder.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.recorder";
+
+    // Preference hash of slot 0, slot N uses PREFERENCE_HASH + N
+    static const uint32_t PREFERENCE_HASH = 0x4F544652; // "OTFR"
+
+    static uint16_t saturate(uint32_t ms) { return ms > UINT16_MAX ? UINT16_MAX : ms; }
+
+    const char *incident_trigger_name(IncidentTrigger trigger)
+    {
+      switch (trigger)
+      {
+      case IncidentTrigger::FAULT:
+        return "fault";
+      case IncidentTrigger::DIAGNOSTIC:
+        return "diagnostic";
+      case IncidentTrigger::BOILER_RESET:
+        return "boiler_reset";
+      }
+      return "unknown";
+    }
+
+    void FlightRecorder::setup()
+    {
+      for (uint8_t i = 0; i < incidents_; i++)
+      {
+        slots_[i] = global_preferences->make_preference<Incident>(PREFERENCE_HASH + i, true);
+
+        Incident incident;
+        if (!load(i, incident))
+          continue;
+        if (incident.sequence >= next_sequence_)
+          next_sequence_ = incident.sequence + 1;
+        ESP_LOGI(TAG, "Stored incident #%u: %s at %u s uptime, status 0x%04X, %u frames (%u before)",
+                 static_cast<unsigned>(incident.sequence),
+                 incident_trigger_name(static_cast<IncidentTrigger>(incident.trigger)),
+                 static_cast<unsigned>(incident.uptime_ms / 1000), incident.status, incident.count,
+                 incident.pre_count);
+      }
+    }
+
+    void FlightRecorder::loop(uint32_t now)
+    {
+      if (capturing_ && now - capture_started_ >= TAIL_TIMEOUT_MS)
+        save(now);
+    }
+
+    void FlightRecorder::add(uint32_t frame, uint32_t now)
+    {
+      if (!is_configured())
+        return;
+
+      window_frames_[window_count_ % PRE_FRAMES] = frame;
+      window_times_[window_count_ % PRE_FRAMES] = now;
+      window_count_++;
+
+      if (!capturing_)
+        return;
+      capture_.frames[capture_.count] = frame;
+      capture_.offsets_ms[capture_.count] = saturate(now - capture_started_);
+      capture_.count++;
+      if (capture_.count == FRAMES)
+        save(now);
+    }
+
+    bool FlightRecorder::trigger(IncidentTrigger trigger, uint16_t status, uint32_t now)
+    {
+      if (!is_configured())
+        return false;
+      if (capturing_)
+      {
+        ESP_LOGD(TAG, "%s joins incident #%u", incident_trigger_name(trigger),
+                 static_cast<unsigned>(capture_.sequence));
+        return false;
+      }
+      if (saved_this_boot_ && now - last_saved_at_ < min_interval_)
+      {
+        suppressed_++;
+        ESP_LOGW(TAG, "%s not recorded, last incident saved %u s ago", incident_trigger_name(trigger),
+                 static_cast<unsigned>((now - last_saved_at_) / 1000));
+        return false;
+      }
+
+      capture_ = Incident{};
+      capture_.sequence = next_sequence_++;
+      capture_.uptime_ms = now;
+      capture_.status = status;
+      capture_.trigger = static_cast<uint8_t>(trigger);
+
+      // Freeze the window, oldest frame first
+      uint32_t count = window_count_ < PRE_FRAMES ? window_count_ : PRE_FRAMES;
+      for (uint32_t i = window_count_ - count; i < window_count_; i++)
+      {
+        capture_.frames[capture_.count] = window_frames_[i % PRE_FRAMES];
+        capture_.offsets_ms[capture_.count] = saturate(now - window_times_[i % PRE_FRAMES]);
+        capture_.count++;
+      }
+      capture_.pre_count = capture_.count;
+
+      capturing_ = true;
+      capture_started_ = now;
+      ESP_LOGW(TAG, "Incident #%u: %s, status 0x%04X, recording %u frames after it",
+               static_cast<unsigned>(capture_.sequence), incident_trigger_name(trigger), status, POST_FRAMES);
+      return true;
+    }
+
+    void FlightRecorder::save(uint32_t now)
+    {
+      capturing_ = false;
+      uint8_t slot = capture_.sequence % incidents_;
+      if (!slots_[slot].save(&capture_) || !global_preferences->sync())
+      {
+        ESP_LOGE(TAG, "Could not save incident #%u", static_cast<unsigned>(capture_.sequence));
+        return;
+      }
+      saved_++;
+      saved_this_boot_ = true;
+      last_saved_at_ = now;
+      ESP_LOGI(TAG, "Incident #%u saved to slot %u, %u frames", static_cast<unsigned>(capture_.sequence), slot,
+               capture_.count);
+    }
+
+    bool FlightRecorder::load(uint8_t slot, Incident &incident)
+    {
+      if (slot >= incidents_ || !slots_[slot].load(&incident))
+        return false;
+      return incident.sequence != 0 && incident.count <= FRAMES && incident.pre_count <= incident.count;
+    }
+
+#ifdef USE_WEBSERVER
+    bool IncidentExportHandler::canHandle(AsyncWebServerRequest *request)
+    {
+      return request->method() == HTTP_GET && request->url() == "/opentherm/incidents";
+    }
+
+    void IncidentExportHandler::handleRequest(AsyncWebServerRequest *request)
+    {
+      AsyncResponseStream *stream = request->beginResponseStream("text/csv");
+      stream->printf("# saved=%u suppressed=%u\n", static_cast<unsigned>(recorder_->get_saved()),
+                     static_cast<unsigned>(recorder_->get_suppressed()));
+      stream->print("incident,trigger,uptime_ms,status,offset_ms,frame\n");
+      for (uint8_t slot = 0; slot < recorder_->get_incidents(); slot++)
+      {
+        if (!recorder_->load(slot, incident_))
+          continue;
+        const char *trigger = incident_trigger_name(static_cast<IncidentTrigger>(incident_.trigger));
+        for (uint8_t i = 0; i < incident_.count; i++)
+        {
+          // Frames before the trigger get negative offsets
+          long offset = i < incident_.pre_count ? -static_cast<long>(incident_.offsets_ms[i]) : incident_.offsets_ms[i];
+          stream->printf("%u,%s,%u,%04X,%ld,%08X\n", static_cast<unsigned>(incident_.sequence), trigger,
+                         static_cast<unsigned>(incident_.uptime_ms), incident_.status, offset,
+                         static_cast<unsigned>(incident_.frames[i]));
+        }
+      }
+      request->send(stream);
+    }
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
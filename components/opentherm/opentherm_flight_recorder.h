@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "esphome/core/preferences.h"
+
+#ifdef USE_WEBSERVER
+#include "esphome/components/web_server_base/web_server_base.h"
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    enum class IncidentTrigger : uint8_t
+    {
+      FAULT,        // Status fault bit went high
+      DIAGNOSTIC,   // Status diagnostic bit went high
+      BOILER_RESET, // BLOR sent by sendBoilerReset()
+    };
+
+    const char *incident_trigger_name(IncidentTrigger trigger);
+
+    // Keeps the last PRE_FRAMES decoded frames in RAM. A trigger freezes them,
+    // collects POST_FRAMES more as a tail and saves the incident to flash in one
+    // of a few rotating preference slots. Saves closer than the minimum interval
+    // are dropped to bound flash wear. Fed from loop() only, never from the
+    // pass-through path.
+    class FlightRecorder
+    {
+    public:
+      static const uint8_t PRE_FRAMES = 24;
+      static const uint8_t POST_FRAMES = 8;
+      static const uint8_t FRAMES = PRE_FRAMES + POST_FRAMES;
+      static const uint8_t MAX_INCIDENTS = 4;
+      static const uint32_t TAIL_TIMEOUT_MS = 30000; // Saved with a short tail if the bus goes quiet
+
+      // Stored as is, 208 bytes per slot
+      struct Incident
+      {
+        uint32_t sequence;  // increases across reboots, 0 = empty slot
+        uint32_t uptime_ms; // at the trigger
+        uint16_t status;    // Status data-value at the trigger
+        uint8_t trigger;    // IncidentTrigger
+        uint8_t pre_count;  // frames before the trigger
+        uint8_t count;
+        uint8_t reserved[3];
+        uint32_t frames[FRAMES];
+        // Distance from the trigger, before it for the first pre_count frames
+        // and after it for the rest, saturated at 65535
+        uint16_t offsets_ms[FRAMES];
+      };
+
+      void configure(uint8_t incidents, uint32_t min_interval)
+      {
+        incidents_ = incidents < MAX_INCIDENTS ? incidents : MAX_INCIDENTS;
+        min_interval_ = min_interval;
+      }
+      bool is_configured() const { return incidents_ != 0; }
+
+      // Loads the stored incidents and logs a summary of each
+      void setup();
+      void loop(uint32_t now);
+
+      void add(uint32_t frame, uint32_t now);
+      // Returns false if the trigger joined a capture in progress or was rate limited
+      bool trigger(IncidentTrigger trigger, uint16_t status, uint32_t now);
+      bool is_capturing() const { return capturing_; }
+
+      uint8_t get_incidents() const { return incidents_; }
+      uint32_t get_saved() const { return saved_; }
+      uint32_t get_suppressed() const { return suppressed_; }
+      // Reads a slot back from flash, false if it is empty
+      bool load(uint8_t slot, Incident &incident);
+
+    protected:
+      void save(uint32_t now);
+
+      uint8_t incidents_{0};
+      uint32_t min_interval_{0};
+      ESPPreferenceObject slots_[MAX_INCIDENTS];
+
+      // RAM window of the most recent frames
+      uint32_t window_frames_[PRE_FRAMES]{};
+      uint32_t window_times_[PRE_FRAMES]{};
+      uint32_t window_count_{0};
+
+      Incident capture_{};
+      bool capturing_{false};
+      uint32_t capture_started_{0};
+      uint32_t next_sequence_{1};
+      uint32_t last_saved_at_{0};
+      bool saved_this_boot_{false};
+      uint32_t saved_{0};
+      uint32_t suppressed_{0};
+    };
+
+#ifdef USE_WEBSERVER
+    // GET /opentherm/incidents - stored incidents as CSV, one line per frame
+    class IncidentExportHandler : public AsyncWebHandler
+    {
+    public:
+      explicit IncidentExportHandler(FlightRecorder *recorder) : recorder_(recorder) {}
+
+      bool canHandle(AsyncWebServerRequest *request) override;
+      void handleRequest(AsyncWebServerRequest *request) override;
+
+    protected:
+      FlightRecorder *recorder_;
+      FlightRecorder::Incident incident_{};
+    };
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
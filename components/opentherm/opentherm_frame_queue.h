@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Frame exchanged on the thermostat bus, handed to loop() for caching and publishing
+    struct InterceptedFrame
+    {
+      uint32_t frame;
+      uint8_t id;
+    };
+
+    // Bounded lock-free single-producer/single-consumer queue. The producer is the
+    // pass-through path (bus task or loop), the consumer is the component loop().
+    // When full the newest frame is dropped and counted - the bus side never waits.
+    class FrameQueue
+    {
+    public:
+      static const uint8_t SIZE = 16; // Power of two
+
+      bool push(const InterceptedFrame &item)
+      {
+        uint8_t head = head_.load(std::memory_order_relaxed);
+        uint8_t next = (head + 1) & (SIZE - 1);
+        if (next == tail_.load(std::memory_order_acquire))
+        {
+          dropped_.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        items_[head] = item;
+        head_.store(next, std::memory_order_release);
+        return true;
+      }
+
+      bool pop(InterceptedFrame &item)
+      {
+        uint8_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+          return false;
+        item = items_[tail];
+        tail_.store((tail + 1) & (SIZE - 1), std::memory_order_release);
+        return true;
+      }
+
+      // Read by the consumer while the producer counts
+      uint32_t get_dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    protected:
+      InterceptedFrame items_[SIZE];
+      std::atomic<uint8_t> head_{0};
+      std::atomic<uint8_t> tail_{0};
+      std::atomic<uint32_t> dropped_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,198 @@
+#include "opentherm_frame_server.h"
+#include "opentherm_allocation_guard.h"
+#include "esphome/core/log.h"
+#include <cerrno>
+#include <cstring>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.frame_server";
+
+    // Lines formatted per write() call
+    static const uint8_t BATCH = 16;
+
+    static void format_line(char *out, const FrameServer::Line &line)
+    {
+      static const char HEX[] = "0123456789ABCDEF";
+      out[0] = line.source;
+      for (uint8_t i = 0; i < 8; i++)
+        out[1 + i] = HEX[(line.frame >> (28 - 4 * i)) & 0xF];
+      out[9] = '\r';
+      out[10] = '\n';
+    }
+
+    bool FrameServer::setup()
+    {
+      listener_ = socket::socket_ip(SOCK_STREAM, 0);
+      if (listener_ == nullptr)
+      {
+        ESP_LOGE(TAG, "Could not create frame server socket");
+        return false;
+      }
+
+      int enable = 1;
+      listener_->setsockopt(SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int));
+      listener_->setblocking(false);
+
+      struct sockaddr_storage server;
+      socklen_t length = socket::set_sockaddr_any(reinterpret_cast<struct sockaddr *>(&server), sizeof(server), port_);
+      if (length == 0 || listener_->bind(reinterpret_cast<struct sockaddr *>(&server), length) != 0 ||
+          listener_->listen(MAX_CLIENTS) != 0)
+      {
+        ESP_LOGE(TAG, "Could not listen on port %u (errno %d)", port_, errno);
+        listener_ = nullptr;
+        return false;
+      }
+
+      ESP_LOGI(TAG, "Serving OTGW frame lines on port %u", port_);
+      return true;
+    }
+
+    void FrameServer::add(const Line *lines, uint8_t count)
+    {
+      if (count > MAX_GROUP)
+        count = MAX_GROUP;
+      uint32_t head = head_.load(std::memory_order_relaxed);
+      for (uint8_t i = 0; i < count; i++)
+        ring_[(head + i) % RING_SIZE] = lines[i];
+      head_.store(head + count, std::memory_order_release);
+    }
+
+    uint8_t FrameServer::get_clients() const
+    {
+      uint8_t count = 0;
+      for (const Client &client : clients_)
+      {
+        if (client.socket != nullptr)
+          count++;
+      }
+      return count;
+    }
+
+    void FrameServer::loop()
+    {
+      if (listener_ == nullptr)
+        return;
+
+      {
+        // A new client's socket is allocated, connects are rare and left out of the guard
+        AllocationScope unguarded(AllocationSlot::NONE);
+        accept_clients();
+      }
+
+      for (Client &client : clients_)
+      {
+        if (client.socket != nullptr && !serve(client))
+        {
+          client.socket->close();
+          client.socket = nullptr;
+          ESP_LOGD(TAG, "Client disconnected");
+        }
+      }
+    }
+
+    void FrameServer::accept_clients()
+    {
+      while (true)
+      {
+        struct sockaddr_storage source;
+        socklen_t length = sizeof(source);
+        std::unique_ptr<socket::Socket> socket =
+            listener_->accept(reinterpret_cast<struct sockaddr *>(&source), &length);
+        if (socket == nullptr)
+          return;
+
+        Client *slot = nullptr;
+        for (Client &client : clients_)
+        {
+          if (client.socket == nullptr)
+          {
+            slot = &client;
+            break;
+          }
+        }
+        if (slot == nullptr)
+        {
+          ESP_LOGW(TAG, "Rejecting client, %u already connected", MAX_CLIENTS);
+          socket->close();
+          continue;
+        }
+
+        socket->setblocking(false);
+        slot->socket = std::move(socket);
+        // New clients start with the live stream
+        slot->cursor = head_.load(std::memory_order_acquire);
+        slot->offset = 0;
+        ESP_LOGD(TAG, "Client connected");
+      }
+    }
+
+    bool FrameServer::serve(Client &client)
+    {
+      // OTGW commands from the client are not supported, drain and ignore them
+      uint8_t discard[32];
+      ssize_t received = client.socket->read(discard, sizeof(discard));
+      if (received == 0)
+        return false;
+      if (received < 0 && errno != EWOULDBLOCK && errno != EAGAIN)
+        return false;
+
+      // Finish a cut-off line from its copy, its ring slot may have been reused since
+      if (client.offset != 0)
+      {
+        ssize_t sent = client.socket->write(client.partial + client.offset, LINE_SIZE - client.offset);
+        if (sent < 0)
+          return errno == EWOULDBLOCK || errno == EAGAIN;
+        client.offset += sent;
+        if (client.offset < LINE_SIZE)
+          return true;
+        client.offset = 0;
+      }
+
+      // Lines closer than one group to being overwritten may be mid-write
+      const uint32_t window = RING_SIZE - MAX_GROUP;
+      while (true)
+      {
+        uint32_t head = head_.load(std::memory_order_acquire);
+        if (head - client.cursor > window)
+        {
+          // Lapped by the writer: skip to the oldest line that is safe to read
+          dropped_ += head - client.cursor - window;
+          client.cursor = head - window;
+        }
+        uint32_t pending = head - client.cursor;
+        uint8_t count = pending < BATCH ? pending : BATCH;
+        if (count == 0)
+          return true;
+
+        char buffer[BATCH * LINE_SIZE];
+        for (uint8_t i = 0; i < count; i++)
+          format_line(buffer + i * LINE_SIZE, ring_[(client.cursor + i) % RING_SIZE]);
+        // Discard the copy if the writer reached these slots meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (head_.load(std::memory_order_relaxed) - client.cursor > window)
+          continue;
+
+        size_t length = count * LINE_SIZE;
+        ssize_t sent = client.socket->write(buffer, length);
+        if (sent < 0)
+          return errno == EWOULDBLOCK || errno == EAGAIN;
+
+        size_t lines = sent / LINE_SIZE;
+        client.cursor += lines;
+        client.offset = sent % LINE_SIZE;
+        if (client.offset != 0)
+        {
+          std::memcpy(client.partial, buffer + lines * LINE_SIZE, LINE_SIZE);
+          client.cursor++;
+        }
+        if (static_cast<size_t>(sent) < length)
+          return true; // socket buffer full, continue on the next loop()
+      }
+    }
+
+  } // namespace opentherm
+} // namespace esphome
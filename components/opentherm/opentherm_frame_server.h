@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "esphome/components/socket/socket.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Streams bus frames to TCP clients as OpenTherm Gateway (OTGW) serial lines:
+    //   T = thermostat request, B = boiler response,
+    //   R = request the gateway sent to the boiler (modified or its own),
+    //   A = answer the gateway sent to the thermostat (when not the boiler's)
+    // e.g. "T10011400\r\n". Frames go into a preallocated ring, each client
+    // reads it at its own cursor. Adding a frame never waits on a client; a client
+    // that falls more than the ring size behind skips ahead and the lost frames
+    // are counted. A line cut off by a full socket buffer is kept in the client
+    // and finished first, so a skip never breaks the stream mid-line. Single
+    // writer (callers hold the bus lock), readers in loop().
+    class FrameServer
+    {
+    public:
+      static const size_t RING_SIZE = 256;
+      static const uint8_t MAX_CLIENTS = 4;
+      static const size_t LINE_SIZE = 11;
+      static const uint8_t MAX_GROUP = 4; // T, R, B, A of one exchange
+
+      struct Line
+      {
+        char source;
+        uint32_t frame;
+      };
+
+      void configure(uint16_t port) { port_ = port; }
+      bool is_configured() const { return port_ != 0; }
+
+      bool setup();
+      void loop();
+
+      // Publishes up to MAX_GROUP lines at once
+      void add(const Line *lines, uint8_t count);
+
+      uint8_t get_clients() const;
+      uint32_t get_lines() const { return head_.load(std::memory_order_relaxed); }
+      uint32_t get_dropped() const { return dropped_; }
+
+    protected:
+      struct Client
+      {
+        std::unique_ptr<socket::Socket> socket;
+        uint32_t cursor;          // next line to send from the ring
+        uint8_t offset;           // bytes of partial already sent, 0 = none pending
+        char partial[LINE_SIZE];  // line cut off by a full socket buffer
+      };
+
+      void accept_clients();
+      bool serve(Client &client);
+
+      uint16_t port_{0};
+      std::unique_ptr<socket::Socket> listener_;
+      Client clients_[MAX_CLIENTS];
+
+      Line ring_[RING_SIZE];
+      std::atomic<uint32_t> head_{0}; // sequence number of the next line
+      uint32_t dropped_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,26 @@
+#include "opentherm_frame_tracker.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    bool FrameTracker::update(uint8_t id, uint32_t frame)
+    {
+      if (id >= MAX_ID)
+        return true;
+
+      if (changed_at_[id] != 0 && ((frames_[id] ^ frame) & VALUE_MASK) == 0)
+      {
+        duplicates_++;
+        return false;
+      }
+
+      frames_[id] = frame;
+      changed_at_[id] = ++epoch_;
+      changes_++;
+      return true;
+    }
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Last frame per data ID with the epoch at which its value last changed.
+    // The thermostat repeats the same frames every cycle; consumers remember the
+    // epoch they last ran at and skip their work while changed_since() is false.
+    // Frames compare on data ID and value only, so an intercepted WRITE and a
+    // polled READ-ACK carrying the same value count as duplicates.
+    class FrameTracker
+    {
+    public:
+      static const uint8_t MAX_ID = 128;
+
+      // Returns true if the frame's value differs from the last one for its ID
+      bool update(uint8_t id, uint32_t frame);
+
+      uint32_t get_epoch() const { return epoch_; }
+      bool changed_since(uint8_t id, uint32_t epoch) const { return id < MAX_ID && changed_at_[id] > epoch; }
+      uint32_t get_frame(uint8_t id) const { return id < MAX_ID ? frames_[id] : 0; }
+
+      uint32_t get_duplicates() const { return duplicates_; }
+      uint32_t get_changes() const { return changes_; }
+
+    protected:
+      static const uint32_t VALUE_MASK = 0x00FFFFFF; // data ID and value, no parity or message type
+
+      uint32_t frames_[MAX_ID]{};
+      uint32_t changed_at_[MAX_ID]{}; // 0 = never seen
+      uint32_t epoch_{0};
+      uint32_t duplicates_{0};
+      uint32_t changes_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
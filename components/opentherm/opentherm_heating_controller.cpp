@@ -0,0 +1,109 @@
+#include "opentherm_heating_controller.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Gaps longer than this (missed Tr frames, override paused) are not integrated
+    static const uint32_t MAX_INTEGRATION_STEP_MS = 5UL * 60UL * 1000UL;
+    static const float MS_PER_HOUR = 3600000.0f;
+    // The hysteresis controller keeps the original curve: it is evaluated for a fixed
+    // design room temperature, not the override target, and never asks for less than
+    // 25 °C water while the room is cold
+    static const float DESIGN_ROOM_TEMPERATURE = 20.0f;
+    static const float MIN_HEATING_WATER_TEMPERATURE = 25.0f;
+
+    void HeatingController::reset()
+    {
+      // A room temperature from before the reset may be long outdated, the outside
+      // temperature is fed continuously and stays
+      room_temp_ = NAN;
+      max_overshoot_ = 0.0f;
+    }
+
+    void HeatingController::on_room_temperature(float room_temp, float room_target, uint32_t now)
+    {
+      room_temp_ = room_temp;
+      if (!std::isnan(room_temp) && room_temp - room_target > max_overshoot_)
+        max_overshoot_ = room_temp - room_target;
+    }
+
+    float HysteresisController::compute(float room_target, float thermostat_water_temp)
+    {
+      if (std::isnan(room_temp_))
+        return NAN;
+
+      // Room above target: lowest water temperature to effectively stop heating
+      if (room_temp_ > room_target + 0.2f)
+        return curve_.min_water_temperature;
+
+      // Room below target: heating curve, or the thermostat's own calculation without outdoor temp
+      if (room_temp_ < room_target - 0.5f)
+      {
+        if (std::isnan(outside_temp_))
+          return thermostat_water_temp;
+        float water_temp = curve_.clamp(curve_.feed_forward(DESIGN_ROOM_TEMPERATURE, outside_temp_));
+        return water_temp < MIN_HEATING_WATER_TEMPERATURE ? MIN_HEATING_WATER_TEMPERATURE : water_temp;
+      }
+
+      // Hysteresis zone - keep the thermostat's value
+      return NAN;
+    }
+
+    void WeatherPIController::reset()
+    {
+      HeatingController::reset();
+      integral_ = 0.0f;
+      last_update_ = 0;
+    }
+
+    float WeatherPIController::feed_forward(float room_target) const
+    {
+      if (std::isnan(outside_temp_))
+        return last_thermostat_water_temp_;
+      return curve_.feed_forward(room_target, outside_temp_);
+    }
+
+    void WeatherPIController::on_room_temperature(float room_temp, float room_target, uint32_t now)
+    {
+      HeatingController::on_room_temperature(room_temp, room_target, now);
+      if (std::isnan(room_temp))
+        return;
+
+      uint32_t elapsed = now - last_update_;
+      bool integrate = last_update_ != 0 && elapsed <= MAX_INTEGRATION_STEP_MS;
+      last_update_ = now;
+
+      float ff = feed_forward(room_target);
+      if (!integrate || std::isnan(ff))
+        return;
+
+      float error = room_target - room_temp;
+      float candidate = integral_ + ki_ * error * (elapsed / MS_PER_HOUR);
+      float output = ff + kp_ * error + candidate;
+
+      // Anti-windup: don't integrate further into a saturated output
+      if (output > curve_.max_water_temperature && error > 0)
+        return;
+      if (output < curve_.min_water_temperature && error < 0)
+        return;
+      integral_ = candidate;
+    }
+
+    float WeatherPIController::compute(float room_target, float thermostat_water_temp)
+    {
+      last_thermostat_water_temp_ = thermostat_water_temp;
+      if (std::isnan(room_temp_))
+        return NAN;
+
+      float ff = feed_forward(room_target);
+      if (std::isnan(ff))
+        return NAN;
+
+      float error = room_target - room_temp_;
+      return curve_.clamp(ff + kp_ * error + integral_);
+    }
+
+  } // namespace opentherm
+} // namespace esphome
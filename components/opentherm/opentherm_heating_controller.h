@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    enum class HeatingControllerType : uint8_t
+    {
+      HYSTERESIS,
+      PI
+    };
+
+    // Weather-compensated heating curve shared by all controllers.
+    // water_temp = base + slope * (room_target - outside_temp), clamped to the water limits.
+    struct HeatingCurve
+    {
+      float base_temperature{25.0f};
+      float slope{1.4f};
+      float min_water_temperature{20.0f};
+      float max_water_temperature{75.0f};
+
+      float feed_forward(float room_target, float outside_temp) const
+      {
+        return base_temperature + slope * (room_target - outside_temp);
+      }
+      float clamp(float water_temp) const
+      {
+        if (water_temp < min_water_temperature)
+          return min_water_temperature;
+        if (water_temp > max_water_temperature)
+          return max_water_temperature;
+        return water_temp;
+      }
+    };
+
+    // Chooses the CH water setpoint (TSet) during a heating override.
+    // State is updated incrementally from intercepted Tr/Toutside frames and
+    // compute() is O(1), so it is cheap enough for the pass-through path.
+    class HeatingController
+    {
+    public:
+      virtual ~HeatingController() = default;
+
+      void set_curve(const HeatingCurve &curve) { curve_ = curve; }
+      const HeatingCurve &get_curve() const { return curve_; }
+
+      virtual void reset();
+      virtual void on_room_temperature(float room_temp, float room_target, uint32_t now);
+      void on_outside_temperature(float outside_temp) { outside_temp_ = outside_temp; }
+
+      // Water setpoint to send instead of the thermostat's, NAN keeps the thermostat's value
+      virtual float compute(float room_target, float thermostat_water_temp) = 0;
+
+      // Largest room temperature excursion above target since the last reset
+      float get_max_overshoot() const { return max_overshoot_; }
+
+    protected:
+      HeatingCurve curve_;
+      float room_temp_{NAN};
+      float outside_temp_{NAN};
+      float max_overshoot_{0.0f};
+    };
+
+    // Original behaviour: curve for a 20 °C design room temperature (at least 25 °C)
+    // while the room is cold, minimum water temperature while it is warm, thermostat's
+    // value inside the -0.5/+0.2 °C band. Only the PI controller follows the target.
+    class HysteresisController : public HeatingController
+    {
+    public:
+      float compute(float room_target, float thermostat_water_temp) override;
+    };
+
+    // Heating curve as feed-forward plus a PI term on the room temperature error.
+    // The integral is advanced on every Tr frame and frozen while the output is
+    // saturated in the direction of the error (conditional integration anti-windup).
+    class WeatherPIController : public HeatingController
+    {
+    public:
+      // kp in °C water per °C room error, ki in °C water per °C room error per hour
+      void set_gains(float kp, float ki)
+      {
+        kp_ = kp;
+        ki_ = ki;
+      }
+
+      void reset() override;
+      void on_room_temperature(float room_temp, float room_target, uint32_t now) override;
+      float compute(float room_target, float thermostat_water_temp) override;
+
+    protected:
+      float feed_forward(float room_target) const;
+
+      float kp_{8.0f};
+      float ki_{2.0f};
+      float integral_{0.0f};
+      float last_thermostat_water_temp_{NAN};
+      uint32_t last_update_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,376 @@
+#include "opentherm_history.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.history";
+
+    // Status, TrSet, RelModLevel, CHPressure, Tr, Tboiler, Tdhw, Tret
+    static const uint8_t SERIES_IDS[HistoryBuffer::MAX_SERIES] = {0, 16, 17, 18, 24, 25, 26, 28};
+
+    static inline uint32_t zigzag(int32_t value) { return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31); }
+    static inline int32_t unzigzag(uint32_t value) { return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1); }
+
+    static size_t put_varint(uint8_t *dst, uint32_t value)
+    {
+      size_t n = 0;
+      while (value >= 0x80)
+      {
+        dst[n++] = static_cast<uint8_t>(value) | 0x80;
+        value >>= 7;
+      }
+      dst[n++] = static_cast<uint8_t>(value);
+      return n;
+    }
+
+    static uint32_t get_varint(const uint8_t *src, size_t &pos)
+    {
+      uint32_t value = 0;
+      for (uint8_t shift = 0; shift < 35; shift += 7)
+      {
+        uint8_t byte = src[pos++];
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+          break;
+      }
+      return value;
+    }
+
+    int HistoryBuffer::series_index(uint8_t id)
+    {
+      for (uint8_t i = 0; i < MAX_SERIES; i++)
+      {
+        if (SERIES_IDS[i] == id)
+          return i;
+      }
+      return -1;
+    }
+
+    bool HistoryBuffer::setup()
+    {
+      // Allocated once, the buffer never grows
+      blocks_ = size_ / BLOCK_SIZE;
+      if (blocks_ < 2)
+        blocks_ = 2;
+      storage_ = new (std::nothrow) uint8_t[blocks_ * BLOCK_SIZE];
+      if (storage_ == nullptr)
+      {
+        ESP_LOGE(TAG, "Could not allocate %u bytes of history", static_cast<unsigned>(blocks_ * BLOCK_SIZE));
+        blocks_ = 0;
+        return false;
+      }
+      ESP_LOGI(TAG, "Keeping %u bytes of history", static_cast<unsigned>(blocks_ * BLOCK_SIZE));
+      return true;
+    }
+
+    void HistoryBuffer::start_block(uint32_t tick)
+    {
+      if (used_blocks_ == 0)
+      {
+        head_ = 0;
+        used_blocks_ = 1;
+      }
+      else
+      {
+        head_ = (head_ + 1) % blocks_;
+        if (used_blocks_ < blocks_)
+          used_blocks_++;
+      }
+
+      started_blocks_++;
+
+      BlockHeader *header = block(head_);
+      header->base_tick = tick;
+      header->last_tick = tick;
+      header->used = 0;
+      header->count = 0;
+
+      prev_tick_ = tick;
+      prev_delta_ = 0;
+      for (uint8_t i = 0; i < MAX_SERIES; i++)
+        prev_value_[i] = 0;
+    }
+
+    void HistoryBuffer::add(uint8_t id, uint16_t value, uint32_t now)
+    {
+      if (storage_ == nullptr)
+        return;
+
+      int series = series_index(id);
+      if (series < 0)
+        return;
+
+      LockGuard guard(lock_);
+
+      if (series_seen_[series] && last_value_[series] == value && now - last_recorded_[series] < REPEAT_INTERVAL_MS)
+      {
+        skipped_++;
+        return;
+      }
+
+      uint32_t tick = now / TICK_MS;
+      if (used_blocks_ == 0 || block(head_)->used + MAX_RECORD_SIZE > PAYLOAD_SIZE)
+        start_block(tick);
+
+      BlockHeader *header = block(head_);
+      uint8_t *out = payload(head_) + header->used;
+
+      int32_t delta = static_cast<int32_t>(tick - prev_tick_);
+      uint32_t dod = zigzag(delta - prev_delta_);
+      uint16_t diff = value ^ prev_value_[series];
+
+      uint8_t tag = series | (diff == 0 ? 0x08 : 0);
+      size_t length = 1;
+      if (dod < 15)
+      {
+        tag |= dod << 4;
+      }
+      else
+      {
+        tag |= 0xF0;
+        length += put_varint(out + length, dod);
+      }
+      if (diff != 0)
+        length += put_varint(out + length, diff);
+      out[0] = tag;
+
+      header->used += length;
+      header->count++;
+      header->last_tick = tick;
+
+      prev_tick_ = tick;
+      prev_delta_ = delta;
+      prev_value_[series] = value;
+
+      series_seen_[series] = true;
+      last_value_[series] = value;
+      last_recorded_[series] = now;
+      samples_++;
+    }
+
+    HistoryBuffer::Cursor HistoryBuffer::begin() const
+    {
+      LockGuard guard(lock_);
+      Cursor cursor;
+      cursor.block = started_blocks_ - used_blocks_;
+      return cursor;
+    }
+
+    bool HistoryBuffer::read(Cursor &cursor, uint32_t since_ms, SampleCallback callback, void *context) const
+    {
+      LockGuard guard(lock_);
+      uint32_t since_tick = since_ms / TICK_MS;
+
+      // The block the cursor stopped in may have been reused since the last call
+      uint32_t oldest = started_blocks_ - used_blocks_;
+      if (static_cast<int32_t>(cursor.block - oldest) < 0)
+      {
+        cursor.lost_blocks += oldest - cursor.block;
+        cursor.block = oldest;
+        cursor.record = 0;
+      }
+
+      for (; cursor.block != started_blocks_; cursor.block++, cursor.record = 0)
+      {
+        const BlockHeader *header = block(cursor.block % blocks_);
+        if (header->count == 0 || static_cast<int32_t>(header->last_tick - since_tick) < 0)
+          continue;
+
+        // Records only decode from the start of their block
+        const uint8_t *in = payload(cursor.block % blocks_);
+        size_t pos = 0;
+        uint32_t tick = header->base_tick;
+        int32_t delta = 0;
+        uint16_t values[MAX_SERIES]{};
+
+        for (uint16_t i = 0; i < header->count; i++)
+        {
+          uint8_t tag = in[pos++];
+          uint8_t series = tag & 0x07;
+          uint32_t dod = tag >> 4;
+          if (dod == 15)
+            dod = get_varint(in, pos);
+          delta += unzigzag(dod);
+          tick += delta;
+          if ((tag & 0x08) == 0)
+            values[series] ^= get_varint(in, pos);
+
+          if (i < cursor.record || static_cast<int32_t>(tick - since_tick) < 0)
+            continue;
+          if (!callback(context, tick * TICK_MS, SERIES_IDS[series], values[series]))
+          {
+            cursor.record = i;
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    void HistoryBuffer::get_usage(uint32_t &samples, size_t &bytes) const
+    {
+      LockGuard guard(lock_);
+      count_usage(samples, bytes);
+    }
+
+    void HistoryBuffer::count_usage(uint32_t &samples, size_t &bytes) const
+    {
+      samples = 0;
+      bytes = 0;
+      for (size_t i = 0; i < used_blocks_; i++)
+      {
+        const BlockHeader *header = block(i);
+        samples += header->count;
+        bytes += sizeof(BlockHeader) + header->used;
+      }
+    }
+
+    size_t HistoryBuffer::get_used_bytes() const
+    {
+      uint32_t samples;
+      size_t bytes;
+      get_usage(samples, bytes);
+      return bytes;
+    }
+
+    uint32_t HistoryBuffer::get_oldest_ms() const
+    {
+      LockGuard guard(lock_);
+      if (used_blocks_ == 0)
+        return 0;
+      return block((head_ + blocks_ - used_blocks_ + 1) % blocks_)->base_tick * TICK_MS;
+    }
+
+#ifdef USE_WEBSERVER
+    bool HistoryExportHandler::canHandle(AsyncWebServerRequest *request)
+    {
+      return request->method() == HTTP_GET && request->url() == "/opentherm/history";
+    }
+
+    // CSV lines go into a fixed window, a line that does not fit is left for the next one
+    struct CsvWindow
+    {
+      char *out;
+      size_t capacity;
+      size_t length;
+      uint32_t next_time_ms; // time of the first sample that did not fit
+    };
+
+    __attribute__((format(printf, 2, 3))) static bool append_line(CsvWindow &window, const char *format, ...)
+    {
+      char line[128];
+      va_list args;
+      va_start(args, format);
+      int length = vsnprintf(line, sizeof(line), format, args);
+      va_end(args);
+      if (length < 0 || window.length + length > window.capacity)
+        return false;
+      memcpy(window.out + window.length, line, length);
+      window.length += length;
+      return true;
+    }
+
+    static bool write_sample(void *context, uint32_t time_ms, uint8_t id, uint16_t value)
+    {
+      CsvWindow &window = *static_cast<CsvWindow *>(context);
+      if (append_line(window, "%u,%u,%u\n", static_cast<unsigned>(time_ms), static_cast<unsigned>(id),
+                      static_cast<unsigned>(value)))
+        return true;
+      window.next_time_ms = time_ms;
+      return false;
+    }
+
+    // One export in progress, resumed chunk by chunk
+    struct HistoryExport
+    {
+      enum Stage : uint8_t
+      {
+        HEADER,
+        SAMPLES,
+        FOOTER,
+        DONE
+      };
+
+      HistoryBuffer::Cursor cursor;
+      uint32_t since_ms;
+      uint32_t now_ms;
+      uint32_t samples;
+      size_t bytes;
+      Stage stage;
+    };
+
+    // Writes as much of the export as fits into the window
+    static void fill_export(const HistoryBuffer &history, HistoryExport &state, CsvWindow &window)
+    {
+      if (state.stage == HistoryExport::HEADER)
+      {
+        // Times are device uptime in ms; now_ms lets the collector map them to wall time
+        if (!append_line(window, "# now_ms=%u samples=%u bytes=%u bytes_per_sample=%.2f\ntime_ms,id,value\n",
+                         static_cast<unsigned>(state.now_ms), static_cast<unsigned>(state.samples),
+                         static_cast<unsigned>(state.bytes),
+                         state.samples != 0 ? static_cast<float>(state.bytes) / state.samples : 0.0f))
+          return;
+        state.stage = HistoryExport::SAMPLES;
+      }
+      if (state.stage == HistoryExport::SAMPLES)
+      {
+        if (!history.read(state.cursor, state.since_ms, write_sample, &window))
+          return;
+        state.stage = HistoryExport::FOOTER;
+      }
+      if (state.stage == HistoryExport::FOOTER)
+      {
+        if (state.cursor.lost_blocks != 0 &&
+            !append_line(window, "# lost_blocks=%u overwritten during the export\n",
+                         static_cast<unsigned>(state.cursor.lost_blocks)))
+          return;
+        state.stage = HistoryExport::DONE;
+      }
+    }
+
+    void HistoryExportHandler::handleRequest(AsyncWebServerRequest *request)
+    {
+      HistoryExport state{};
+      if (request->hasParam("since"))
+        state.since_ms = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+      state.now_ms = millis();
+      history_->get_usage(state.samples, state.bytes);
+      state.cursor = history_->begin();
+
+#ifdef USE_ARDUINO
+      // Each response carries its own cursor, the CSV is never held in memory as a whole
+      const HistoryBuffer *history = history_;
+      request->send(request->beginChunkedResponse("text/csv",
+                                                  [history, state](uint8_t *buffer, size_t max_len, size_t index) mutable -> size_t
+                                                  {
+                                                    CsvWindow window{reinterpret_cast<char *>(buffer), max_len, 0, 0};
+                                                    fill_export(*history, state, window);
+                                                    return window.length;
+                                                  }));
+#else
+      // Room is kept for the continuation line; samples at its time may be sent again
+      static const size_t CONTINUATION_SIZE = 40;
+      CsvWindow window{buffer_, BUFFER_SIZE - 1 - CONTINUATION_SIZE, 0, 0};
+      fill_export(*history_, state, window);
+      window.capacity = BUFFER_SIZE - 1;
+      if (state.stage == HistoryExport::SAMPLES)
+        append_line(window, "# more since=%u\n", static_cast<unsigned>(window.next_time_ms));
+      else
+        fill_export(*history_, state, window);
+      buffer_[window.length] = '\0';
+      request->send(200, "text/csv", buffer_);
+#endif
+    }
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
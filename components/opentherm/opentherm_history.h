@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "esphome/core/helpers.h"
+
+#ifdef USE_WEBSERVER
+#include "esphome/components/web_server_base/web_server_base.h"
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Rolling history of key data IDs in a fixed RAM budget, for backfilling
+    // collectors after a WiFi or Home Assistant outage.
+    //
+    // The buffer is a ring of fixed-size blocks, the oldest block is dropped when
+    // the ring is full. Each block starts from a plain header and encodes its
+    // records relative to the previous one:
+    //   tag:u8       bits 0-2 series, bit 3 value unchanged,
+    //                bits 4-7 zigzag delta-of-delta time (15 = varint follows)
+    //   [dod:varint] zigzag delta-of-delta time, 100 ms ticks
+    //   [xor:varint] raw value XOR the previous value of the series
+    // A steady series with regular updates costs one byte per sample.
+    //
+    // Samples are added from loop() and read by the web server, which runs in
+    // its own task on ESP32, so both sides hold a mutex. A reader keeps a cursor
+    // across calls instead of holding the lock for a whole export.
+    class HistoryBuffer
+    {
+    public:
+      static const size_t BLOCK_SIZE = 256;
+      static const uint8_t MAX_SERIES = 8;
+      static const uint32_t TICK_MS = 100;
+      // Unchanged values are only recorded again after this long
+      static const uint32_t REPEAT_INTERVAL_MS = 60000;
+
+      // Returns false to stop reading; the sample is handed out again on the next read()
+      typedef bool (*SampleCallback)(void *context, uint32_t time_ms, uint8_t id, uint16_t value);
+
+      // Read position: blocks are numbered from boot, so a cursor notices when the
+      // block it stopped in has been overwritten in the meantime
+      struct Cursor
+      {
+        uint32_t block{0};
+        uint16_t record{0};
+        uint32_t lost_blocks{0}; // overwritten before they could be read
+      };
+
+      void configure(size_t size) { size_ = size; }
+      bool is_configured() const { return size_ != 0; }
+      size_t get_size() const { return blocks_ * BLOCK_SIZE; }
+
+      bool setup();
+      void add(uint8_t id, uint16_t value, uint32_t now);
+      // Cursor at the oldest stored block. read() decodes samples recorded at or after
+      // since_ms from the cursor on, oldest first.
+      // Returns true once everything stored has been read, false if the callback stopped.
+      Cursor begin() const;
+      bool read(Cursor &cursor, uint32_t since_ms, SampleCallback callback, void *context) const;
+
+      uint32_t get_samples() const { return samples_; }
+      uint32_t get_skipped() const { return skipped_; }
+      size_t get_used_bytes() const;
+      // Stored samples and the bytes (including block headers) holding them
+      void get_usage(uint32_t &samples, size_t &bytes) const;
+      uint32_t get_oldest_ms() const;
+
+    protected:
+      struct BlockHeader
+      {
+        uint32_t base_tick;
+        uint32_t last_tick;
+        uint16_t used;
+        uint16_t count;
+      };
+      static const size_t PAYLOAD_SIZE = BLOCK_SIZE - sizeof(BlockHeader);
+      // tag + 5-byte time varint + 3-byte value varint
+      static const size_t MAX_RECORD_SIZE = 9;
+
+      static int series_index(uint8_t id);
+      BlockHeader *block(size_t index) const { return reinterpret_cast<BlockHeader *>(storage_ + index * BLOCK_SIZE); }
+      uint8_t *payload(size_t index) const { return storage_ + index * BLOCK_SIZE + sizeof(BlockHeader); }
+      void start_block(uint32_t tick);
+      void count_usage(uint32_t &samples, size_t &bytes) const;
+
+      size_t size_{0};
+      uint8_t *storage_{nullptr};
+      size_t blocks_{0};
+      size_t head_{0};
+      size_t used_blocks_{0};
+      uint32_t started_blocks_{0}; // since boot, head_ holds block started_blocks_ - 1
+      mutable Mutex lock_;
+
+      // Encoder state, restarted with every block
+      uint32_t prev_tick_{0};
+      int32_t prev_delta_{0};
+      uint16_t prev_value_[MAX_SERIES]{};
+
+      // Per-series state across blocks, to skip unchanged repeats
+      bool series_seen_[MAX_SERIES]{};
+      uint16_t last_value_[MAX_SERIES]{};
+      uint32_t last_recorded_[MAX_SERIES]{};
+
+      uint32_t samples_{0};
+      uint32_t skipped_{0};
+    };
+
+#ifdef USE_WEBSERVER
+    // GET /opentherm/history[?since=<uptime ms>] - CSV export of the history buffer.
+    // With the Arduino web server the CSV is sent in chunks, each response keeps its
+    // own cursor. Otherwise it is built in a fixed buffer; when that is full the
+    // last line gives the since= value to continue from.
+    class HistoryExportHandler : public AsyncWebHandler
+    {
+    public:
+      explicit HistoryExportHandler(HistoryBuffer *history) : history_(history) {}
+
+      bool canHandle(AsyncWebServerRequest *request) override;
+      void handleRequest(AsyncWebServerRequest *request) override;
+
+    protected:
+      HistoryBuffer *history_;
+#ifndef USE_ARDUINO
+      static const size_t BUFFER_SIZE = 2048;
+      char buffer_[BUFFER_SIZE];
+#endif
+    };
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
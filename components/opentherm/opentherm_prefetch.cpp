@@ -0,0 +1,53 @@
+#include "opentherm_prefetch.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Gaps longer than this are pauses in the thermostat's cycle, not its rhythm
+    static const uint32_t MAX_INTERVAL_MS = 5000;
+
+    static uint8_t frame_id(uint32_t frame) { return (frame >> 16) & 0xFF; }
+    static uint8_t frame_type(uint32_t frame) { return (frame >> 28) & 0x7; }
+
+    void SequencePredictor::observe(uint32_t request, uint32_t now)
+    {
+      if (last_id_ < MAX_ID)
+      {
+        Successor &successor = successors_[last_id_];
+        if (successor.frame == request)
+        {
+          if (successor.confidence < CONFIDENT)
+            successor.confidence++;
+        }
+        else
+        {
+          successor.frame = request;
+          successor.confidence = 0;
+        }
+
+        uint32_t gap = now - last_time_;
+        if (gap < MAX_INTERVAL_MS)
+          interval_ = interval_ == 0 ? gap : (interval_ * 7 + gap) / 8;
+      }
+
+      last_id_ = frame_id(request) < MAX_ID ? frame_id(request) : MAX_ID;
+      last_time_ = now;
+      sequence_++;
+    }
+
+    bool SequencePredictor::predict(uint32_t &request) const
+    {
+      if (last_id_ >= MAX_ID)
+        return false;
+      const Successor &successor = successors_[last_id_];
+      // READ-DATA is message type 0
+      if (successor.confidence < CONFIDENT || frame_type(successor.frame) != 0 || frame_id(successor.frame) == 0)
+        return false;
+      request = successor.frame;
+      return true;
+    }
+
+  } // namespace opentherm
+} // namespace esphome
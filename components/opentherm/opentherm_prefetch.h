@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Learns the order in which the thermostat cycles through its requests.
+    // For every data ID it remembers the frame that followed it last time; a
+    // successor that repeated CONFIDENT times in a row is used as prediction.
+    // Only READs are predicted, and never Status (ID 0), whose READ carries the
+    // thermostat's CH/DHW enable flags.
+    class SequencePredictor
+    {
+    public:
+      static const uint8_t MAX_ID = 128;
+      static const uint8_t CONFIDENT = 2;
+
+      // Called for every thermostat request
+      void observe(uint32_t request, uint32_t now);
+      // Frame the thermostat is expected to send next
+      bool predict(uint32_t &request) const;
+
+      uint32_t get_sequence() const { return sequence_; }
+      uint32_t get_last_request_time() const { return last_time_; }
+      // Moving average of the time between thermostat requests
+      uint32_t get_interval() const { return interval_; }
+
+    protected:
+      struct Successor
+      {
+        uint32_t frame;
+        uint8_t confidence;
+      };
+
+      Successor successors_[MAX_ID]{};
+      uint8_t last_id_{MAX_ID};
+      uint32_t last_time_{0};
+      uint32_t interval_{0};
+      uint32_t sequence_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
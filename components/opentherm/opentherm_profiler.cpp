@@ -0,0 +1,110 @@
+#include "opentherm_profiler.h"
+#include "esphome/core/log.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.profiler";
+
+    const char *LoopProfiler::slot_name(ProfileSlot slot)
+    {
+      switch (slot)
+      {
+        case ProfileSlot::THERMOSTAT_BUS:
+          return "thermostat_bus";
+        case ProfileSlot::CACHED_RESPONSE:
+          return "cached_response";
+        case ProfileSlot::COMMAND:
+          return "command";
+        case ProfileSlot::POLL:
+          return "poll";
+        case ProfileSlot::OEM_READS:
+          return "oem_reads";
+        case ProfileSlot::CLIMATE_PUBLISH:
+          return "climate_publish";
+        case ProfileSlot::UPDATE:
+          return "update";
+        default:
+          return "unknown";
+      }
+    }
+
+    const char *LoopProfiler::path_name(HotPath path)
+    {
+      switch (path)
+      {
+        case HotPath::PASS_THROUGH:
+          return "pass_through";
+        case HotPath::DHW_OVERRIDE:
+          return "dhw_override";
+        case HotPath::HEATING_OVERRIDE:
+          return "heating_override";
+        case HotPath::RECORD_FRAME:
+          return "record_frame";
+        case HotPath::CACHED_RESPONSE:
+          return "cached_response";
+        case HotPath::CACHE_HIT:
+          return "cache_hit";
+        default:
+          return "unknown";
+      }
+    }
+
+    void LoopProfiler::log_hot_paths()
+    {
+      // One key=value line per path, stable for scripts comparing firmware builds
+      uint32_t mhz = arch_get_cpu_freq_hz() / 1000000;
+      if (mhz == 0)
+        return;
+      for (uint8_t i = 0; i < static_cast<uint8_t>(HotPath::COUNT); i++)
+      {
+        const CycleStats &stats = cycles_[i];
+        if (stats.count == 0)
+          continue;
+        ESP_LOGD(TAG, "hotpath v1 path=%s n=%u mean_ns=%u min_ns=%u max_ns=%u cpu_mhz=%u",
+                 path_name(static_cast<HotPath>(i)), static_cast<unsigned>(stats.count),
+                 static_cast<unsigned>(stats.total * 1000 / mhz / stats.count),
+                 static_cast<unsigned>(static_cast<uint64_t>(stats.min) * 1000 / mhz),
+                 static_cast<unsigned>(static_cast<uint64_t>(stats.max) * 1000 / mhz), static_cast<unsigned>(mhz));
+      }
+    }
+
+    void LoopProfiler::log_summary(uint32_t window_ms)
+    {
+      ESP_LOGD(TAG, "Last %u ms:", static_cast<unsigned>(window_ms));
+      for (uint8_t i = 0; i < static_cast<uint8_t>(ProfileSlot::COUNT); i++)
+      {
+        const Stats &stats = stats_[i];
+        if (stats.calls == 0)
+          continue;
+        if (stats.max_id != NO_ID)
+        {
+          ESP_LOGD(TAG, "  %-15s %6u calls, total %7u us, avg %6u us, max %6u us (msg_id %u)",
+                   slot_name(static_cast<ProfileSlot>(i)), static_cast<unsigned>(stats.calls),
+                   static_cast<unsigned>(stats.total_us), static_cast<unsigned>(stats.total_us / stats.calls),
+                   static_cast<unsigned>(stats.max_us), stats.max_id);
+        }
+        else
+        {
+          ESP_LOGD(TAG, "  %-15s %6u calls, total %7u us, avg %6u us, max %6u us",
+                   slot_name(static_cast<ProfileSlot>(i)), static_cast<unsigned>(stats.calls),
+                   static_cast<unsigned>(stats.total_us), static_cast<unsigned>(stats.total_us / stats.calls),
+                   static_cast<unsigned>(stats.max_us));
+        }
+      }
+      log_hot_paths();
+      reset();
+    }
+
+    void LoopProfiler::reset()
+    {
+      for (uint8_t i = 0; i < static_cast<uint8_t>(ProfileSlot::COUNT); i++)
+        stats_[i] = Stats{};
+      for (uint8_t i = 0; i < static_cast<uint8_t>(HotPath::COUNT); i++)
+        cycles_[i] = CycleStats{};
+    }
+
+  } // namespace opentherm
+} // namespace esphome
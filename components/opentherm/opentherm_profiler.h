@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/hal.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Code paths of OpenthermComponent timed by the profiler
+    enum class ProfileSlot : uint8_t
+    {
+      THERMOSTAT_BUS,  // pass-through / slave_ot_->process() from loop()
+      CACHED_RESPONSE, // processCachedResponse()
+      COMMAND,         // user command writes
+      POLL,            // getCachedOrFetch()
+      OEM_READS,       // OEM fault and diagnostic code reads
+      CLIMATE_PUBLISH, // climate entity updates
+      UPDATE,          // the whole update()
+      COUNT
+    };
+
+    // Short CPU-bound paths of frame processing, timed in CPU cycles. Bus I/O is
+    // excluded, so results compare the cost of the code itself across builds.
+    enum class HotPath : uint8_t
+    {
+      PASS_THROUGH,     // applyOverrides() without an active override
+      DHW_OVERRIDE,     // applyOverrides() rewriting TdhwSet
+      HEATING_OVERRIDE, // applyOverrides() rewriting TSet/TrSet, including the controller
+      RECORD_FRAME,     // recordInterceptedFrame()
+      CACHED_RESPONSE,  // processCachedResponse()
+      CACHE_HIT,        // getCachedOrFetch() answered from the cache
+      COUNT
+    };
+
+    // Accumulates call count, total and max time per slot over one reporting
+    // window. Slots are fixed, recording only updates a few integers.
+    class LoopProfiler
+    {
+    public:
+      static const uint8_t NO_ID = 0xFF;
+
+      struct Stats
+      {
+        uint32_t calls;
+        uint32_t total_us;
+        uint32_t max_us;
+        uint8_t max_id;
+      };
+
+      void set_enabled(bool enabled) { enabled_ = enabled; }
+      bool is_enabled() const { return enabled_; }
+
+      void record(ProfileSlot slot, uint8_t id, uint32_t elapsed_us)
+      {
+        Stats &stats = stats_[static_cast<uint8_t>(slot)];
+        stats.calls++;
+        stats.total_us += elapsed_us;
+        if (elapsed_us >= stats.max_us)
+        {
+          stats.max_us = elapsed_us;
+          stats.max_id = id;
+        }
+      }
+
+      // Each hot path is recorded from one task only. Pass-through records from the bus
+      // task under the bus lock, which the window reset in log_summary() also takes.
+      void record_cycles(HotPath path, uint32_t cycles)
+      {
+        CycleStats &stats = cycles_[static_cast<uint8_t>(path)];
+        if (stats.count == 0 || cycles < stats.min)
+          stats.min = cycles;
+        if (cycles > stats.max)
+          stats.max = cycles;
+        stats.total += cycles;
+        stats.count++;
+      }
+
+      const Stats &get(ProfileSlot slot) const { return stats_[static_cast<uint8_t>(slot)]; }
+      static const char *slot_name(ProfileSlot slot);
+      static const char *path_name(HotPath path);
+
+      // Logs the window at DEBUG and starts a new one
+      void log_summary(uint32_t window_ms);
+      void reset();
+
+    protected:
+      struct CycleStats
+      {
+        uint32_t count;
+        uint64_t total;
+        uint32_t min;
+        uint32_t max;
+      };
+
+      void log_hot_paths();
+
+      bool enabled_{false};
+      Stats stats_[static_cast<uint8_t>(ProfileSlot::COUNT)]{};
+      CycleStats cycles_[static_cast<uint8_t>(HotPath::COUNT)]{};
+    };
+
+    // Times the enclosing scope into a profiler slot, no-op when profiling is disabled
+    class ProfileScope
+    {
+    public:
+      ProfileScope(LoopProfiler &profiler, ProfileSlot slot, uint8_t id = LoopProfiler::NO_ID)
+          : profiler_(profiler), slot_(slot), id_(id), start_(profiler.is_enabled() ? micros() : 0)
+      {
+      }
+      ~ProfileScope()
+      {
+        if (profiler_.is_enabled())
+          profiler_.record(slot_, id_, micros() - start_);
+      }
+
+    protected:
+      LoopProfiler &profiler_;
+      ProfileSlot slot_;
+      uint8_t id_;
+      uint32_t start_;
+    };
+
+    // Times the enclosing scope in CPU cycles into a hot path
+    class CycleScope
+    {
+    public:
+      CycleScope(LoopProfiler &profiler, HotPath path)
+          : profiler_(profiler), path_(path), start_(profiler.is_enabled() ? arch_get_cpu_cycle_count() : 0)
+      {
+      }
+      ~CycleScope()
+      {
+        if (profiler_.is_enabled())
+          profiler_.record_cycles(path_, arch_get_cpu_cycle_count() - start_);
+      }
+
+    protected:
+      LoopProfiler &profiler_;
+      HotPath path_;
+      uint32_t start_;
+    };
+
+  } // namespace opentherm
+} // namespace esphome
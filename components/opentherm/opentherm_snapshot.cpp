@@ -0,0 +1,200 @@
+#include "opentherm_snapshot.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    void JsonWriter::raw(const char *data, size_t length)
+    {
+      // Copy only the part of [pos_, pos_ + length) that overlaps the window
+      size_t end = skip_ + capacity_;
+      for (size_t i = 0; i < length; i++, pos_++)
+      {
+        if (pos_ >= skip_ && pos_ < end)
+          out_[pos_ - skip_] = data[i];
+      }
+    }
+
+    void JsonWriter::raw(const char *data) { raw(data, strlen(data)); }
+
+    size_t JsonWriter::written() const
+    {
+      if (pos_ <= skip_)
+        return 0;
+      size_t n = pos_ - skip_;
+      return n < capacity_ ? n : capacity_;
+    }
+
+    void JsonWriter::key(const char *name)
+    {
+      if (depth_ > 0)
+      {
+        if (!first_[depth_ - 1])
+          raw(",", 1);
+        first_[depth_ - 1] = false;
+      }
+      if (name != nullptr)
+      {
+        raw("\"", 1);
+        raw(name);
+        raw("\":", 2);
+      }
+    }
+
+    void JsonWriter::begin_object(const char *name)
+    {
+      key(name);
+      raw("{", 1);
+      if (depth_ < MAX_DEPTH)
+        first_[depth_] = true;
+      depth_++;
+    }
+
+    void JsonWriter::end_object()
+    {
+      raw("}", 1);
+      if (depth_ > 0)
+        depth_--;
+    }
+
+    void JsonWriter::add(const char *name, float value)
+    {
+      key(name);
+      if (std::isnan(value))
+      {
+        raw("null", 4);
+        return;
+      }
+      char buf[24];
+      int n = snprintf(buf, sizeof(buf), "%.2f", value);
+      raw(buf, n > 0 ? n : 0);
+    }
+
+    void JsonWriter::add(const char *name, uint32_t value)
+    {
+      key(name);
+      char buf[12];
+      int n = snprintf(buf, sizeof(buf), "%u", static_cast<unsigned>(value));
+      raw(buf, n > 0 ? n : 0);
+    }
+
+    void JsonWriter::add(const char *name, bool value)
+    {
+      key(name);
+      if (value)
+        raw("true", 4);
+      else
+        raw("false", 5);
+    }
+
+    void JsonWriter::add(const char *name, const char *value)
+    {
+      key(name);
+      raw("\"", 1);
+      raw(value);
+      raw("\"", 1);
+    }
+
+    static void write_override(JsonWriter &writer, const char *name, const GatewaySnapshot::Override &state)
+    {
+      writer.begin_object(name);
+      writer.add("active", state.active);
+      writer.add("setpoint", state.setpoint);
+      writer.add("expires_in_ms", state.expires_in_ms);
+      writer.end_object();
+    }
+
+    void write_snapshot_json(const GatewaySnapshot &snapshot, JsonWriter &writer)
+    {
+      writer.begin_object();
+      writer.add("uptime_ms", snapshot.uptime_ms);
+
+      writer.begin_object("status");
+      writer.add("raw", static_cast<uint32_t>(snapshot.status));
+      writer.add("fault", snapshot.fault);
+      writer.add("ch_active", snapshot.ch_active);
+      writer.add("dhw_active", snapshot.dhw_active);
+      writer.add("flame", snapshot.flame);
+      writer.add("diagnostic", snapshot.diagnostic);
+      writer.end_object();
+
+      writer.begin_object("values");
+      for (uint8_t i = 0; i < snapshot.value_count; i++)
+      {
+        const GatewaySnapshot::Value &value = snapshot.values[i];
+        writer.begin_object(value.name);
+        writer.add("value", value.value);
+        writer.add("age_ms", value.age_ms);
+        writer.add("source", value.source);
+        writer.add("stale", value.stale);
+        writer.add("out_of_target_s", value.out_of_target_s);
+        writer.end_object();
+      }
+      writer.end_object();
+
+      writer.begin_object("overrides");
+      write_override(writer, "dhw", snapshot.dhw_override);
+      write_override(writer, "heating", snapshot.heating_override);
+      writer.end_object();
+
+      writer.begin_object("limits");
+      writer.add("max_ch_setpoint", snapshot.max_ch_setpoint);
+      writer.add("max_modulation", snapshot.max_modulation);
+      writer.end_object();
+
+      writer.begin_object("bus");
+      writer.add("deadline_misses", snapshot.deadline_misses);
+      writer.add("max_response_time_ms", snapshot.max_response_time_ms);
+      writer.add("dropped_frames", snapshot.dropped_frames);
+      writer.add("commands_queued", snapshot.commands_queued);
+      writer.add("commands_merged", snapshot.commands_merged);
+      writer.add("listen_only", snapshot.listen_only);
+      writer.add("observed_ids", snapshot.observed_ids);
+      writer.add("utilization_pct", snapshot.bus_utilization);
+      writer.add("deferred_polls", snapshot.deferred_polls);
+      writer.end_object();
+
+      writer.end_object();
+    }
+
+#ifdef USE_WEBSERVER
+    bool SnapshotHandler::canHandle(AsyncWebServerRequest *request)
+    {
+      return request->method() == HTTP_GET && request->url() == "/opentherm/snapshot";
+    }
+
+    void SnapshotHandler::handleRequest(AsyncWebServerRequest *request)
+    {
+      GatewaySnapshot snapshot{};
+      capture_(context_, snapshot);
+
+#ifdef USE_ARDUINO
+      // Each chunk regenerates the document from the response's own copy and keeps
+      // only its slice, the document itself is never buffered
+      request->send(request->beginChunkedResponse("application/json",
+                                                  [snapshot](uint8_t *buffer, size_t max_len, size_t index) -> size_t
+                                                  {
+                                                    JsonWriter writer(reinterpret_cast<char *>(buffer), max_len, index);
+                                                    write_snapshot_json(snapshot, writer);
+                                                    return writer.written();
+                                                  }));
+#else
+      JsonWriter writer(buffer_, BUFFER_SIZE - 1);
+      write_snapshot_json(snapshot, writer);
+      if (writer.truncated())
+      {
+        request->send(500, "text/plain", "Snapshot too large");
+        return;
+      }
+      buffer_[writer.length()] = '\0';
+      request->send(200, "application/json", buffer_);
+#endif
+    }
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef USE_WEBSERVER
+#include "esphome/components/web_server_base/web_server_base.h"
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Minimal JSON writer over a fixed output window. The document is generated
+    // from the start on every call and only bytes [skip, skip + capacity) are
+    // copied out, so a response can be produced chunk by chunk without buffering
+    // the whole document. Keys must not need escaping.
+    class JsonWriter
+    {
+    public:
+      JsonWriter(char *out, size_t capacity, size_t skip = 0) : out_(out), capacity_(capacity), skip_(skip) {}
+
+      void begin_object(const char *key = nullptr);
+      void end_object();
+      void add(const char *key, float value); // NAN is written as null
+      void add(const char *key, uint32_t value);
+      void add(const char *key, bool value);
+      void add(const char *key, const char *value); // not escaped
+
+      // Total document length so far, and the bytes that landed in the window
+      size_t length() const { return pos_; }
+      size_t written() const;
+      bool truncated() const { return pos_ > skip_ + capacity_; }
+
+    protected:
+      static const uint8_t MAX_DEPTH = 6;
+
+      void key(const char *name);
+      void raw(const char *data, size_t length);
+      void raw(const char *data);
+
+      char *out_;
+      size_t capacity_;
+      size_t skip_;
+      size_t pos_{0};
+      uint8_t depth_{0};
+      bool first_[MAX_DEPTH]{};
+    };
+
+    // Copy of the gateway state taken when a snapshot request starts, so every
+    // chunk of one response is generated from the same values
+    struct GatewaySnapshot
+    {
+      static const uint8_t MAX_VALUES = 12;
+
+      struct Value
+      {
+        const char *name;
+        float value;
+        uint32_t age_ms;
+        const char *source; // sniffed, polled or none
+        bool stale;         // older than its freshness target
+        uint32_t out_of_target_s;
+      };
+
+      struct Override
+      {
+        bool active;
+        float setpoint;
+        uint32_t expires_in_ms;
+      };
+
+      uint32_t uptime_ms;
+      uint16_t status;
+      bool fault;
+      bool ch_active;
+      bool dhw_active;
+      bool flame;
+      bool diagnostic;
+
+      Value values[MAX_VALUES];
+      uint8_t value_count;
+
+      Override dhw_override;
+      Override heating_override;
+
+      float max_ch_setpoint;
+      float max_modulation;
+
+      uint32_t deadline_misses;
+      uint32_t max_response_time_ms;
+      uint32_t dropped_frames;
+      uint32_t commands_queued;
+      uint32_t commands_merged;
+
+      bool listen_only;
+      uint32_t observed_ids;
+      float bus_utilization; // percent of the boiler line
+      uint32_t deferred_polls;
+    };
+
+    void write_snapshot_json(const GatewaySnapshot &snapshot, JsonWriter &writer);
+
+#ifdef USE_WEBSERVER
+    // GET /opentherm/snapshot - whole gateway state as one JSON document. Every
+    // response streams its own copy of the state, overlapping requests don't mix.
+    class SnapshotHandler : public AsyncWebHandler
+    {
+    public:
+      typedef void (*CaptureCallback)(void *context, GatewaySnapshot &snapshot);
+
+      SnapshotHandler(CaptureCallback capture, void *context) : capture_(capture), context_(context) {}
+
+      bool canHandle(AsyncWebServerRequest *request) override;
+      void handleRequest(AsyncWebServerRequest *request) override;
+
+    protected:
+      CaptureCallback capture_;
+      void *context_;
+#ifndef USE_ARDUINO
+      // The ESP-IDF server handles one request at a time, so a single buffer is enough
+      static const size_t BUFFER_SIZE = 2048;
+      char buffer_[BUFFER_SIZE];
+#endif
+    };
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,293 @@
+#include "opentherm_table_sync.h"
+#include "esphome/core/log.h"
+#include <cinttypes>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.tables";
+
+    // Preference hash of the TSP table, the fault history uses PREFERENCE_HASH + 1
+    static const uint32_t PREFERENCE_HASH = 0x4F545453; // "OTTS"
+
+    const char *sync_table_name(SyncTable table)
+    {
+      switch (table)
+      {
+      case SyncTable::TSP:
+        return "tsp";
+      case SyncTable::FHB:
+        return "fault_history";
+      case SyncTable::COUNT:
+        break;
+      }
+      return "unknown";
+    }
+
+    static const char *state_name(TableSync::State state)
+    {
+      switch (state)
+      {
+      case TableSync::State::DISABLED:
+        return "disabled";
+      case TableSync::State::SIZE:
+        return "size";
+      case TableSync::State::READ:
+        return "read";
+      case TableSync::State::VERIFY:
+        return "verify";
+      case TableSync::State::DONE:
+        return "done";
+      case TableSync::State::FAILED:
+        return "failed";
+      }
+      return "unknown";
+    }
+
+    uint32_t TableSync::checksum(const Table &table)
+    {
+      // FNV-1a over everything after the checksum itself
+      const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&table) + sizeof(table.checksum);
+      uint32_t hash = 2166136261UL;
+      for (size_t i = 0; i < sizeof(Table) - sizeof(table.checksum); i++)
+      {
+        hash ^= bytes[i];
+        hash *= 16777619UL;
+      }
+      return hash;
+    }
+
+    void TableSync::setup()
+    {
+      for (uint8_t i = 0; i < static_cast<uint8_t>(SyncTable::COUNT); i++)
+      {
+        if (!enabled_[i])
+          continue;
+        Sync &sync = tables_[i];
+        sync.state = State::SIZE;
+        sync.preference = global_preferences->make_preference<Table>(PREFERENCE_HASH + i, true);
+
+        Table &table = sync.table;
+        uint8_t expected = 0;
+        if (sync.preference.load(&table))
+          expected = table.size < MAX_ENTRIES ? table.size : MAX_ENTRIES;
+        // An empty slot leaves the table zeroed, which fails the checksum as well
+        if (table.checksum != checksum(table) || table.count != expected)
+        {
+          table = Table{};
+          continue;
+        }
+        if (table.next_sample >= table.count)
+          table.next_sample = 0;
+        sync.stored = true;
+        ESP_LOGI(TAG, "Stored %s table: %u entries", sync_table_name(static_cast<SyncTable>(i)), table.count);
+      }
+    }
+
+    TableSync::Sync *TableSync::current()
+    {
+      for (auto &sync : tables_)
+      {
+        if (sync.state == State::SIZE || sync.state == State::READ || sync.state == State::VERIFY)
+          return &sync;
+      }
+      return nullptr;
+    }
+
+    bool TableSync::is_done() const
+    {
+      for (const auto &sync : tables_)
+      {
+        if (sync.state == State::SIZE || sync.state == State::READ || sync.state == State::VERIFY)
+          return false;
+      }
+      return true;
+    }
+
+    bool TableSync::has_values(SyncTable table) const
+    {
+      const Sync &sync = tables_[static_cast<uint8_t>(table)];
+      return sync.state == State::DONE || sync.stored;
+    }
+
+    float TableSync::get_progress() const
+    {
+      float total = 0;
+      uint8_t enabled = 0;
+      for (uint8_t i = 0; i < static_cast<uint8_t>(SyncTable::COUNT); i++)
+      {
+        if (!enabled_[i])
+          continue;
+        const Sync &sync = tables_[i];
+        uint8_t sample = sync.table.count < sample_ ? sync.table.count : sample_;
+        enabled++;
+        if (sync.state == State::DONE || sync.state == State::FAILED)
+          total += 1.0f;
+        else if (sync.state == State::READ && sync.table.count != 0)
+          total += static_cast<float>(sync.done) / sync.table.count;
+        else if (sync.state == State::VERIFY && sample != 0)
+          total += static_cast<float>(sync.done) / sample;
+      }
+      return enabled != 0 ? total * 100.0f / enabled : 100.0f;
+    }
+
+    bool TableSync::next_request(uint8_t &id, uint16_t &data)
+    {
+      Sync *sync = current();
+      if (sync == nullptr)
+        return false;
+
+      SyncTable table = static_cast<SyncTable>(sync - tables_);
+      if (sync->state == State::SIZE)
+      {
+        id = size_id(table);
+        data = 0;
+      }
+      else
+      {
+        // The entry index goes in the high byte, the boiler answers with the value in the low byte
+        id = entry_id(table);
+        data = static_cast<uint16_t>(sync->index) << 8;
+      }
+      return true;
+    }
+
+    void TableSync::on_response(bool valid, uint16_t data)
+    {
+      Sync *sync = current();
+      if (sync == nullptr)
+        return;
+      frames_++;
+
+      SyncTable table = static_cast<SyncTable>(sync - tables_);
+      const char *name = sync_table_name(table);
+      // Entry replies have to echo the index that was asked for
+      if (!valid || (sync->state != State::SIZE && (data >> 8) != sync->index))
+      {
+        if (++sync->failures < MAX_FAILURES)
+          return;
+        ESP_LOGW(TAG, "%s table: no valid reply to %s after %u tries, giving up until reboot", name,
+                 state_name(sync->state), MAX_FAILURES);
+        sync->state = State::FAILED;
+        return;
+      }
+      sync->failures = 0;
+
+      Table &stored = sync->table;
+      uint8_t value = data & 0xFF;
+      switch (sync->state)
+      {
+      case State::SIZE:
+      {
+        uint8_t size = data >> 8;
+        if (sync->stored && size == stored.size)
+        {
+          sync->state = State::VERIFY;
+          sync->index = stored.next_sample;
+          sync->done = 0;
+          if (stored.count == 0 || sample_ == 0)
+            finish(*sync, table);
+          return;
+        }
+        if (sync->stored)
+          ESP_LOGI(TAG, "%s table size changed from %u to %u entries", name, stored.size, size);
+        if (size > MAX_ENTRIES)
+          ESP_LOGW(TAG, "%s table has %u entries, syncing the first %u", name, size, MAX_ENTRIES);
+        stored = Table{};
+        stored.size = size;
+        stored.count = size < MAX_ENTRIES ? size : MAX_ENTRIES;
+        start_read(*sync);
+        if (stored.count == 0)
+          finish(*sync, table);
+        return;
+      }
+      case State::READ:
+        stored.values[sync->index++] = value;
+        sync->done++;
+        if (sync->index == stored.count)
+          finish(*sync, table);
+        return;
+      case State::VERIFY:
+        if (stored.values[sync->index] != value)
+        {
+          ESP_LOGI(TAG, "%s entry %u changed from %u to %u, reading the table again", name, sync->index,
+                   stored.values[sync->index], value);
+          start_read(*sync);
+          return;
+        }
+        sync->index = (sync->index + 1) % stored.count;
+        sync->done++;
+        if (sync->done == (stored.count < sample_ ? stored.count : sample_))
+        {
+          stored.next_sample = sync->index;
+          finish(*sync, table);
+        }
+        return;
+      default:
+        return;
+      }
+    }
+
+    void TableSync::start_read(Sync &sync)
+    {
+      sync.state = State::READ;
+      sync.stored = false;
+      sync.index = 0;
+      sync.done = 0;
+    }
+
+    void TableSync::finish(Sync &sync, SyncTable table)
+    {
+      if (sync.stored)
+        ESP_LOGI(TAG, "%s table verified: %u of %u entries match", sync_table_name(table), sync.done, sync.table.count);
+      else
+        ESP_LOGI(TAG, "%s table synced: %u entries, %" PRIu32 " frames so far", sync_table_name(table),
+                 sync.table.count, frames_);
+      sync.state = State::DONE;
+      sync.stored = false;
+      save(sync, table);
+    }
+
+    void TableSync::save(Sync &sync, SyncTable table)
+    {
+      sync.table.checksum = checksum(sync.table);
+      if (!sync.preference.save(&sync.table) || !global_preferences->sync())
+        ESP_LOGE(TAG, "Could not save %s table", sync_table_name(table));
+    }
+
+#ifdef USE_WEBSERVER
+    bool TableExportHandler::canHandle(AsyncWebServerRequest *request)
+    {
+      return request->method() == HTTP_GET && request->url() == "/opentherm/tables";
+    }
+
+    void TableExportHandler::handleRequest(AsyncWebServerRequest *request)
+    {
+      AsyncResponseStream *stream = request->beginResponseStream("text/csv");
+      stream->printf("# frames=%u progress=%.0f\n", static_cast<unsigned>(sync_->get_frames()), sync_->get_progress());
+      for (uint8_t i = 0; i < static_cast<uint8_t>(SyncTable::COUNT); i++)
+      {
+        SyncTable table = static_cast<SyncTable>(i);
+        if (sync_->get_state(table) == TableSync::State::DISABLED)
+          continue;
+        stream->printf("# %s state=%s size=%u\n", sync_table_name(table), state_name(sync_->get_state(table)),
+                       sync_->get_table(table).size);
+      }
+      stream->print("table,index,value\n");
+      for (uint8_t i = 0; i < static_cast<uint8_t>(SyncTable::COUNT); i++)
+      {
+        SyncTable table = static_cast<SyncTable>(i);
+        if (!sync_->has_values(table))
+          continue;
+        const TableSync::Table &values = sync_->get_table(table);
+        for (uint8_t index = 0; index < values.count; index++)
+          stream->printf("%s,%u,%u\n", sync_table_name(table), index, values.values[index]);
+      }
+      request->send(stream);
+    }
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "esphome/core/preferences.h"
+
+#ifdef USE_WEBSERVER
+#include "esphome/components/web_server_base/web_server_base.h"
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    enum class SyncTable : uint8_t
+    {
+      TSP, // Transparent Slave Parameters, size in ID 10, entries in ID 11
+      FHB, // Fault history buffer, size in ID 12, entries in ID 13
+      COUNT
+    };
+
+    const char *sync_table_name(SyncTable table);
+
+    // Background copy of the boiler's indexed tables. Each table costs one READ
+    // per entry, so the sync hands out a few requests at a time and the caller
+    // sends them when the bus is idle. A complete table is kept in a flash
+    // preference slot with a checksum; on later boots it is served from there
+    // at once, and only its size and a rotating sample of entries are read back
+    // to detect changes. A size change or a mismatch starts a full read again.
+    // A table the boiler does not support, or keeps failing to read, is given up
+    // until the next boot. Used from loop() only.
+    class TableSync
+    {
+    public:
+      static const uint8_t MAX_ENTRIES = 128; // larger tables are synced up to this index
+      static const uint8_t MAX_FAILURES = 3;  // in a row, before a table is given up
+
+      enum class State : uint8_t
+      {
+        DISABLED,
+        SIZE,   // reading the table size
+        READ,   // reading every entry
+        VERIFY, // reading back the sample of a stored table
+        DONE,
+        FAILED,
+      };
+
+      // Stored as is, 136 bytes per table
+      struct Table
+      {
+        uint32_t checksum;   // over the rest of the struct
+        uint8_t size;        // entries reported by the boiler
+        uint8_t count;       // entries held, size capped at MAX_ENTRIES
+        uint8_t next_sample; // first index verified on the next boot
+        uint8_t reserved;
+        uint8_t values[MAX_ENTRIES];
+      };
+
+      void configure(bool tsp, bool fhb, uint8_t batch, uint8_t sample)
+      {
+        enabled_[static_cast<uint8_t>(SyncTable::TSP)] = tsp;
+        enabled_[static_cast<uint8_t>(SyncTable::FHB)] = fhb;
+        batch_ = batch;
+        sample_ = sample;
+      }
+      bool is_configured() const { return batch_ != 0; }
+      uint8_t get_batch() const { return batch_; }
+
+      // Loads the stored tables and picks where each one starts
+      void setup();
+      bool is_done() const;
+
+      // Data ID and data-value of the next READ to send, false if nothing is left.
+      // The same request is handed out until on_response() is called.
+      bool next_request(uint8_t &id, uint16_t &data);
+      // Outcome of that READ, data is the reply's data-value
+      void on_response(bool valid, uint16_t data);
+
+      State get_state(SyncTable table) const { return tables_[static_cast<uint8_t>(table)].state; }
+      // Entries and values, valid once the table is DONE or served from flash
+      const Table &get_table(SyncTable table) const { return tables_[static_cast<uint8_t>(table)].table; }
+      bool has_values(SyncTable table) const;
+      // Share of the work done across the enabled tables, 0-100
+      float get_progress() const;
+      // Boiler exchanges spent on the sync since boot
+      uint32_t get_frames() const { return frames_; }
+
+    protected:
+      struct Sync
+      {
+        State state{State::DISABLED};
+        Table table{};
+        bool stored{false};   // table came from flash and still has to be verified
+        uint8_t index{0};     // next entry to read or verify
+        uint8_t done{0};      // entries read or verified in this pass
+        uint8_t failures{0};
+        ESPPreferenceObject preference;
+      };
+
+      static uint32_t checksum(const Table &table);
+      static uint8_t size_id(SyncTable table) { return table == SyncTable::TSP ? 10 : 12; }
+      static uint8_t entry_id(SyncTable table) { return table == SyncTable::TSP ? 11 : 13; }
+
+      Sync *current();
+      void start_read(Sync &sync);
+      void finish(Sync &sync, SyncTable table);
+      void save(Sync &sync, SyncTable table);
+
+      bool enabled_[static_cast<uint8_t>(SyncTable::COUNT)]{};
+      Sync tables_[static_cast<uint8_t>(SyncTable::COUNT)];
+      uint8_t batch_{0};
+      uint8_t sample_{0};
+      uint32_t frames_{0};
+    };
+
+#ifdef USE_WEBSERVER
+    // GET /opentherm/tables - synced tables as CSV, one line per entry
+    class TableExportHandler : public AsyncWebHandler
+    {
+    public:
+      explicit TableExportHandler(const TableSync *sync) : sync_(sync) {}
+
+      bool canHandle(AsyncWebServerRequest *request) override;
+      void handleRequest(AsyncWebServerRequest *request) override;
+
+    protected:
+      const TableSync *sync_;
+    };
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
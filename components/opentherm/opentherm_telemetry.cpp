@@ -0,0 +1,115 @@
+#include "opentherm_telemetry.h"
+#include "esphome/core/log.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.telemetry";
+
+    static inline void put_u16(uint8_t *dst, uint16_t value)
+    {
+      dst[0] = value & 0xFF;
+      dst[1] = value >> 8;
+    }
+
+    static inline void put_u32(uint8_t *dst, uint32_t value)
+    {
+      put_u16(dst, value & 0xFFFF);
+      put_u16(dst + 2, value >> 16);
+    }
+
+    bool TelemetryStream::setup()
+    {
+#ifdef USE_SOCKET_IMPL_LWIP_TCP
+      if (!destination_.fromString(host_.c_str()))
+      {
+        ESP_LOGE(TAG, "Invalid telemetry destination %s:%u", host_.c_str(), port_);
+        return false;
+      }
+#else
+      socket_ = socket::socket_ip(SOCK_DGRAM, IPPROTO_UDP);
+      if (socket_ == nullptr)
+      {
+        ESP_LOGE(TAG, "Could not create telemetry socket");
+        return false;
+      }
+      socket_->setblocking(false);
+
+      destination_len_ = socket::set_sockaddr(reinterpret_cast<struct sockaddr *>(&destination_),
+                                              sizeof(destination_), host_, port_);
+      if (destination_len_ == 0)
+      {
+        ESP_LOGE(TAG, "Invalid telemetry destination %s:%u", host_.c_str(), port_);
+        socket_ = nullptr;
+        return false;
+      }
+#endif
+
+      ready_ = true;
+      ESP_LOGI(TAG, "Streaming telemetry to %s:%u", host_.c_str(), port_);
+      return true;
+    }
+
+    void TelemetryStream::add(uint8_t id, uint16_t value, uint32_t now)
+    {
+      if (!ready_)
+        return;
+
+      // Start a new datagram when full or when the delta no longer fits 16 bits
+      if (count_ != 0 && (length_ + RECORD_SIZE > max_size_ || now - base_ms_ > 0xFFFF || count_ == 0xFF))
+        flush();
+
+      if (count_ == 0)
+        base_ms_ = now;
+
+      uint8_t *record = buffer_ + length_;
+      record[0] = id;
+      put_u16(record + 1, now - base_ms_);
+      put_u16(record + 3, value);
+      length_ += RECORD_SIZE;
+      count_++;
+    }
+
+    void TelemetryStream::loop(uint32_t now)
+    {
+      if (count_ != 0 && now - base_ms_ >= max_age_)
+        flush();
+    }
+
+    void TelemetryStream::flush()
+    {
+      buffer_[0] = 'O';
+      buffer_[1] = 'T';
+      buffer_[2] = VERSION;
+      buffer_[3] = count_;
+      put_u16(buffer_ + 4, sequence_++);
+      put_u32(buffer_ + 6, base_ms_);
+
+#ifdef USE_SOCKET_IMPL_LWIP_TCP
+      bool sent = udp_.beginPacket(destination_, port_) == 1 && udp_.write(buffer_, length_) == length_ &&
+                  udp_.endPacket() == 1;
+#else
+      ssize_t result = socket_->sendto(buffer_, length_, 0, reinterpret_cast<struct sockaddr *>(&destination_),
+                                       destination_len_);
+      bool sent = result == static_cast<ssize_t>(length_);
+#endif
+      if (sent)
+      {
+        datagrams_sent_++;
+        records_sent_ += count_;
+      }
+      else
+      {
+        // Never retry - telemetry is best effort and must not back up the bus path
+        send_errors_++;
+        ESP_LOGV(TAG, "Telemetry send failed");
+      }
+
+      length_ = HEADER_SIZE;
+      count_ = 0;
+    }
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#ifdef USE_SOCKET_IMPL_LWIP_TCP
+#include <WiFiUdp.h>
+#else
+#include "esphome/components/socket/socket.h"
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Batches decoded frames into compact UDP datagrams (all fields little-endian):
+    //   header:  'O' 'T' version:u8 count:u8 sequence:u16 base_ms:u32
+    //   records: data_id:u8 delta_ms:u16 value:u16   (delta from base_ms)
+    // A datagram is sent when it is full or its oldest record reaches max_age.
+    // The buffer and socket are set up once, sending does not allocate. The
+    // lwip_tcp socket backend (ESPHome's default on ESP8266) has no UDP, there
+    // the datagrams go out through the Arduino core's WiFiUDP, which allocates
+    // a packet buffer per datagram.
+    class TelemetryStream
+    {
+    public:
+      static const uint8_t VERSION = 1;
+      static const size_t HEADER_SIZE = 10;
+      static const size_t RECORD_SIZE = 5;
+      // Stays below the minimum IPv4 reassembly size, so datagrams are never fragmented
+      static const size_t MAX_DATAGRAM_SIZE = 508;
+
+      void configure(const std::string &host, uint16_t port, size_t max_size, uint32_t max_age)
+      {
+        host_ = host;
+        port_ = port;
+        max_size_ = max_size < MAX_DATAGRAM_SIZE ? max_size : MAX_DATAGRAM_SIZE;
+        max_age_ = max_age;
+      }
+      bool is_configured() const { return port_ != 0; }
+
+      bool setup();
+      void add(uint8_t id, uint16_t value, uint32_t now);
+      void loop(uint32_t now);
+
+      uint32_t get_datagrams_sent() const { return datagrams_sent_; }
+      uint32_t get_records_sent() const { return records_sent_; }
+      uint32_t get_send_errors() const { return send_errors_; }
+
+    protected:
+      void flush();
+
+      std::string host_;
+      uint16_t port_{0};
+      size_t max_size_{MAX_DATAGRAM_SIZE};
+      uint32_t max_age_{5000};
+
+#ifdef USE_SOCKET_IMPL_LWIP_TCP
+      WiFiUDP udp_;
+      IPAddress destination_;
+#else
+      std::unique_ptr<socket::Socket> socket_;
+      struct sockaddr_storage destination_{};
+      socklen_t destination_len_{0};
+#endif
+      bool ready_{false};
+
+      uint8_t buffer_[MAX_DATAGRAM_SIZE];
+      size_t length_{HEADER_SIZE};
+      uint8_t count_{0};
+      uint16_t sequence_{0};
+      uint32_t base_ms_{0};
+
+      uint32_t datagrams_sent_{0};
+      uint32_t records_sent_{0};
+      uint32_t send_errors_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,135 @@
+#include "opentherm_timer_wheel.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    void TimerWheel::link(Timer *&head, Timer &timer)
+    {
+      timer.next_ = head;
+      if (head != nullptr)
+        head->pprev_ = &timer.next_;
+      head = &timer;
+      timer.pprev_ = &head;
+    }
+
+    void TimerWheel::unlink(Timer &timer)
+    {
+      *timer.pprev_ = timer.next_;
+      if (timer.next_ != nullptr)
+        timer.next_->pprev_ = timer.pprev_;
+      timer.next_ = nullptr;
+      timer.pprev_ = nullptr;
+    }
+
+    void TimerWheel::file(Timer &timer)
+    {
+      uint64_t delta = timer.expires_ > current_ ? timer.expires_ - current_ : 0;
+      for (uint8_t level = 0; level < LEVELS; level++)
+      {
+        if (delta < (1ULL << (SLOT_BITS * (level + 1))))
+        {
+          link(slots_[level][(timer.expires_ >> (SLOT_BITS * level)) & SLOT_MASK], timer);
+          return;
+        }
+      }
+      // Beyond the wheel: park in the farthest top-level slot, re-filed from there
+      uint64_t horizon = current_ + (1ULL << (SLOT_BITS * LEVELS)) - 1;
+      link(slots_[LEVELS - 1][(horizon >> (SLOT_BITS * (LEVELS - 1))) & SLOT_MASK], timer);
+    }
+
+    void TimerWheel::schedule(Timer &timer, uint32_t delay_ms)
+    {
+      if (timer.is_armed())
+        unlink(timer);
+      else
+        armed_++;
+      // current_ may be up to a tick behind the caller, one extra tick keeps it from firing early
+      timer.expires_ = current_ + delay_ms / TICK_MS + 1;
+      file(timer);
+    }
+
+    void TimerWheel::cancel(Timer &timer)
+    {
+      if (!timer.is_armed())
+        return;
+      unlink(timer);
+      armed_--;
+    }
+
+    uint32_t TimerWheel::remaining_ms(const Timer &timer) const
+    {
+      if (!timer.is_armed() || timer.expires_ <= current_)
+        return 0;
+      uint64_t remaining = (timer.expires_ - current_) * TICK_MS;
+      return remaining > UINT32_MAX ? UINT32_MAX : remaining;
+    }
+
+    void TimerWheel::cascade(uint8_t level)
+    {
+      Timer *&slot = slots_[level][(current_ >> (SLOT_BITS * level)) & SLOT_MASK];
+      if (slot == nullptr)
+        return;
+      Timer *pending = slot;
+      slot = nullptr;
+      pending->pprev_ = &pending;
+      while (pending != nullptr)
+      {
+        Timer &timer = *pending;
+        unlink(timer);
+        file(timer);
+      }
+    }
+
+    void TimerWheel::fire_slot()
+    {
+      Timer *&slot = slots_[0][current_ & SLOT_MASK];
+      if (slot == nullptr)
+        return;
+      Timer *pending = slot;
+      slot = nullptr;
+      pending->pprev_ = &pending;
+      // Callbacks may arm or cancel any timer, including the ones still pending here
+      while (pending != nullptr)
+      {
+        Timer &timer = *pending;
+        unlink(timer);
+        if (timer.expires_ > current_)
+        {
+          file(timer);
+          continue;
+        }
+        armed_--;
+        fired_++;
+        if (timer.callback_ != nullptr)
+          timer.callback_(timer.context_);
+      }
+    }
+
+    void TimerWheel::advance(uint64_t now_ms)
+    {
+      uint64_t target = now_ms / TICK_MS;
+      if (armed_ == 0)
+      {
+        // Nothing to fire on the way
+        if (target > current_)
+          current_ = target;
+        return;
+      }
+      while (current_ < target)
+      {
+        current_++;
+        // Each level comes round once per full turn of the level below
+        for (uint8_t level = 1; level < LEVELS; level++)
+        {
+          if (((current_ >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0)
+            break;
+          cascade(level);
+        }
+        fire_slot();
+      }
+    }
+
+  } // namespace opentherm
+} // namespace esphome
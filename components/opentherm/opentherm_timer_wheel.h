@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Milliseconds since boot on 64 bits. millis() wraps after 49.7 days; each
+    // reading is compared with the previous one and a wrap carries into the
+    // upper half, so extend() has to run at least once per wrap period.
+    class MonotonicClock
+    {
+    public:
+      uint64_t extend(uint32_t millis_now)
+      {
+        if (millis_now < last_)
+          high_ += 1ULL << 32;
+        last_ = millis_now;
+        return high_ | millis_now;
+      }
+
+    protected:
+      uint64_t high_{0};
+      uint32_t last_{0};
+    };
+
+    // Hierarchical timer wheel with TICK_MS resolution. Level 0 has one slot per
+    // tick, each higher level one slot per full turn of the level below, so arming,
+    // cancelling and firing a timer are O(1); a timer moves down at most once per
+    // level. Timers are intrusive and owned by their users, the wheel never
+    // allocates. Deadlines beyond the top level are parked in its last slot and
+    // re-filed when it comes round. A timer never fires early and at most one tick
+    // late, plus however long advance() was not called. Not thread-safe, used from
+    // the loop() task only.
+    class TimerWheel
+    {
+    public:
+      typedef void (*Callback)(void *context);
+
+      static const uint32_t TICK_MS = 100;
+      static const uint8_t LEVELS = 4;
+      static const uint8_t SLOT_BITS = 5;
+      static const uint8_t SLOTS = 1 << SLOT_BITS;
+
+      class Timer
+      {
+      public:
+        // Without a callback a timer is a plain deadline, polled with is_armed()
+        Timer() = default;
+        Timer(Callback callback, void *context) : callback_(callback), context_(context) {}
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+        bool is_armed() const { return pprev_ != nullptr; }
+
+      protected:
+        friend class TimerWheel;
+
+        Timer *next_{nullptr};
+        Timer **pprev_{nullptr}; // link pointing at this timer, nullptr = not armed
+        uint64_t expires_{0};    // in ticks
+        Callback callback_{nullptr};
+        void *context_{nullptr};
+      };
+
+      // Fires every timer due by now_ms, tick by tick
+      void advance(uint64_t now_ms);
+      // (Re)arms the timer to fire delay_ms after the last advance()
+      void schedule(Timer &timer, uint32_t delay_ms);
+      void cancel(Timer &timer);
+
+      // Time left until the timer fires, 0 if it is not armed
+      uint32_t remaining_ms(const Timer &timer) const;
+      uint64_t now_ms() const { return current_ * TICK_MS; }
+      uint16_t get_armed() const { return armed_; }
+      uint32_t get_fired() const { return fired_; }
+
+    protected:
+      static const uint32_t SLOT_MASK = SLOTS - 1;
+
+      static void link(Timer *&head, Timer &timer);
+      static void unlink(Timer &timer);
+      // Files the timer in the slot its deadline falls in, seen from current_
+      void file(Timer &timer);
+      // Moves one slot of a higher level down to the levels below
+      void cascade(uint8_t level);
+      void fire_slot();
+
+      Timer *slots_[LEVELS][SLOTS]{};
+      uint64_t current_{0}; // last tick processed
+      uint16_t armed_{0};
+      uint32_t fired_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
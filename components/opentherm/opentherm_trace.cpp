@@ -0,0 +1,154 @@
+#include "opentherm_trace.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.trace";
+
+    const char *span_event_name(SpanEvent event)
+    {
+      switch (event)
+      {
+      case SpanEvent::ACCEPTED:
+        return "accepted";
+      case SpanEvent::MERGED:
+        return "merged";
+      case SpanEvent::STARTED:
+        return "started";
+      case SpanEvent::IGNORED:
+        return "ignored";
+      case SpanEvent::OVERRIDE:
+        return "override";
+      case SpanEvent::WRITTEN:
+        return "written";
+      case SpanEvent::VERIFIED:
+        return "verified";
+      case SpanEvent::CLAMPED:
+        return "clamped";
+      case SpanEvent::FAILED:
+        return "failed";
+      case SpanEvent::REWRITTEN:
+        return "rewritten";
+      case SpanEvent::EXPIRED:
+        return "expired";
+      case SpanEvent::CANCELLED:
+        return "cancelled";
+      }
+      return "unknown";
+    }
+
+    const char *command_type_name(CommandType type)
+    {
+      switch (type)
+      {
+      case CommandType::BOILER_RESET:
+        return "boiler_reset";
+      case CommandType::DHW_SETPOINT:
+        return "dhw_setpoint";
+      case CommandType::ROOM_SETPOINT:
+        return "room_setpoint";
+      default:
+        return "unknown";
+      }
+    }
+
+    uint16_t CommandTracer::begin(CommandType type, float value, uint32_t now)
+    {
+      uint16_t command = next_command_++;
+      if (next_command_ == 0)
+        next_command_ = 1;
+
+      // Reuse the least recently active span
+      Span *slot = &open_[0];
+      for (Span &span : open_)
+      {
+        if (span.command == 0)
+        {
+          slot = &span;
+          break;
+        }
+        if (span.previous_at - slot->previous_at > UINT32_MAX / 2)
+          slot = &span; // older than the current pick, wrap-safe
+      }
+      *slot = Span{command, type, now, now};
+      record(*slot, SpanEvent::ACCEPTED, value, now);
+      return command;
+    }
+
+    void CommandTracer::add(uint16_t command, SpanEvent event, float value, uint32_t now)
+    {
+      if (command == 0)
+        return;
+
+      for (Span &span : open_)
+      {
+        if (span.command == command)
+        {
+          record(span, event, value, now);
+          span.previous_at = now;
+          return;
+        }
+      }
+
+      // Evicted from the open table: the event is kept, without durations
+      Event &entry = ring_[count_ % RING_SIZE];
+      entry = Event{now, UNKNOWN, UNKNOWN, value, command, CommandType::COUNT, event};
+      count_++;
+      ESP_LOGD(TAG, "#%u %s", command, span_event_name(event));
+    }
+
+    void CommandTracer::record(const Span &span, SpanEvent event, float value, uint32_t now)
+    {
+      Event &entry = ring_[count_ % RING_SIZE];
+      entry = Event{now, now - span.accepted_at, now - span.previous_at, value, span.command, span.type, event};
+      count_++;
+      ESP_LOGD(TAG, "#%u %s %s %.1f (+%u ms, %u ms since accepted)", span.command, command_type_name(span.type),
+               span_event_name(event), value, static_cast<unsigned>(entry.since_previous_ms),
+               static_cast<unsigned>(entry.since_accepted_ms));
+    }
+
+    void CommandTracer::for_each(EventCallback callback, void *context) const
+    {
+      uint32_t first = count_ > RING_SIZE ? count_ - RING_SIZE : 0;
+      for (uint32_t i = first; i < count_; i++)
+        callback(context, ring_[i % RING_SIZE]);
+    }
+
+#ifdef USE_WEBSERVER
+    bool TraceExportHandler::canHandle(AsyncWebServerRequest *request)
+    {
+      return request->method() == HTTP_GET && request->url() == "/opentherm/trace";
+    }
+
+    static void write_event(void *context, const CommandTracer::Event &event)
+    {
+      auto *stream = static_cast<AsyncResponseStream *>(context);
+      stream->printf("%u,%s,%s,%u,", event.command, command_type_name(event.type), span_event_name(event.event),
+                     static_cast<unsigned>(event.at_ms));
+      // Durations are left empty for commands that dropped out of the open table
+      if (event.since_accepted_ms != CommandTracer::UNKNOWN)
+        stream->printf("%u,%u,", static_cast<unsigned>(event.since_accepted_ms),
+                       static_cast<unsigned>(event.since_previous_ms));
+      else
+        stream->print(",,");
+      stream->printf("%.1f\n", event.value);
+    }
+
+    void TraceExportHandler::handleRequest(AsyncWebServerRequest *request)
+    {
+      // Read without locking: an event being written meanwhile may come out torn
+      AsyncResponseStream *stream = request->beginResponseStream("text/csv");
+      stream->printf("# now_ms=%u events=%u\n", static_cast<unsigned>(millis()),
+                     static_cast<unsigned>(tracer_->get_count()));
+      stream->print("command,type,event,at_ms,since_accepted_ms,since_previous_ms,value\n");
+      tracer_->for_each(write_event, stream);
+      request->send(stream);
+    }
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
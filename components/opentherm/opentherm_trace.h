@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "opentherm_command_queue.h"
+
+#ifdef USE_WEBSERVER
+#include "esphome/components/web_server_base/web_server_base.h"
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Steps a user command goes through, from Home Assistant to the boiler
+    enum class SpanEvent : uint8_t
+    {
+      ACCEPTED,   // queued by the climate / button
+      MERGED,     // replaced by a newer command for the same target before it ran
+      STARTED,    // taken from the queue
+      IGNORED,    // startup restore, or matches the thermostat's own setpoint
+      OVERRIDE,   // override of the thermostat's setpoint activated
+      WRITTEN,    // boiler acknowledged the write
+      VERIFIED,   // read back from the boiler
+      CLAMPED,    // read back more than 1 degree off the request
+      FAILED,     // no valid boiler reply
+      REWRITTEN,  // first thermostat frame rewritten by the override
+      EXPIRED,    // override timed out
+      CANCELLED,  // override ended by the thermostat or a newer command
+    };
+
+    const char *span_event_name(SpanEvent event);
+    const char *command_type_name(CommandType type);
+
+    // Fixed ring of span events. Every command gets an ID when it is accepted;
+    // its later events carry the time since acceptance and since its previous
+    // event, looked up in a small table of recently active commands.
+    // Writers hold the bus lock, so the bus task and loop() never interleave.
+    class CommandTracer
+    {
+    public:
+      static const uint8_t RING_SIZE = 48;
+      static const uint8_t OPEN_SPANS = 8;
+      static const uint32_t UNKNOWN = UINT32_MAX; // command no longer in the open table
+
+      struct Event
+      {
+        uint32_t at_ms;
+        uint32_t since_accepted_ms;
+        uint32_t since_previous_ms;
+        float value;
+        uint16_t command;
+        CommandType type;
+        SpanEvent event;
+      };
+
+      typedef void (*EventCallback)(void *context, const Event &event);
+
+      // Starts a command and records ACCEPTED, returns its ID (never 0)
+      uint16_t begin(CommandType type, float value, uint32_t now);
+      // Ignored for command 0, so callers need not check for an active trace
+      void add(uint16_t command, SpanEvent event, float value, uint32_t now);
+
+      // Oldest first
+      void for_each(EventCallback callback, void *context) const;
+      uint32_t get_count() const { return count_; }
+
+    protected:
+      struct Span
+      {
+        uint16_t command;
+        CommandType type;
+        uint32_t accepted_at;
+        uint32_t previous_at;
+      };
+
+      void record(const Span &span, SpanEvent event, float value, uint32_t now);
+
+      Event ring_[RING_SIZE]{};
+      uint32_t count_{0};
+      Span open_[OPEN_SPANS]{};
+      uint16_t next_command_{1};
+    };
+
+#ifdef USE_WEBSERVER
+    // GET /opentherm/trace - span events as CSV
+    class TraceExportHandler : public AsyncWebHandler
+    {
+    public:
+      explicit TraceExportHandler(const CommandTracer *tracer) : tracer_(tracer) {}
+
+      bool canHandle(AsyncWebServerRequest *request) override;
+      void handleRequest(AsyncWebServerRequest *request) override;
+
+    protected:
+      const CommandTracer *tracer_;
+    };
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,136 @@
+#include "opentherm_transmitter.h"
+#include "esphome/core/log.h"
+
+#ifdef USE_ESP8266
+#include <Arduino.h>
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    static const char *const TAG = "opentherm.transmitter";
+
+    // Never arm the timer closer than this, the callback needs time to return
+    static const int32_t MIN_ARM_US = 10;
+
+    FrameTransmitter *FrameTransmitter::active_ = nullptr;
+
+    bool FrameTransmitter::setup()
+    {
+#ifdef USE_ESP32
+#if !CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+      // Task dispatch adds a context switch per edge, far too late for 500 us half-bits
+      ESP_LOGE(TAG, "esp_timer ISR dispatch is not enabled (CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD)");
+      return false;
+#else
+      esp_timer_create_args_t args{};
+      args.callback = timer_callback;
+      args.arg = this;
+      args.dispatch_method = ESP_TIMER_ISR;
+      args.name = "opentherm_tx";
+      if (esp_timer_create(&args, &timer_) != ESP_OK)
+      {
+        ESP_LOGE(TAG, "Failed to create transmit timer");
+        return false;
+      }
+#endif
+#else
+      // timer1 is also the core's waveform generator (analogWrite, tone, Servo), nothing else may use it
+      timer1_isr_init();
+      timer1_attachInterrupt(timer_callback);
+#endif
+      active_ = this;
+      return true;
+    }
+
+    bool FrameTransmitter::start(int out_pin, uint32_t frame)
+    {
+      if (busy_)
+        return false;
+
+      // Merge equal consecutive half-bits into a single level/duration step
+      step_count_ = 0;
+      auto add_half = [this](bool active)
+      {
+        if (step_count_ > 0 && steps_[step_count_ - 1].active == active)
+          steps_[step_count_ - 1].duration_us += HALF_BIT_US;
+        else
+          steps_[step_count_++] = {HALF_BIT_US, active};
+      };
+      // A '1' is active for the first half bit and idle for the second half
+      auto add_bit = [&add_half](bool bit)
+      {
+        add_half(bit);
+        add_half(!bit);
+      };
+
+      add_bit(true); // Start bit
+      for (int i = 31; i >= 0; i--)
+        add_bit((frame >> i) & 1UL);
+      add_bit(true); // Stop bit
+
+      out_pin_ = out_pin;
+      step_index_ = 0;
+      busy_ = true;
+      frames_++;
+
+#ifdef USE_ESP8266
+      timer1_enable(TIM_DIV16, TIM_EDGE, TIM_SINGLE);
+#endif
+      next_edge_us_ = micros();
+      step();
+      return true;
+    }
+
+    void IRAM_ATTR FrameTransmitter::step()
+    {
+      int32_t lateness = static_cast<int32_t>(micros() - next_edge_us_);
+      if (lateness > 0 && static_cast<uint32_t>(lateness) > max_lateness_us_)
+        max_lateness_us_ = lateness;
+
+      if (step_index_ >= step_count_)
+      {
+        // Second half of the stop bit already left the line idle
+        digitalWrite(out_pin_, HIGH);
+        busy_ = false;
+#ifdef USE_ESP8266
+        timer1_disable();
+#endif
+        return;
+      }
+
+      const Step &current = steps_[step_index_];
+      step_index_ = step_index_ + 1;
+      digitalWrite(out_pin_, current.active ? LOW : HIGH); // Active level is LOW on the adapter output
+
+      next_edge_us_ += current.duration_us;
+      int32_t delay_us = static_cast<int32_t>(next_edge_us_ - micros());
+      arm(delay_us > MIN_ARM_US ? delay_us : MIN_ARM_US);
+    }
+
+    void IRAM_ATTR FrameTransmitter::arm(uint32_t delay_us)
+    {
+#ifdef USE_ESP32
+      esp_timer_start_once(timer_, delay_us);
+#else
+      timer1_write(delay_us * 5); // TIM_DIV16 at 80 MHz = 5 ticks/us
+#endif
+    }
+
+#ifdef USE_ESP32
+    void IRAM_ATTR FrameTransmitter::timer_callback(void *arg)
+    {
+      static_cast<FrameTransmitter *>(arg)->step();
+    }
+#else
+    void IRAM_ATTR FrameTransmitter::timer_callback()
+    {
+      if (active_ != nullptr)
+        active_->step();
+    }
+#endif
+
+  } // namespace opentherm
+} // namespace esphome
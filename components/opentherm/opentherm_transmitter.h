@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/hal.h"
+
+#ifdef USE_ESP32
+#include <esp_timer.h>
+#endif
+
+namespace esphome
+{
+  namespace opentherm
+  {
+
+    // Clocks a precomputed Manchester level/duration sequence out of a pin from a
+    // hardware timer interrupt, so sending a frame does not busy-wait ~34 ms.
+    // Only one frame is in flight at a time - the gateway never drives both buses at once.
+    class FrameTransmitter
+    {
+    public:
+      // Start bit + 32 data bits + stop bit, two half-bits each
+      static const uint8_t MAX_STEPS = 68;
+      static const uint16_t HALF_BIT_US = 500;
+
+      bool setup();
+
+      // Precompute the waveform and start clocking it out. Returns false if still busy.
+      bool start(int out_pin, uint32_t frame);
+      bool is_busy() const { return busy_; }
+
+      uint32_t get_frames() const { return frames_; }
+      // Largest timer callback lateness seen, in microseconds
+      uint32_t get_max_lateness() const { return max_lateness_us_; }
+
+    protected:
+      struct Step
+      {
+        uint16_t duration_us;
+        bool active;
+      };
+
+      void IRAM_ATTR step();
+      void IRAM_ATTR arm(uint32_t delay_us);
+#ifdef USE_ESP32
+      static void IRAM_ATTR timer_callback(void *arg);
+      esp_timer_handle_t timer_{nullptr};
+#else
+      static void IRAM_ATTR timer_callback();
+#endif
+      static FrameTransmitter *active_;
+
+      Step steps_[MAX_STEPS];
+      uint8_t step_count_{0};
+      volatile uint8_t step_index_{0};
+      volatile bool busy_{false};
+      int out_pin_{-1};
+      // Absolute schedule so interrupt latency does not accumulate over the frame
+      uint32_t next_edge_us_{0};
+      volatile uint32_t max_lateness_us_{0};
+      uint32_t frames_{0};
+    };
+
+  } // namespace opentherm
+} // namespace esphome
@@ -0,0 +1,116 @@
+// Host benchmark of the FrameQueue handoff between the bus task and loop(), with
+// std::thread standing in for both. Paced: the producer pushes one frame every
+// few microseconds into an empty queue and the consumer polls, yielding in
+// between, timing each frame from push() to pop(). Saturated: the producer
+// pushes as fast as the queue takes frames, giving the handoff throughput. On a
+// single core both figures are dominated by the scheduler. Exits non-zero if a
+// frame is lost, duplicated or out of order.
+
+#include "opentherm_frame_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace esphome::opentherm;
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  uint64_t now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+  }
+
+  // Runs a producer thread pushing frames 0..count-1 and drains them on this thread.
+  // With gap_ns != 0 each frame waits for the previous one to be popped plus the gap,
+  // so every frame meets an empty queue; push times go into sent_ns, pop times into received_ns.
+  bool run(uint32_t count, uint64_t gap_ns, std::vector<uint64_t> &sent_ns, std::vector<uint64_t> &received_ns)
+  {
+    FrameQueue queue;
+    std::atomic<uint32_t> consumed{0};
+    sent_ns.assign(count, 0);
+    received_ns.assign(count, 0);
+
+    std::thread producer([&] {
+      for (uint32_t i = 0; i < count; i++)
+      {
+        if (gap_ns != 0)
+        {
+          while (consumed.load(std::memory_order_acquire) != i)
+            std::this_thread::yield();
+          uint64_t due = now_ns() + gap_ns;
+          while (now_ns() < due)
+            std::this_thread::yield();
+        }
+        // The push publishes the timestamp with its release store
+        sent_ns[i] = now_ns();
+        while (!queue.push({i, static_cast<uint8_t>(i)}))
+          std::this_thread::yield();
+      }
+    });
+
+    bool ok = true;
+    InterceptedFrame item;
+    for (uint32_t expected = 0; expected < count;)
+    {
+      if (!queue.pop(item))
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      received_ns[expected] = now_ns();
+      if (item.frame != expected || item.id != static_cast<uint8_t>(expected))
+      {
+        std::printf("frame %u arrived as %u\n", static_cast<unsigned>(expected), static_cast<unsigned>(item.frame));
+        ok = false;
+      }
+      expected++;
+      consumed.store(expected, std::memory_order_release);
+    }
+    producer.join();
+    // Frames rejected by push() were retried, none may be left over
+    if (queue.pop(item))
+    {
+      std::printf("frame %u left in the queue\n", static_cast<unsigned>(item.frame));
+      ok = false;
+    }
+    return ok;
+  }
+} // namespace
+
+int main()
+{
+  const uint32_t PACED = 20000;
+  const uint64_t GAP_NS = 2000;
+  const uint32_t SATURATED = 2000000;
+  bool ok = true;
+  std::vector<uint64_t> sent, received;
+
+  ok &= run(PACED, GAP_NS, sent, received);
+  std::vector<uint64_t> latency(PACED);
+  for (uint32_t i = 0; i < PACED; i++)
+    latency[i] = received[i] - sent[i];
+  std::sort(latency.begin(), latency.end());
+  uint64_t total = 0;
+  for (uint64_t ns : latency)
+    total += ns;
+  std::printf("handoff latency over %u frames: mean %llu ns, p50 %llu ns, p99 %llu ns, max %llu ns\n",
+              static_cast<unsigned>(PACED), static_cast<unsigned long long>(total / PACED),
+              static_cast<unsigned long long>(latency[PACED / 2]),
+              static_cast<unsigned long long>(latency[PACED * 99 / 100]),
+              static_cast<unsigned long long>(latency.back()));
+
+  uint64_t start = now_ns();
+  ok &= run(SATURATED, 0, sent, received);
+  double seconds = (now_ns() - start) / 1e9;
+  std::printf("throughput: %u frames in %.3f s, %.2f M frames/s through a %u-slot queue\n",
+              static_cast<unsigned>(SATURATED), seconds, SATURATED / seconds / 1e6,
+              static_cast<unsigned>(FrameQueue::SIZE));
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,273 @@
+// Host benchmark of the pass-through hot paths: replays the checked-in frame
+// trace through applyOverrides(), recordInterceptedFrame() and
+// processCachedResponse() of the real component, once without an override,
+// once with the DHW override and once with the heating override active. After
+// every exchange one cached value is read through getCachedOrFetch(), which the
+// sniffed frames keep warm, as update() does on the device. Prints one
+// "hotpath v1" line per path in the profiler's format, so two builds can be
+// compared with tools/compare_hotpaths.py; cpu_mhz=0 marks host figures. Exits
+// non-zero if a rewrite is wrong, the intercepted frame queue drops frames, a
+// cached read goes to the boiler, or the replay allocates after setup() (the
+// allocation guard's claim, checked with a counting operator new).
+//
+//   bench_hotpaths [trace file]
+
+#include "opentherm_component.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace esphome::opentherm;
+
+namespace
+{
+  size_t allocations = 0;
+} // namespace
+
+void *operator new(size_t size)
+{
+  allocations++;
+  void *block = std::malloc(size != 0 ? size : 1);
+  if (block == nullptr)
+    throw std::bad_alloc();
+  return block;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+  struct Exchange
+  {
+    unsigned long request;
+    unsigned long response;
+  };
+
+  // Per-call times of one hot path, in nanoseconds
+  struct PathStats
+  {
+    uint32_t count{0};
+    uint64_t total{0};
+    uint32_t min{0};
+    uint32_t max{0};
+
+    void add(uint32_t ns)
+    {
+      if (count == 0 || ns < min)
+        min = ns;
+      if (ns > max)
+        max = ns;
+      total += ns;
+      count++;
+    }
+
+    void print(HotPath path) const
+    {
+      if (count == 0)
+        return;
+      std::printf("hotpath v1 path=%s n=%u mean_ns=%u min_ns=%u max_ns=%u cpu_mhz=0\n", LoopProfiler::path_name(path),
+                  static_cast<unsigned>(count), static_cast<unsigned>(total / count), static_cast<unsigned>(min),
+                  static_cast<unsigned>(max));
+    }
+  };
+
+  class Stopwatch
+  {
+  public:
+    Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+    uint32_t elapsed_ns() const
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+  protected:
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  bool load_trace(const char *path, std::vector<Exchange> &trace)
+  {
+    FILE *file = std::fopen(path, "r");
+    if (file == nullptr)
+      return false;
+    char line[128];
+    while (std::fgets(line, sizeof(line), file) != nullptr)
+    {
+      unsigned long request, response;
+      if (line[0] != '#' && std::sscanf(line, "%lx %lx", &request, &response) == 2)
+        trace.push_back({request, response});
+    }
+    std::fclose(file);
+    return !trace.empty();
+  }
+} // namespace
+
+namespace esphome
+{
+  namespace opentherm
+  {
+    // The component with its pass-through steps opened up. No sensors are
+    // configured, so setup() does not talk to the boiler; the profiler stays off.
+    class HostGateway : public OpenthermComponent
+    {
+    public:
+      HostGateway() : OpenthermComponent(60000) {}
+
+      using OpenthermComponent::applyOverrides;
+      using OpenthermComponent::processCachedResponse;
+      using OpenthermComponent::recordInterceptedFrame;
+
+      void set_dhw_override(bool active, float setpoint)
+      {
+        user_dhw_override_active_ = active;
+        user_dhw_setpoint_ = setpoint;
+      }
+      void set_heating_override(bool active, float setpoint)
+      {
+        user_heating_override_active_ = active;
+        user_heating_setpoint_ = setpoint;
+      }
+      bool dhw_override_active() const { return user_dhw_override_active_; }
+      bool heating_override_active() const { return user_heating_override_active_; }
+      FrameQueue &queue() { return intercepted_frames_; }
+      // What loop() does first, fires the poll timers that ran out
+      void advance_timers() { timers_.advance(clock_.extend(millis())); }
+      OpenTherm &bus() { return *ot_; }
+    };
+  } // namespace opentherm
+} // namespace esphome
+
+int main(int argc, char **argv)
+{
+  const int PASSES = 300;
+  const float DHW_OVERRIDE = 45.0f;     // the trace's QAA73 asks for 50
+  const float HEATING_OVERRIDE = 19.0f; // and for a 21 room setpoint
+
+  const char *path = argc > 1 ? argv[1] : OPENTHERM_FRAME_TRACE;
+  std::vector<Exchange> trace;
+  // Readers of the values the trace carries, each one a getCachedOrFetch()
+  typedef float (OpenthermComponent::*Getter)();
+  static const Getter GETTERS[] = {
+      &OpenthermComponent::getExternalTemperature, &OpenthermComponent::getHeatingTargetTemperature,
+      &OpenthermComponent::getReturnTemperature,   &OpenthermComponent::getHotWaterTargetTemperature,
+      &OpenthermComponent::getHotWaterTemperature, &OpenthermComponent::getModulation,
+      &OpenthermComponent::getPressure,
+  };
+  if (!load_trace(path, trace))
+  {
+    std::printf("could not read a frame trace from %s\n", path);
+    return 1;
+  }
+
+  // A cache hit never reaches the boiler, any request here is a miss
+  static uint32_t boiler_requests = 0;
+  opentherm_test::set_boiler([](unsigned long) -> unsigned long {
+    boiler_requests++;
+    return 0;
+  });
+
+  HostGateway gateway;
+  gateway.setup();
+  OpenTherm &bus = gateway.bus();
+  const unsigned long dhw_rewrite =
+      bus.buildRequest(OpenThermRequestType::WRITE, OpenThermMessageID::TdhwSet, bus.temperatureToData(DHW_OVERRIDE));
+
+  PathStats stats[static_cast<uint8_t>(HotPath::COUNT)];
+  bool ok = true;
+  size_t allocations_at_setup = allocations;
+  for (int pass = 0; pass < PASSES; pass++)
+  {
+    // Passes alternate between no override, the DHW override and the heating override
+    int mode = pass % 3;
+    gateway.set_dhw_override(mode == 1, DHW_OVERRIDE);
+    gateway.set_heating_override(mode == 2, HEATING_OVERRIDE);
+
+    for (size_t index = 0; index < trace.size(); index++)
+    {
+      const Exchange &exchange = trace[index];
+      // One exchange per second of fake time, the controller integrates over it
+      esphome::test::advance_micros(1000000);
+      gateway.advance_timers();
+      OpenThermMessageID id = bus.getDataID(exchange.request);
+
+      // Same classification as the CycleScope in applyOverrides()
+      HotPath override_path = HotPath::PASS_THROUGH;
+      if (id == OpenThermMessageID::TdhwSet && gateway.dhw_override_active())
+        override_path = HotPath::DHW_OVERRIDE;
+      else if ((id == OpenThermMessageID::TSet || id == OpenThermMessageID::TrSet) &&
+               gateway.heating_override_active())
+        override_path = HotPath::HEATING_OVERRIDE;
+
+      Stopwatch apply;
+      unsigned long modified = gateway.applyOverrides(exchange.request);
+      stats[static_cast<uint8_t>(override_path)].add(apply.elapsed_ns());
+
+      if (override_path == HotPath::PASS_THROUGH && modified != exchange.request)
+      {
+        std::printf("pass %d: %08lX rewritten to %08lX without an override\n", pass, exchange.request, modified);
+        ok = false;
+      }
+      if (override_path == HotPath::DHW_OVERRIDE && modified != dhw_rewrite)
+      {
+        std::printf("pass %d: TdhwSet rewritten to %08lX, expected %08lX\n", pass, modified, dhw_rewrite);
+        ok = false;
+      }
+      if (override_path == HotPath::HEATING_OVERRIDE && id == OpenThermMessageID::TrSet &&
+          bus.getFloat(modified) != HEATING_OVERRIDE)
+      {
+        std::printf("pass %d: TrSet rewritten to %.2f, expected %.2f\n", pass, bus.getFloat(modified),
+                    HEATING_OVERRIDE);
+        ok = false;
+      }
+
+      Stopwatch record;
+      gateway.recordInterceptedFrame(exchange.request, modified, exchange.response);
+      stats[static_cast<uint8_t>(HotPath::RECORD_FRAME)].add(record.elapsed_ns());
+
+      // loop() drains the queue after every exchange at the latest
+      InterceptedFrame item;
+      while (gateway.queue().pop(item))
+      {
+        Stopwatch cached;
+        gateway.processCachedResponse(item.frame, static_cast<OpenThermMessageID>(item.id));
+        stats[static_cast<uint8_t>(HotPath::CACHED_RESPONSE)].add(cached.elapsed_ns());
+      }
+
+      // From the second pass on every value has been sniffed and is refreshed well within the cache timeout
+      if (pass != 0)
+      {
+        Getter getter = GETTERS[index % (sizeof(GETTERS) / sizeof(GETTERS[0]))];
+        Stopwatch hit;
+        (gateway.*getter)();
+        stats[static_cast<uint8_t>(HotPath::CACHE_HIT)].add(hit.elapsed_ns());
+      }
+    }
+  }
+
+  size_t replay_allocations = allocations - allocations_at_setup;
+  if (replay_allocations != 0)
+  {
+    std::printf("%zu heap allocations during the replay, the hot paths must not allocate\n", replay_allocations);
+    ok = false;
+  }
+
+  if (boiler_requests != 0)
+  {
+    std::printf("%u cached reads went to the boiler\n", static_cast<unsigned>(boiler_requests));
+    ok = false;
+  }
+
+  if (gateway.queue().get_dropped() != 0)
+  {
+    std::printf("%u intercepted frames dropped\n", static_cast<unsigned>(gateway.queue().get_dropped()));
+    ok = false;
+  }
+
+  std::printf("%zu exchanges x %d passes from %s\n", trace.size(), PASSES, path);
+  for (uint8_t i = 0; i < static_cast<uint8_t>(HotPath::COUNT); i++)
+    stats[i].print(static_cast<HotPath>(i));
+  return ok ? 0 : 1;
+}
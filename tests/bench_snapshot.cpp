@@ -0,0 +1,138 @@
+// Host benchmark of the /opentherm/snapshot serializer: time per response for a
+// whole-document write and for chunked responses at typical TCP window sizes,
+// plus the heap the serializer uses. Exits non-zero if chunked output differs
+// from the whole document or serialization allocates.
+
+#include "opentherm_snapshot.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+using namespace esphome::opentherm;
+
+namespace
+{
+  size_t allocations = 0;
+  size_t heap_in_use = 0;
+  size_t heap_peak = 0;
+} // namespace
+
+// Counting allocator, each block carries its size in front
+void *operator new(size_t size)
+{
+  size_t *block = static_cast<size_t *>(std::malloc(size + sizeof(size_t)));
+  if (block == nullptr)
+    throw std::bad_alloc();
+  *block = size;
+  allocations++;
+  heap_in_use += size;
+  if (heap_in_use > heap_peak)
+    heap_peak = heap_in_use;
+  return block + 1;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  if (ptr == nullptr)
+    return;
+  size_t *block = static_cast<size_t *>(ptr) - 1;
+  heap_in_use -= *block;
+  std::free(block);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+
+namespace
+{
+  GatewaySnapshot make_snapshot()
+  {
+    static const char *const NAMES[] = {"Toutside", "Tret", "Tboiler", "CHPressure", "RelModLevel", "TSet",
+                                        "Tdhw",     "TdhwSet", "Tr",   "TrSet",      "MaxTSet",     "MaxRelMod"};
+    GatewaySnapshot snapshot{};
+    snapshot.uptime_ms = 123456789;
+    snapshot.status = 0x030A;
+    snapshot.ch_active = true;
+    snapshot.flame = true;
+    snapshot.value_count = GatewaySnapshot::MAX_VALUES;
+    for (uint8_t i = 0; i < GatewaySnapshot::MAX_VALUES; i++)
+      snapshot.values[i] = {NAMES[i], 20.0f + i * 3.25f, 1000u * i, i % 3 ? "sniffed" : "polled", i == 4, 17u * i};
+    snapshot.dhw_override = {true, 55.0f, 86000000};
+    snapshot.heating_override = {false, 20.0f, 0};
+    snapshot.max_ch_setpoint = 80.0f;
+    snapshot.max_modulation = NAN;
+    snapshot.deadline_misses = 3;
+    snapshot.max_response_time_ms = 612;
+    snapshot.observed_ids = 23;
+    snapshot.bus_utilization = 41.5f;
+    return snapshot;
+  }
+
+  // Serializes the snapshot as the chunked response does, chunk_size bytes per callback
+  std::string serialize(const GatewaySnapshot &snapshot, char *buffer, size_t chunk_size, size_t &chunks)
+  {
+    std::string document;
+    chunks = 0;
+    for (size_t index = 0;; chunks++)
+    {
+      JsonWriter writer(buffer, chunk_size, index);
+      write_snapshot_json(snapshot, writer);
+      size_t written = writer.written();
+      if (written == 0)
+        return document;
+      document.append(buffer, written);
+      index += written;
+    }
+  }
+} // namespace
+
+int main()
+{
+  const int ITERATIONS = 2000;
+  GatewaySnapshot snapshot = make_snapshot();
+  static char buffer[4096];
+
+  size_t chunks;
+  std::string whole = serialize(snapshot, buffer, sizeof(buffer), chunks);
+  std::printf("snapshot struct %zu bytes, JsonWriter %zu bytes, document %zu bytes\n", sizeof(GatewaySnapshot),
+              sizeof(JsonWriter), whole.size());
+
+  bool ok = true;
+  for (size_t chunk_size : {sizeof(buffer), static_cast<size_t>(1460), static_cast<size_t>(536)})
+  {
+    std::string chunked = serialize(snapshot, buffer, chunk_size, chunks);
+    if (chunked != whole)
+    {
+      std::printf("chunk size %zu: output differs from the whole document\n", chunk_size);
+      ok = false;
+    }
+
+    // Only the writer runs in the timed loop, the copy into std::string above is the test harness
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+      for (size_t index = 0;;)
+      {
+        JsonWriter writer(buffer, chunk_size, index);
+        write_snapshot_json(snapshot, writer);
+        if (writer.written() == 0)
+          break;
+        index += writer.written();
+      }
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    size_t allocated = allocations - before;
+    std::printf("chunk %4zu bytes: %zu chunks, %8.2f us per response, %zu heap allocations\n", chunk_size, chunks,
+                us / ITERATIONS, allocated);
+    if (allocated != 0)
+      ok = false;
+  }
+
+  std::printf("peak heap of the whole run (harness strings included): %zu bytes\n", heap_peak);
+  return ok ? 0 : 1;
+}
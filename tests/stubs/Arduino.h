@@ -0,0 +1,60 @@
+#pragma once
+
+// Host stand-in for the Arduino core: pin writes are recorded and timer1 is
+// simulated, the test fires its interrupt by hand.
+
+#include <cstdint>
+#include <vector>
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x00
+#define OUTPUT 0x01
+#define CHANGE 0x03
+
+#define TIM_DIV1 0
+#define TIM_DIV16 1
+#define TIM_DIV256 3
+#define TIM_EDGE 0
+#define TIM_LEVEL 1
+#define TIM_SINGLE 0
+#define TIM_LOOP 1
+
+typedef void (*timercallback)(void);
+
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+void timer1_isr_init();
+void timer1_attachInterrupt(timercallback callback);
+void timer1_enable(uint8_t divider, uint8_t int_type, uint8_t reload);
+void timer1_disable();
+void timer1_write(uint32_t ticks);
+
+namespace arduino_test
+{
+  struct PinWrite
+  {
+    uint64_t timestamp_us;
+    uint8_t pin;
+    uint8_t value;
+  };
+
+  struct Timer1
+  {
+    timercallback callback{nullptr};
+    bool enabled{false};
+    bool armed{false};
+    uint32_t ticks{0}; // last value written, 5 ticks/us with TIM_DIV16
+  };
+
+  std::vector<PinWrite> &pin_writes();
+  Timer1 &timer1();
+  void reset();
+} // namespace arduino_test
@@ -0,0 +1,142 @@
+#pragma once
+
+// Host stand-in for the ihormelnyk OpenTherm library (1.1.4). The frame helpers
+// behave like the library's; the bus is a hook the test sets.
+
+#include <Arduino.h>
+#include <cstdint>
+
+typedef uint8_t byte;
+
+enum OpenThermResponseStatus : byte
+{
+  NONE,
+  SUCCESS,
+  INVALID,
+  TIMEOUT
+};
+
+enum OpenThermMessageType
+{
+  READ_DATA = 0,
+  READ = READ_DATA,
+  WRITE_DATA = 1,
+  WRITE = WRITE_DATA,
+  INVALID_DATA = 2,
+  RESERVED = 3,
+  READ_ACK = 4,
+  WRITE_ACK = 5,
+  DATA_INVALID = 6,
+  UNKNOWN_DATA_ID = 7
+};
+
+typedef OpenThermMessageType OpenThermRequestType;
+
+enum OpenThermMessageID
+{
+  Status,
+  TSet,
+  MConfigMMemberIDcode,
+  SConfigSMemberIDcode,
+  Command,
+  ASFflags,
+  RBPflags,
+  CoolingControl,
+  TsetCH2,
+  TrOverride,
+  TSP,
+  TSPindexTSPvalue,
+  FHBsize,
+  FHBindexFHBvalue,
+  MaxRelModLevelSetting,
+  MaxCapacityMinModLevel,
+  TrSet,
+  RelModLevel,
+  CHPressure,
+  DHWFlowRate,
+  DayTime,
+  Date,
+  Year,
+  TrSetCH2,
+  Tr,
+  Tboiler,
+  Tdhw,
+  Toutside,
+  Tret,
+  Tstorage,
+  Tcollector,
+  TflowCH2,
+  Tdhw2,
+  Texhaust,
+  TdhwSetUBTdhwSetLB = 48,
+  MaxTSetUBMaxTSetLB,
+  HcratioUBHcratioLB,
+  TdhwSet = 56,
+  MaxTSet,
+  Hcratio,
+  RemoteOverrideFunction = 100,
+  OEMDiagnosticCode = 115,
+  BurnerStarts,
+  CHPumpStarts,
+  DHWPumpValveStarts,
+  DHWBurnerStarts,
+  BurnerOperationHours,
+  CHPumpOperationHours,
+  DHWPumpValveOperationHours,
+  DHWBurnerOperationHours,
+  OpenThermVersionMaster,
+  OpenThermVersionSlave,
+  MasterVersion,
+  SlaveVersion,
+};
+
+class OpenTherm
+{
+public:
+  OpenTherm(int inPin = 4, int outPin = 5, bool isSlave = false);
+  void begin(void (*handleInterruptCallback)(void));
+  void begin(void (*handleInterruptCallback)(void),
+             void (*processResponseCallback)(unsigned long, OpenThermResponseStatus));
+  bool isReady();
+  unsigned long sendRequest(unsigned long request);
+  bool sendResponse(unsigned long request);
+  bool sendRequestAync(unsigned long request);
+  static unsigned long buildRequest(OpenThermMessageType type, OpenThermMessageID id, unsigned int data);
+  static unsigned long buildResponse(OpenThermMessageType type, OpenThermMessageID id, unsigned int data);
+  unsigned long getLastResponse();
+  OpenThermResponseStatus getLastResponseStatus();
+  const char *statusToString(OpenThermResponseStatus status);
+  void handleInterrupt();
+  void process();
+  void end();
+
+  static bool parity(unsigned long frame);
+  OpenThermMessageType getMessageType(unsigned long message);
+  OpenThermMessageID getDataID(unsigned long frame);
+  const char *messageTypeToString(OpenThermMessageType message_type);
+  bool isValidRequest(unsigned long request);
+  bool isValidResponse(unsigned long response);
+
+  bool isFault(unsigned long response);
+  bool isCentralHeatingActive(unsigned long response);
+  bool isHotWaterActive(unsigned long response);
+  bool isFlameOn(unsigned long response);
+  bool isCoolingActive(unsigned long response);
+  bool isDiagnostic(unsigned long response);
+  uint16_t getUInt(const unsigned long response) const;
+  float getFloat(const unsigned long response) const;
+  unsigned int temperatureToData(float temperature);
+
+protected:
+  bool isSlave_;
+  unsigned long response_{0};
+  OpenThermResponseStatus status_{NONE};
+  bool busy_{false};
+};
+
+namespace opentherm_test
+{
+  // Boiler side of sendRequest()/sendRequestAync(), 0 means no reply
+  typedef unsigned long (*Boiler)(unsigned long request);
+  void set_boiler(Boiler boiler);
+} // namespace opentherm_test
@@ -0,0 +1,44 @@
+#include "Arduino.h"
+#include "esphome/core/hal.h"
+
+namespace arduino_test
+{
+  static std::vector<PinWrite> writes;
+  static Timer1 timer;
+  static uint8_t levels[64];
+
+  std::vector<PinWrite> &pin_writes() { return writes; }
+  Timer1 &timer1() { return timer; }
+  void reset()
+  {
+    writes.clear();
+    timer = Timer1{};
+  }
+} // namespace arduino_test
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  arduino_test::levels[pin & 63] = value;
+  arduino_test::writes.push_back({esphome::micros(), pin, value});
+}
+int digitalRead(uint8_t pin) { return arduino_test::levels[pin & 63]; }
+void pinMode(uint8_t, uint8_t) {}
+int digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterrupt(uint8_t, void (*)(void), int) {}
+void detachInterrupt(uint8_t) {}
+void noInterrupts() {}
+void interrupts() {}
+
+void timer1_isr_init() {}
+void timer1_attachInterrupt(timercallback callback) { arduino_test::timer.callback = callback; }
+void timer1_enable(uint8_t, uint8_t, uint8_t) { arduino_test::timer.enabled = true; }
+void timer1_disable()
+{
+  arduino_test::timer.enabled = false;
+  arduino_test::timer.armed = false;
+}
+void timer1_write(uint32_t ticks)
+{
+  arduino_test::timer.ticks = ticks;
+  arduino_test::timer.armed = true;
+}
@@ -0,0 +1,104 @@
+#include "esphome/components/socket/socket.h"
+#include "esphome/core/preferences.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace esphome
+{
+  static ESPPreferences preferences;
+  ESPPreferences *global_preferences = &preferences;
+
+  namespace socket
+  {
+    Socket::~Socket() { close(); }
+
+    std::unique_ptr<Socket> Socket::accept(struct sockaddr *addr, socklen_t *addrlen)
+    {
+      int fd = ::accept(fd_, addr, addrlen);
+      if (fd < 0)
+        return nullptr;
+      return std::unique_ptr<Socket>(new Socket(fd));
+    }
+
+    int Socket::bind(const struct sockaddr *addr, socklen_t addrlen) { return ::bind(fd_, addr, addrlen); }
+
+    int Socket::close()
+    {
+      if (fd_ < 0)
+        return 0;
+      int result = ::close(fd_);
+      fd_ = -1;
+      return result;
+    }
+
+    int Socket::listen(int backlog) { return ::listen(fd_, backlog); }
+    ssize_t Socket::read(void *buf, size_t len) { return ::read(fd_, buf, len); }
+    ssize_t Socket::write(const void *buf, size_t len)
+    {
+      if (write_budget_ == 0)
+      {
+        errno = EWOULDBLOCK;
+        return -1;
+      }
+      if (write_budget_ > 0 && len > static_cast<size_t>(write_budget_))
+        len = write_budget_;
+      ssize_t sent = ::send(fd_, buf, len, MSG_NOSIGNAL);
+      if (sent > 0 && write_budget_ > 0)
+        write_budget_ -= sent;
+      return sent;
+    }
+
+    ssize_t Socket::sendto(const void *buf, size_t len, int flags, const struct sockaddr *to, socklen_t tolen)
+    {
+      return ::sendto(fd_, buf, len, flags, to, tolen);
+    }
+
+    int Socket::setblocking(bool blocking)
+    {
+      int flags = ::fcntl(fd_, F_GETFL, 0);
+      if (flags < 0)
+        return -1;
+      flags = blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK;
+      return ::fcntl(fd_, F_SETFL, flags);
+    }
+
+    int Socket::setsockopt(int level, int optname, const void *optval, socklen_t optlen)
+    {
+      return ::setsockopt(fd_, level, optname, optval, optlen);
+    }
+
+    int Socket::getsockname(struct sockaddr *addr, socklen_t *addrlen) { return ::getsockname(fd_, addr, addrlen); }
+
+    std::unique_ptr<Socket> socket(int domain, int type, int protocol)
+    {
+      int fd = ::socket(domain, type, protocol);
+      if (fd < 0)
+        return nullptr;
+      return std::unique_ptr<Socket>(new Socket(fd));
+    }
+
+    std::unique_ptr<Socket> socket_ip(int type, int protocol) { return socket(AF_INET, type, protocol); }
+
+    socklen_t set_sockaddr(struct sockaddr *addr, socklen_t addrlen, const std::string &ip_address, uint16_t port)
+    {
+      if (addrlen < sizeof(struct sockaddr_in))
+        return 0;
+      auto *server = reinterpret_cast<struct sockaddr_in *>(addr);
+      std::memset(server, 0, sizeof(*server));
+      server->sin_family = AF_INET;
+      server->sin_port = htons(port);
+      if (inet_pton(AF_INET, ip_address.c_str(), &server->sin_addr) != 1)
+        return 0;
+      return sizeof(struct sockaddr_in);
+    }
+
+    socklen_t set_sockaddr_any(struct sockaddr *addr, socklen_t addrlen, uint16_t port)
+    {
+      return set_sockaddr(addr, addrlen, "0.0.0.0", port);
+    }
+  } // namespace socket
+} // namespace esphome
@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for the binary_sensor component, keeps the last published value
+
+namespace esphome
+{
+  namespace binary_sensor
+  {
+    class BinarySensor
+    {
+    public:
+      void publish_state(bool value)
+      {
+        state = value;
+        has_state_ = true;
+      }
+      bool has_state() const { return has_state_; }
+
+      bool state{false};
+
+    protected:
+      bool has_state_{false};
+    };
+  } // namespace binary_sensor
+} // namespace esphome
@@ -0,0 +1,79 @@
+#pragma once
+
+// Host stand-in for the climate component, only what the component uses
+
+#include <cmath>
+#include <set>
+#include "esphome/core/component.h"
+
+#define LOG_CLIMATE(prefix, type, obj)
+
+namespace esphome
+{
+  template <typename T> class optional
+  {
+  public:
+    optional() = default;
+    optional(T value) : value_(value), has_value_(true) {}
+    bool has_value() const { return has_value_; }
+    T operator*() const { return value_; }
+
+  protected:
+    T value_{};
+    bool has_value_{false};
+  };
+
+  namespace climate
+  {
+    enum ClimateMode
+    {
+      CLIMATE_MODE_OFF,
+      CLIMATE_MODE_HEAT,
+    };
+
+    enum ClimateAction
+    {
+      CLIMATE_ACTION_OFF,
+      CLIMATE_ACTION_HEATING,
+    };
+
+    class ClimateTraits
+    {
+    public:
+      void set_supports_current_temperature(bool) {}
+      void set_supported_modes(std::set<ClimateMode>) {}
+      void set_supports_two_point_target_temperature(bool) {}
+      void set_supports_action(bool) {}
+      void set_visual_min_temperature(float) {}
+      void set_visual_max_temperature(float) {}
+      void set_visual_temperature_step(float) {}
+    };
+
+    class ClimateCall
+    {
+    public:
+      const optional<ClimateMode> &get_mode() const { return mode_; }
+      const optional<float> &get_target_temperature() const { return target_temperature_; }
+
+      optional<ClimateMode> mode_;
+      optional<float> target_temperature_;
+    };
+
+    class Climate
+    {
+    public:
+      virtual ~Climate() = default;
+      void publish_state() { published_++; }
+      virtual ClimateTraits traits() = 0;
+      virtual void control(const ClimateCall &call) = 0;
+
+      float target_temperature{0};
+      float current_temperature{0};
+      ClimateMode mode{CLIMATE_MODE_OFF};
+      ClimateAction action{CLIMATE_ACTION_OFF};
+
+    protected:
+      uint32_t published_{0};
+    };
+  } // namespace climate
+} // namespace esphome
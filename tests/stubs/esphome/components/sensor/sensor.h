@@ -0,0 +1,27 @@
+#pragma once
+
+// Host stand-in for the sensor component, keeps the last published value
+
+#include <cmath>
+
+namespace esphome
+{
+  namespace sensor
+  {
+    class Sensor
+    {
+    public:
+      void publish_state(float value)
+      {
+        state = value;
+        has_state_ = true;
+      }
+      bool has_state() const { return has_state_; }
+
+      float state{NAN};
+
+    protected:
+      bool has_state_{false};
+    };
+  } // namespace sensor
+} // namespace esphome
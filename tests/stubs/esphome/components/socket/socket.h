@@ -0,0 +1,52 @@
+#pragma once
+
+// Host stand-in for the socket component, a thin wrapper over POSIX sockets so
+// the servers can be tested over loopback
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+namespace esphome
+{
+  namespace socket
+  {
+    class Socket
+    {
+    public:
+      explicit Socket(int fd) : fd_(fd) {}
+      ~Socket();
+      Socket(const Socket &) = delete;
+      Socket &operator=(const Socket &) = delete;
+
+      std::unique_ptr<Socket> accept(struct sockaddr *addr, socklen_t *addrlen);
+      int bind(const struct sockaddr *addr, socklen_t addrlen);
+      int close();
+      int listen(int backlog);
+      ssize_t read(void *buf, size_t len);
+      ssize_t write(const void *buf, size_t len);
+      ssize_t sendto(const void *buf, size_t len, int flags, const struct sockaddr *to, socklen_t tolen);
+      int setblocking(bool blocking);
+      int setsockopt(int level, int optname, const void *optval, socklen_t optlen);
+      int getsockname(struct sockaddr *addr, socklen_t *addrlen);
+      int get_fd() const { return fd_; }
+
+      // Test hook: write() takes at most this many more bytes, then fails with
+      // EWOULDBLOCK like a full send buffer. -1 = no limit.
+      void set_write_budget(ssize_t bytes) { write_budget_ = bytes; }
+
+    protected:
+      int fd_;
+      ssize_t write_budget_{-1};
+    };
+
+    std::unique_ptr<Socket> socket(int domain, int type, int protocol);
+    std::unique_ptr<Socket> socket_ip(int type, int protocol);
+    // IPv4 only on the host
+    socklen_t set_sockaddr(struct sockaddr *addr, socklen_t addrlen, const std::string &ip_address, uint16_t port);
+    socklen_t set_sockaddr_any(struct sockaddr *addr, socklen_t addrlen, uint16_t port);
+  } // namespace socket
+} // namespace esphome
@@ -0,0 +1,42 @@
+#pragma once
+
+// Host stand-in for esphome/core/component.h, only what the component uses
+
+#include <cstdint>
+#include "esphome/core/hal.h"
+
+namespace esphome
+{
+  namespace setup_priority
+  {
+    const float HARDWARE = 800.0f;
+    const float DATA = 600.0f;
+    const float AFTER_WIFI = 200.0f;
+  } // namespace setup_priority
+
+  class Component
+  {
+  public:
+    virtual ~Component() = default;
+    virtual void setup() {}
+    virtual void loop() {}
+    virtual void dump_config() {}
+    virtual float get_setup_priority() const { return 0.0f; }
+    void mark_failed() { failed_ = true; }
+    bool is_failed() const { return failed_; }
+
+  protected:
+    bool failed_{false};
+  };
+
+  class PollingComponent : public Component
+  {
+  public:
+    explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+    virtual void update() = 0;
+    uint32_t get_update_interval() const { return update_interval_; }
+
+  protected:
+    uint32_t update_interval_;
+  };
+} // namespace esphome
@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for esphome/core/hal.h. Time is a fake clock the tests move.
+
+#include <cstdint>
+
+#define IRAM_ATTR
+
+namespace esphome
+{
+  uint32_t millis();
+  uint32_t micros();
+  void delay(uint32_t ms);
+  void delayMicroseconds(uint32_t us);
+  void yield();
+  uint32_t arch_get_cpu_cycle_count();
+  uint32_t arch_get_cpu_freq_hz();
+
+  namespace test
+  {
+    // Sets the fake clock; delay() and delayMicroseconds() advance it
+    void set_micros(uint64_t us);
+    void advance_micros(uint64_t us);
+  } // namespace test
+} // namespace esphome
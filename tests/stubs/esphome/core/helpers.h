@@ -0,0 +1,28 @@
+#pragma once
+
+// Host stand-in for esphome/core/helpers.h, only what the component uses
+
+#include <mutex>
+
+namespace esphome
+{
+  class Mutex
+  {
+  public:
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+
+  protected:
+    std::mutex mutex_;
+  };
+
+  class LockGuard
+  {
+  public:
+    explicit LockGuard(Mutex &mutex) : mutex_(mutex) { mutex_.lock(); }
+    ~LockGuard() { mutex_.unlock(); }
+
+  protected:
+    Mutex &mutex_;
+  };
+} // namespace esphome
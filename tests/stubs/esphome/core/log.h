@@ -0,0 +1,36 @@
+#pragma once
+
+// Host stand-in for esphome/core/log.h. Messages go to stderr when OPENTHERM_TEST_LOG is set.
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+namespace esphome
+{
+  namespace test
+  {
+    __attribute__((format(printf, 3, 4))) inline void log(char level, const char *tag, const char *format, ...)
+    {
+      static const bool enabled = std::getenv("OPENTHERM_TEST_LOG") != nullptr;
+      if (!enabled)
+        return;
+      va_list args;
+      va_start(args, format);
+      std::fprintf(stderr, "[%c][%s] ", level, tag);
+      std::vfprintf(stderr, format, args);
+      std::fputc('\n', stderr);
+      va_end(args);
+    }
+  } // namespace test
+} // namespace esphome
+
+#define ESP_LOGE(tag, ...) ::esphome::test::log('E', tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::test::log('W', tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::test::log('I', tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::test::log('D', tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::test::log('V', tag, __VA_ARGS__)
+#define ESP_LOGVV(tag, ...) ::esphome::test::log('V', tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::test::log('C', tag, __VA_ARGS__)
+
+#define YESNO(b) ((b) ? "YES" : "NO")
@@ -0,0 +1,55 @@
+#pragma once
+
+// Host stand-in for esphome/core/preferences.h. Slots live in memory for the
+// lifetime of the process, keyed by their hash.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace esphome
+{
+  class ESPPreferenceObject
+  {
+  public:
+    ESPPreferenceObject() = default;
+    ESPPreferenceObject(std::vector<uint8_t> *slot) : slot_(slot) {}
+
+    template <typename T> bool save(const T *src)
+    {
+      if (slot_ == nullptr)
+        return false;
+      slot_->assign(reinterpret_cast<const uint8_t *>(src), reinterpret_cast<const uint8_t *>(src) + sizeof(T));
+      return true;
+    }
+
+    template <typename T> bool load(T *dest)
+    {
+      if (slot_ == nullptr || slot_->size() != sizeof(T))
+        return false;
+      std::memcpy(static_cast<void *>(dest), slot_->data(), sizeof(T));
+      return true;
+    }
+
+  protected:
+    std::vector<uint8_t> *slot_{nullptr};
+  };
+
+  class ESPPreferences
+  {
+  public:
+    template <typename T> ESPPreferenceObject make_preference(uint32_t type, bool)
+    {
+      return ESPPreferenceObject(&slots_[type]);
+    }
+    bool sync() { return true; }
+    void clear() { slots_.clear(); }
+
+  protected:
+    std::map<uint32_t, std::vector<uint8_t>> slots_;
+  };
+
+  extern ESPPreferences *global_preferences;
+} // namespace esphome
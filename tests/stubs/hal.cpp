@@ -0,0 +1,29 @@
+#include "esphome/core/hal.h"
+
+#include <chrono>
+
+namespace esphome
+{
+  static uint64_t now_us = 0;
+
+  uint32_t millis() { return now_us / 1000; }
+  uint32_t micros() { return now_us; }
+  void delay(uint32_t ms) { now_us += static_cast<uint64_t>(ms) * 1000; }
+  void delayMicroseconds(uint32_t us) { now_us += us; }
+  void yield() {}
+
+  // Real time, so the cycle counters measure host work
+  uint32_t arch_get_cpu_cycle_count()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+  uint32_t arch_get_cpu_freq_hz() { return 1000000000UL; }
+
+  namespace test
+  {
+    void set_micros(uint64_t us) { now_us = us; }
+    void advance_micros(uint64_t us) { now_us += us; }
+  } // namespace test
+} // namespace esphome
@@ -0,0 +1,132 @@
+#include "OpenTherm.h"
+
+namespace opentherm_test
+{
+  static Boiler boiler = nullptr;
+  void set_boiler(Boiler callback) { boiler = callback; }
+} // namespace opentherm_test
+
+OpenTherm::OpenTherm(int, int, bool isSlave) : isSlave_(isSlave) {}
+void OpenTherm::begin(void (*)(void)) {}
+void OpenTherm::begin(void (*)(void), void (*)(unsigned long, OpenThermResponseStatus)) {}
+bool OpenTherm::isReady() { return !busy_; }
+
+unsigned long OpenTherm::sendRequest(unsigned long request)
+{
+  sendRequestAync(request);
+  busy_ = false;
+  return response_;
+}
+
+bool OpenTherm::sendRequestAync(unsigned long request)
+{
+  response_ = opentherm_test::boiler != nullptr ? opentherm_test::boiler(request) : 0;
+  status_ = response_ == 0 ? TIMEOUT : (isValidResponse(response_) ? SUCCESS : INVALID);
+  busy_ = true;
+  return true;
+}
+
+bool OpenTherm::sendResponse(unsigned long) { return true; }
+unsigned long OpenTherm::getLastResponse() { return response_; }
+OpenThermResponseStatus OpenTherm::getLastResponseStatus() { return status_; }
+const char *OpenTherm::statusToString(OpenThermResponseStatus status)
+{
+  switch (status)
+  {
+  case NONE:
+    return "NONE";
+  case SUCCESS:
+    return "SUCCESS";
+  case INVALID:
+    return "INVALID";
+  case TIMEOUT:
+    return "TIMEOUT";
+  }
+  return "UNKNOWN";
+}
+void OpenTherm::handleInterrupt() {}
+void OpenTherm::process() { busy_ = false; }
+void OpenTherm::end() {}
+
+bool OpenTherm::parity(unsigned long frame)
+{
+  return __builtin_parityl(frame & 0xFFFFFFFFUL);
+}
+
+unsigned long OpenTherm::buildRequest(OpenThermMessageType type, OpenThermMessageID id, unsigned int data)
+{
+  unsigned long request = data;
+  if (type == WRITE_DATA)
+    request |= 1ul << 28;
+  request |= static_cast<unsigned long>(id) << 16;
+  if (parity(request))
+    request |= 1ul << 31;
+  return request;
+}
+
+unsigned long OpenTherm::buildResponse(OpenThermMessageType type, OpenThermMessageID id, unsigned int data)
+{
+  unsigned long response = data;
+  response |= static_cast<unsigned long>(type) << 28;
+  response |= static_cast<unsigned long>(id) << 16;
+  if (parity(response))
+    response |= 1ul << 31;
+  return response;
+}
+
+OpenThermMessageType OpenTherm::getMessageType(unsigned long message)
+{
+  return static_cast<OpenThermMessageType>((message >> 28) & 7);
+}
+
+OpenThermMessageID OpenTherm::getDataID(unsigned long frame)
+{
+  return static_cast<OpenThermMessageID>((frame >> 16) & 0xFF);
+}
+
+const char *OpenTherm::messageTypeToString(OpenThermMessageType message_type)
+{
+  static const char *const NAMES[] = {"READ_DATA", "WRITE_DATA", "INVALID_DATA", "RESERVED",
+                                      "READ_ACK",  "WRITE_ACK",  "DATA_INVALID", "UNKNOWN_DATA_ID"};
+  return NAMES[message_type & 7];
+}
+
+bool OpenTherm::isValidRequest(unsigned long request)
+{
+  if (parity(request))
+    return false;
+  OpenThermMessageType type = getMessageType(request);
+  return type == READ_DATA || type == WRITE_DATA;
+}
+
+bool OpenTherm::isValidResponse(unsigned long response)
+{
+  if (parity(response))
+    return false;
+  OpenThermMessageType type = getMessageType(response);
+  return type == READ_ACK || type == WRITE_ACK;
+}
+
+bool OpenTherm::isFault(unsigned long response) { return response & 0x1; }
+bool OpenTherm::isCentralHeatingActive(unsigned long response) { return response & 0x2; }
+bool OpenTherm::isHotWaterActive(unsigned long response) { return response & 0x4; }
+bool OpenTherm::isFlameOn(unsigned long response) { return response & 0x8; }
+bool OpenTherm::isCoolingActive(unsigned long response) { return response & 0x10; }
+bool OpenTherm::isDiagnostic(unsigned long response) { return response & 0x40; }
+
+uint16_t OpenTherm::getUInt(const unsigned long response) const { return response & 0xFFFF; }
+
+float OpenTherm::getFloat(const unsigned long response) const
+{
+  const uint16_t u88 = getUInt(response);
+  return (u88 & 0x8000) ? -(0x10000L - u88) / 256.0f : u88 / 256.0f;
+}
+
+unsigned int OpenTherm::temperatureToData(float temperature)
+{
+  if (temperature < 0)
+    temperature = 0;
+  if (temperature > 100)
+    temperature = 100;
+  return static_cast<unsigned int>(temperature * 256);
+}
@@ -0,0 +1,257 @@
+#include "opentherm_edge_decoder.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace esphome::opentherm;
+
+namespace
+{
+  struct Edge
+  {
+    uint32_t timestamp_us;
+    bool level;
+  };
+
+  // Sets bit 31 so the frame has even parity
+  uint32_t with_parity(uint32_t frame)
+  {
+    frame &= 0x7FFFFFFFUL;
+    return __builtin_parity(frame) ? frame | 0x80000000UL : frame;
+  }
+
+  // Line edges of a Manchester frame starting at start_us: start bit, 32 data bits
+  // MSB first, stop bit. The line idles low and every bit is active in its first half.
+  std::vector<Edge> encode(uint32_t frame, uint32_t start_us, bool stop_bit = true, uint8_t bits = 34)
+  {
+    std::vector<bool> halves;
+    auto add_bit = [&](bool bit) {
+      halves.push_back(bit);
+      halves.push_back(!bit);
+    };
+    add_bit(true);
+    for (int i = 31; i >= 0; i--)
+      add_bit((frame >> i) & 1);
+    add_bit(stop_bit);
+    halves.resize(bits * 2);
+
+    std::vector<Edge> edges;
+    bool level = false;
+    for (size_t i = 0; i < halves.size(); i++)
+    {
+      if (halves[i] != level)
+      {
+        level = halves[i];
+        edges.push_back({start_us + static_cast<uint32_t>(i) * 500, level});
+      }
+    }
+    return edges;
+  }
+
+  struct Result
+  {
+    int frames = 0;
+    uint32_t frame = 0;
+  };
+
+  Result feed_all(ManchesterDecoder &decoder, const std::vector<Edge> &edges)
+  {
+    Result result;
+    for (const auto &edge : edges)
+    {
+      uint32_t frame;
+      if (decoder.feed(edge.timestamp_us, edge.level, frame))
+      {
+        result.frames++;
+        result.frame = frame;
+      }
+    }
+    return result;
+  }
+
+  // Index of the first bit-boundary edge, the one between two equal data bits
+  size_t first_boundary_edge(const std::vector<Edge> &edges)
+  {
+    for (size_t i = 2; i < edges.size(); i++)
+    {
+      if ((edges[i].timestamp_us - edges[0].timestamp_us) % 1000 == 0)
+        return i;
+    }
+    return 0;
+  }
+
+  const uint32_t FRAME = with_parity(0x00190000UL | 0x2A80); // READ of ID 25, boiler water temperature
+} // namespace
+
+TEST(ManchesterDecoder, DecodesGoodFrame)
+{
+  ManchesterDecoder decoder;
+  Result result = feed_all(decoder, encode(FRAME, 10000));
+  EXPECT_EQ(result.frames, 1);
+  EXPECT_EQ(result.frame, FRAME);
+  EXPECT_EQ(decoder.get_frames(), 1u);
+  EXPECT_EQ(decoder.get_timing_errors(), 0u);
+  EXPECT_EQ(decoder.get_parity_errors(), 0u);
+}
+
+TEST(ManchesterDecoder, DecodesBackToBackFramesAcrossTimerWrap)
+{
+  ManchesterDecoder decoder;
+  std::vector<Edge> edges = encode(FRAME, 0xFFFFFFFFUL - 20000 + 1);
+  std::vector<Edge> second = encode(with_parity(0x10010100UL), 80000);
+  edges.insert(edges.end(), second.begin(), second.end());
+  Result result = feed_all(decoder, edges);
+  EXPECT_EQ(result.frames, 2);
+  EXPECT_EQ(result.frame, with_parity(0x10010100UL));
+}
+
+TEST(ManchesterDecoder, RejectsBadStopBit)
+{
+  ManchesterDecoder decoder;
+  Result result = feed_all(decoder, encode(FRAME, 10000, false));
+  EXPECT_EQ(result.frames, 0);
+  EXPECT_EQ(decoder.get_timing_errors(), 1u);
+  EXPECT_EQ(decoder.get_parity_errors(), 0u);
+}
+
+TEST(ManchesterDecoder, RejectsParityError)
+{
+  ManchesterDecoder decoder;
+  Result result = feed_all(decoder, encode(FRAME ^ 0x00000100UL, 10000));
+  EXPECT_EQ(result.frames, 0);
+  EXPECT_EQ(decoder.get_parity_errors(), 1u);
+  EXPECT_EQ(decoder.get_timing_errors(), 0u);
+}
+
+TEST(ManchesterDecoder, AcceptsJitterUpToHalfBitLimit)
+{
+  // A late boundary edge is still taken as one while it stays within the half-bit tolerance
+  std::vector<Edge> edges = encode(FRAME, 10000);
+  size_t boundary = first_boundary_edge(edges);
+  ASSERT_NE(boundary, 0u);
+  edges[boundary].timestamp_us += 174;
+
+  ManchesterDecoder decoder;
+  Result result = feed_all(decoder, edges);
+  EXPECT_EQ(result.frames, 1);
+  EXPECT_EQ(result.frame, FRAME);
+}
+
+TEST(ManchesterDecoder, RejectsEdgesEitherSideOfMidBitThreshold)
+{
+  std::vector<Edge> edges = encode(FRAME, 10000);
+  size_t boundary = first_boundary_edge(edges);
+  ASSERT_NE(boundary, 0u);
+  uint32_t last_mid = edges[boundary - 1].timestamp_us;
+
+  // Just below 750 us after the mid-bit edge it is a boundary edge, but too late for one
+  std::vector<Edge> below = edges;
+  below[boundary].timestamp_us = last_mid + OT_MID_BIT_THRESHOLD_US - 2;
+  ManchesterDecoder decoder;
+  EXPECT_EQ(feed_all(decoder, below).frames, 0);
+  EXPECT_GE(decoder.get_timing_errors(), 1u);
+
+  // At the threshold it counts as the next mid-bit edge, which is too early for a full bit
+  std::vector<Edge> above = edges;
+  above[boundary].timestamp_us = last_mid + OT_MID_BIT_THRESHOLD_US;
+  decoder = ManchesterDecoder();
+  EXPECT_EQ(feed_all(decoder, above).frames, 0);
+  EXPECT_GE(decoder.get_timing_errors(), 1u);
+}
+
+TEST(ManchesterDecoder, RecoversAfterTruncatedFrame)
+{
+  // A frame cut off after 20 bits is dropped, the next start bit begins a new frame
+  std::vector<Edge> edges = encode(FRAME, 10000, true, 20);
+  std::vector<Edge> next = encode(FRAME, 200000);
+  edges.insert(edges.end(), next.begin(), next.end());
+
+  ManchesterDecoder decoder;
+  Result result = feed_all(decoder, edges);
+  EXPECT_EQ(result.frames, 1);
+  EXPECT_EQ(result.frame, FRAME);
+  EXPECT_EQ(decoder.get_timing_errors(), 1u);
+}
+
+// Every edge is delayed by a random interrupt latency of up to the given amplitude.
+// Up to OT_EDGE_JITTER_US every frame must come through unchanged; beyond it frames
+// may be rejected, and the misdecoded ones (wrong frame with good parity) are counted.
+TEST(ManchesterDecoder, RandomLatencyAcrossAmplitudes)
+{
+  const int FRAMES = 2000;
+  const uint32_t FRAME_SPACING_US = 100000; // 100 ms between frames, as on the bus
+  std::mt19937 random(26);
+
+  for (uint32_t amplitude : {0u, 25u, 50u, 75u, 100u, 150u, 200u, 250u, 300u})
+  {
+    std::uniform_int_distribution<uint32_t> latency(0, amplitude);
+    std::uniform_int_distribution<uint32_t> payload(0, 0x7FFFFFFFUL);
+
+    std::vector<uint32_t> frames;
+    std::vector<Edge> edges;
+    std::vector<size_t> frame_end; // index of each frame's last edge, to match decoded frames with sent ones
+    for (int i = 0; i < FRAMES; i++)
+    {
+      uint32_t frame = with_parity(payload(random));
+      frames.push_back(frame);
+      for (Edge edge : encode(frame, 10000 + i * FRAME_SPACING_US))
+      {
+        edge.timestamp_us += latency(random);
+        edges.push_back(edge);
+      }
+      frame_end.push_back(edges.size() - 1);
+    }
+
+    ManchesterDecoder decoder;
+    int accepted = 0, misdecoded = 0;
+    size_t frame = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+      uint32_t decoded;
+      if (decoder.feed(edges[i].timestamp_us, edges[i].level, decoded))
+      {
+        if (decoded == frames[frame])
+          accepted++;
+        else
+          misdecoded++;
+      }
+      if (i == frame_end[frame])
+        frame++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int rejected = FRAMES - accepted - misdecoded;
+
+    std::printf("latency 0..%3u us: %5.1f%% accepted, %5.1f%% rejected, %4.1f%% misdecoded, %.0f frames/s\n",
+                static_cast<unsigned>(amplitude), 100.0 * accepted / FRAMES, 100.0 * rejected / FRAMES,
+                100.0 * misdecoded / FRAMES, FRAMES / seconds);
+    if (amplitude <= OT_EDGE_JITTER_US)
+    {
+      EXPECT_EQ(misdecoded, 0) << "latency up to " << amplitude << " us";
+      EXPECT_EQ(accepted, FRAMES) << "latency up to " << amplitude << " us";
+    }
+  }
+}
+
+TEST(EdgeRingBuffer, PollDecodesFromRingAndCountsOverflow)
+{
+  EdgeRingBuffer ring;
+  ManchesterDecoder decoder;
+  for (const auto &edge : encode(FRAME, 10000))
+    ring.push(edge.timestamp_us, edge.level);
+
+  uint32_t frame = 0;
+  EXPECT_TRUE(decoder.poll(ring, frame));
+  EXPECT_EQ(frame, FRAME);
+  EXPECT_FALSE(decoder.poll(ring, frame));
+
+  // One slot always stays free to tell a full ring from an empty one
+  for (uint16_t i = 0; i < EdgeRingBuffer::SIZE; i++)
+    ring.push(i * 2, i & 1);
+  EXPECT_EQ(ring.get_overflows(), 1u);
+  ring.clear();
+  EXPECT_FALSE(decoder.poll(ring, frame));
+}
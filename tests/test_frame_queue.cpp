@@ -0,0 +1,99 @@
+#include "opentherm_frame_queue.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+using namespace esphome::opentherm;
+
+TEST(FrameQueue, HoldsSizeMinusOneAndCountsDrops)
+{
+  FrameQueue queue;
+  for (uint32_t i = 0; i < FrameQueue::SIZE - 1; i++)
+    EXPECT_TRUE(queue.push({i, static_cast<uint8_t>(i)}));
+  EXPECT_FALSE(queue.push({99, 99}));
+  EXPECT_FALSE(queue.push({100, 100}));
+  EXPECT_EQ(queue.get_dropped(), 2u);
+
+  // The dropped frames are the newest ones, everything queued before comes out in order
+  InterceptedFrame item;
+  for (uint32_t i = 0; i < FrameQueue::SIZE - 1; i++)
+  {
+    ASSERT_TRUE(queue.pop(item));
+    EXPECT_EQ(item.frame, i);
+    EXPECT_EQ(item.id, i);
+  }
+  EXPECT_FALSE(queue.pop(item));
+}
+
+TEST(FrameQueue, WrapsAroundManyTimes)
+{
+  FrameQueue queue;
+  InterceptedFrame item;
+  uint32_t next_pop = 0;
+  for (uint32_t i = 0; i < FrameQueue::SIZE * 40; i++)
+  {
+    ASSERT_TRUE(queue.push({i, static_cast<uint8_t>(i)}));
+    // Keep a few frames queued so head and tail wrap at different times
+    if (i >= 5)
+    {
+      ASSERT_TRUE(queue.pop(item));
+      EXPECT_EQ(item.frame, next_pop++);
+    }
+  }
+  while (queue.pop(item))
+    EXPECT_EQ(item.frame, next_pop++);
+  EXPECT_EQ(next_pop, FrameQueue::SIZE * 40u);
+  EXPECT_EQ(queue.get_dropped(), 0u);
+}
+
+TEST(FrameQueue, ProducerAndConsumerThreads)
+{
+  // The producer stands in for the bus task, the consumer for loop(). Every frame
+  // carries a sequence number; accepted frames must arrive complete and in order,
+  // and every rejected one must be counted as dropped.
+  const uint32_t FRAMES = 200000;
+  FrameQueue queue;
+  std::atomic<bool> done{false};
+  uint32_t accepted = 0;
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < FRAMES; i++)
+    {
+      if (queue.push({i, static_cast<uint8_t>(i * 7)}))
+        accepted++;
+      if (i % 1024 == 0)
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t received = 0;
+  int64_t last = -1;
+  bool ordered = true;
+  bool intact = true;
+  InterceptedFrame item;
+  for (;;)
+  {
+    bool finished = done.load(std::memory_order_acquire);
+    while (queue.pop(item))
+    {
+      ordered &= static_cast<int64_t>(item.frame) > last;
+      intact &= item.id == static_cast<uint8_t>(item.frame * 7);
+      last = item.frame;
+      received++;
+      // A slow consumer now and then, so the queue fills up and wraps while full
+      if (received % 4096 == 0)
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    if (finished)
+      break;
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(intact);
+  EXPECT_EQ(received, accepted);
+  EXPECT_EQ(accepted + queue.get_dropped(), FRAMES);
+  EXPECT_GT(queue.get_dropped(), 0u) << "consumer never fell behind, overflow path not exercised";
+}
@@ -0,0 +1,203 @@
+#include "opentherm_frame_server.h"
+
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace esphome::opentherm;
+
+namespace
+{
+  // Opens up the listener and the client slots
+  class LoopbackServer : public FrameServer
+  {
+  public:
+    uint16_t port()
+    {
+      struct sockaddr_in address;
+      socklen_t length = sizeof(address);
+      listener_->getsockname(reinterpret_cast<struct sockaddr *>(&address), &length);
+      return ntohs(address.sin_port);
+    }
+    Client &client(uint8_t index = 0) { return clients_[index]; }
+  };
+
+  int connect_to(uint16_t port)
+  {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    EXPECT_EQ(::connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)), 0);
+    return fd;
+  }
+
+  // Everything the client has buffered, without blocking
+  void drain(int fd, std::string &stream)
+  {
+    char buffer[4096];
+    ssize_t received;
+    while ((received = ::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+      stream.append(buffer, received);
+  }
+
+  void add_line(FrameServer &server, uint32_t &sequence)
+  {
+    FrameServer::Line line{'T', sequence++};
+    server.add(&line, 1);
+  }
+} // namespace
+
+// A reader that stops reading mid-line and is lapped by the writer must still
+// get whole lines, in order, with the skipped ones counted
+TEST(FrameServer, LappedSlowReaderKeepsLinesWhole)
+{
+  LoopbackServer server;
+  // Port 0 lets the kernel pick a free one
+  server.configure(0);
+  ASSERT_TRUE(server.setup());
+
+  int fd = connect_to(server.port());
+  for (int i = 0; i < 100 && server.get_clients() == 0; i++)
+  {
+    server.loop();
+    usleep(1000);
+  }
+  ASSERT_EQ(server.get_clients(), 1);
+
+  // A few lines go out whole, then the send buffer fills five bytes into a line
+  uint32_t sequence = 0;
+  for (int i = 0; i < 3; i++)
+    add_line(server, sequence);
+  server.client().socket->set_write_budget(3 * FrameServer::LINE_SIZE + 5);
+  for (int i = 0; i < 3; i++)
+    add_line(server, sequence);
+  server.loop();
+  ASSERT_EQ(server.client().offset, 5);
+
+  // The writer laps the reader while its line is cut off
+  for (size_t i = 0; i < 2 * FrameServer::RING_SIZE; i++)
+    add_line(server, sequence);
+  server.loop();
+  server.client().socket->set_write_budget(-1);
+
+  // Now the reader catches up
+  std::string stream;
+  for (int i = 0; i < 10000; i++)
+  {
+    server.loop();
+    drain(fd, stream);
+    if (stream.size() % FrameServer::LINE_SIZE == 0 && server.client().offset == 0 &&
+        server.client().cursor == server.get_lines())
+      break;
+    usleep(100);
+  }
+  ::close(fd);
+
+  ASSERT_EQ(stream.size() % FrameServer::LINE_SIZE, 0u);
+  EXPECT_GT(server.get_dropped(), 0u);
+
+  uint32_t expected = 0;
+  uint32_t skipped = 0;
+  for (size_t at = 0; at < stream.size(); at += FrameServer::LINE_SIZE)
+  {
+    std::string line = stream.substr(at, FrameServer::LINE_SIZE);
+    ASSERT_EQ(line[0], 'T') << "line " << at / FrameServer::LINE_SIZE << ": " << line;
+    ASSERT_EQ(line.substr(9), "\r\n") << "line " << at / FrameServer::LINE_SIZE << ": " << line;
+    uint32_t frame = std::stoul(line.substr(1, 8), nullptr, 16);
+    ASSERT_GE(frame, expected) << "line " << at / FrameServer::LINE_SIZE << " out of order";
+    skipped += frame - expected;
+    expected = frame + 1;
+  }
+  EXPECT_EQ(expected, sequence);
+  EXPECT_EQ(skipped, server.get_dropped());
+}
+
+// With every slot taken and one client reading a line per loop(), the others
+// must still get every line in order while the slow one is lapped
+TEST(FrameServer, SlowReaderDoesNotHoldBackOthers)
+{
+  const uint32_t LINES = 100000;
+  LoopbackServer server;
+  server.configure(0);
+  ASSERT_TRUE(server.setup());
+
+  // One at a time, so client i is in slot i
+  std::vector<int> fds;
+  for (uint8_t i = 0; i < FrameServer::MAX_CLIENTS; i++)
+  {
+    fds.push_back(connect_to(server.port()));
+    for (int j = 0; j < 100 && server.get_clients() == i; j++)
+    {
+      server.loop();
+      usleep(1000);
+    }
+    ASSERT_EQ(server.get_clients(), i + 1);
+  }
+  const uint8_t slow = FrameServer::MAX_CLIENTS - 1;
+
+  std::vector<std::string> streams(FrameServer::MAX_CLIENTS);
+  uint32_t sequence = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (sequence < LINES)
+  {
+    FrameServer::Line lines[FrameServer::MAX_GROUP];
+    for (uint8_t i = 0; i < FrameServer::MAX_GROUP; i++)
+      lines[i] = {'T', sequence++};
+    server.add(lines, FrameServer::MAX_GROUP);
+
+    server.client(slow).socket->set_write_budget(FrameServer::LINE_SIZE);
+    server.loop();
+    for (uint8_t i = 0; i < slow; i++)
+      drain(fds[i], streams[i]);
+  }
+  for (int i = 0; i < 1000 && server.client(0).cursor != server.get_lines(); i++)
+  {
+    server.loop();
+    for (uint8_t j = 0; j < slow; j++)
+      drain(fds[j], streams[j]);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  drain(fds[slow], streams[slow]);
+  for (int fd : fds)
+    ::close(fd);
+
+  uint32_t delivered = 0;
+  for (uint8_t i = 0; i < slow; i++)
+  {
+    ASSERT_EQ(streams[i].size(), LINES * FrameServer::LINE_SIZE) << "client " << static_cast<int>(i);
+    for (uint32_t line = 0; line < LINES; line++)
+    {
+      char expected[FrameServer::LINE_SIZE + 1];
+      std::snprintf(expected, sizeof(expected), "T%08X\r\n", static_cast<unsigned>(line));
+      ASSERT_EQ(streams[i].compare(line * FrameServer::LINE_SIZE, FrameServer::LINE_SIZE, expected), 0)
+          << "client " << static_cast<int>(i) << " line " << line;
+    }
+    delivered += LINES;
+  }
+
+  // The slow client only lost lines, counted, and never got half of one
+  const std::string &lossy = streams[slow];
+  EXPECT_EQ(lossy.size() % FrameServer::LINE_SIZE, 0u);
+  uint32_t expected = 0;
+  uint32_t skipped = 0;
+  for (size_t at = 0; at < lossy.size(); at += FrameServer::LINE_SIZE)
+  {
+    uint32_t frame = std::stoul(lossy.substr(at + 1, 8), nullptr, 16);
+    ASSERT_GE(frame, expected);
+    skipped += frame - expected;
+    expected = frame + 1;
+  }
+  EXPECT_GT(server.get_dropped(), 0u);
+  EXPECT_EQ(skipped, server.get_dropped());
+
+  std::printf("%u lines to %u clients in %.3f s: %.0f lines/s to the fast clients, slow client lost %u\n",
+              static_cast<unsigned>(LINES), FrameServer::MAX_CLIENTS, seconds, delivered / seconds,
+              static_cast<unsigned>(server.get_dropped()));
+}
@@ -0,0 +1,176 @@
+#include "opentherm_heating_controller.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+
+using namespace esphome::opentherm;
+
+namespace
+{
+  // Setpoint the gateway sent before the controller was configurable
+  float original_setpoint(float room, float target, float outside, float thermostat)
+  {
+    if (room > target + 0.2f)
+      return 20.0f;
+    if (room >= target - 0.5f)
+      return NAN;
+    if (std::isnan(outside))
+      return thermostat;
+    float water = 25.0f + 1.4f * (20.0f - outside);
+    return water < 25.0f ? 25.0f : (water > 75.0f ? 75.0f : water);
+  }
+} // namespace
+
+TEST(HysteresisController, MatchesOriginalSetpointsWithDefaultCurve)
+{
+  HysteresisController controller;
+  for (float target : {17.0f, 20.0f, 23.0f})
+  {
+    for (float outside : {-25.0f, -10.0f, 0.0f, 12.0f, 18.0f, 25.0f, NAN})
+    {
+      controller.on_outside_temperature(outside);
+      for (float room = target - 2.0f; room <= target + 1.0f; room += 0.1f)
+      {
+        controller.on_room_temperature(room, target, 0);
+        float expected = original_setpoint(room, target, outside, 45.0f);
+        float actual = controller.compute(target, 45.0f);
+        if (std::isnan(expected))
+          EXPECT_TRUE(std::isnan(actual)) << "room " << room << " target " << target << " outside " << outside;
+        else
+          EXPECT_FLOAT_EQ(actual, expected) << "room " << room << " target " << target << " outside " << outside;
+      }
+    }
+  }
+}
+
+TEST(HysteresisController, KeepsThermostatValueWithoutRoomTemperature)
+{
+  HysteresisController controller;
+  controller.on_outside_temperature(5.0f);
+  EXPECT_TRUE(std::isnan(controller.compute(21.0f, 45.0f)));
+}
+
+TEST(WeatherPIController, FreezesIntegralWhileSaturated)
+{
+  WeatherPIController controller;
+  controller.set_gains(8.0f, 2.0f);
+  controller.on_outside_temperature(-20.0f);
+
+  // A cold room against a saturated curve must not wind the integral up
+  uint32_t now = 1000;
+  for (int i = 0; i < 120; i++, now += 60000)
+    controller.on_room_temperature(15.0f, 21.0f, now);
+  EXPECT_FLOAT_EQ(controller.compute(21.0f, 60.0f), 75.0f);
+
+  // As soon as the room is warm the setpoint drops below the saturated curve
+  controller.on_outside_temperature(10.0f);
+  controller.on_room_temperature(21.5f, 21.0f, now);
+  float ff = controller.get_curve().feed_forward(21.0f, 10.0f);
+  EXPECT_LT(controller.compute(21.0f, 60.0f), ff);
+}
+
+TEST(HeatingController, ResetForgetsRoomTemperature)
+{
+  WeatherPIController controller;
+  controller.on_outside_temperature(5.0f);
+  controller.on_room_temperature(19.0f, 21.0f, 1000);
+  ASSERT_FALSE(std::isnan(controller.compute(21.0f, 45.0f)));
+
+  // The gateway seeds the controller with the cached room temperature after a reset
+  controller.reset();
+  EXPECT_TRUE(std::isnan(controller.compute(21.0f, 45.0f)));
+  controller.on_room_temperature(20.0f, 21.0f, 2000);
+  EXPECT_FLOAT_EQ(controller.compute(21.0f, 45.0f), controller.get_curve().feed_forward(21.0f, 5.0f) + 8.0f);
+}
+
+namespace
+{
+  // Closed loop of a room with a radiator circuit and an on/off modulating
+  // boiler, driven the way the gateway drives a controller: a Tr frame every
+  // minute from a room unit that lags the air and reports 0.1 °C steps, a TSet
+  // exchange every 10 s. The default curve fits the simulated house.
+  struct SimulationResult
+  {
+    float max_overshoot;
+    uint32_t burner_starts;
+    float final_room;
+  };
+
+  SimulationResult simulate(HeatingController &controller, float room_target)
+  {
+    const uint32_t STEP_S = 10;
+    const uint32_t HOURS = 24;
+    const float ROOM_CAPACITY = 5.0e6f;  // J/K, air, walls and furniture
+    const float ROOM_LOSS = 200.0f;      // W/K to the outside
+    const float WATER_CAPACITY = 5.0e5f; // J/K, water and radiator steel
+    const float RADIATOR = 150.0f;       // W/K from water to room
+    const float SENSOR_LAG_S = 900.0f;   // room unit time constant
+    const float BURNER_MIN = 3000.0f;    // W, lowest modulation
+    const float BURNER_MAX = 24000.0f;   // W
+    const float BURNER_GAIN = 1500.0f;   // W/K of water below the setpoint
+    const float BURNER_BAND = 5.0f;      // K, on below and off above the setpoint
+
+    float room = 17.0f; // back from a night setback
+    float sensed = room;
+    float water = 30.0f;
+    bool burner = false;
+    SimulationResult result{0.0f, 0, 0.0f};
+
+    controller.reset();
+    for (uint32_t step = 0; step < HOURS * 3600 / STEP_S; step++)
+    {
+      uint32_t now = 1000 + step * STEP_S * 1000;
+      // Mild day: -5 °C at night, +5 °C in the afternoon
+      float outside = -5.0f * std::cos(2.0f * static_cast<float>(M_PI) * now / (24.0f * 3600000.0f));
+      controller.on_outside_temperature(outside);
+      sensed += (room - sensed) * STEP_S / SENSOR_LAG_S;
+      if (step % 6 == 0)
+        controller.on_room_temperature(std::round(sensed * 10.0f) / 10.0f, room_target, now);
+
+      // The thermostat's own request, a curve for its 21 °C
+      float thermostat = 25.0f + 1.4f * (21.0f - outside);
+      float setpoint = controller.compute(room_target, thermostat);
+      if (std::isnan(setpoint))
+        setpoint = thermostat;
+
+      if (!burner && water < setpoint - BURNER_BAND)
+      {
+        burner = true;
+        result.burner_starts++;
+      }
+      else if (burner && water > setpoint + BURNER_BAND)
+        burner = false;
+      float heat = 0.0f;
+      if (burner)
+        heat = std::min(BURNER_MAX, std::max(BURNER_MIN, BURNER_GAIN * (setpoint - water)));
+
+      float radiated = RADIATOR * (water - room);
+      water += (heat - radiated) * STEP_S / WATER_CAPACITY;
+      room += (radiated - ROOM_LOSS * (room - outside)) * STEP_S / ROOM_CAPACITY;
+    }
+    result.max_overshoot = controller.get_max_overshoot();
+    result.final_room = room;
+    return result;
+  }
+} // namespace
+
+TEST(HeatingController, PIBeatsHysteresisInClosedLoop)
+{
+  const float TARGET = 21.0f;
+  HysteresisController hysteresis;
+  WeatherPIController pi;
+  // Tuned for the simulated house: the defaults (8, 2) wind the integral up
+  // while the room warms and overshoot 0.1 °C more than the hysteresis controller
+  pi.set_gains(16.0f, 1.0f);
+  SimulationResult h = simulate(hysteresis, TARGET);
+  SimulationResult p = simulate(pi, TARGET);
+  std::printf("hysteresis: max overshoot %.2f °C, %u burner starts, room %.2f °C after 24 h\n", h.max_overshoot,
+              static_cast<unsigned>(h.burner_starts), h.final_room);
+  std::printf("PI:         max overshoot %.2f °C, %u burner starts, room %.2f °C after 24 h\n", p.max_overshoot,
+              static_cast<unsigned>(p.burner_starts), p.final_room);
+
+  EXPECT_LT(p.max_overshoot, h.max_overshoot);
+  EXPECT_LT(p.burner_starts * 5, h.burner_starts);
+  EXPECT_NEAR(p.final_room, TARGET, 0.2f);
+}
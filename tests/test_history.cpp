@@ -0,0 +1,203 @@
+#include "opentherm_history.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace esphome::opentherm;
+
+namespace
+{
+  struct Sample
+  {
+    uint32_t time_ms;
+    uint8_t id;
+    uint16_t value;
+    bool operator==(const Sample &other) const
+    {
+      return time_ms == other.time_ms && id == other.id && value == other.value;
+    }
+  };
+
+  // Collects samples, stopping after `budget` of them per read() like a full chunk
+  struct Collector
+  {
+    std::vector<Sample> samples;
+    size_t budget{SIZE_MAX};
+    size_t taken{0};
+
+    static bool add(void *context, uint32_t time_ms, uint8_t id, uint16_t value)
+    {
+      Collector &self = *static_cast<Collector *>(context);
+      if (self.taken == self.budget)
+        return false;
+      self.taken++;
+      self.samples.push_back({time_ms, id, value});
+      return true;
+    }
+  };
+
+  const uint8_t IDS[] = {0, 16, 17, 18, 24, 25, 26, 28};
+
+  void record(HistoryBuffer &history, uint32_t &now, int count)
+  {
+    for (int i = 0; i < count; i++, now += 1000)
+      history.add(IDS[i % 8], static_cast<uint16_t>(i * 37), now);
+  }
+
+  std::vector<Sample> read_in_chunks(const HistoryBuffer &history, size_t chunk, uint32_t since_ms = 0)
+  {
+    Collector collector;
+    collector.budget = chunk;
+    HistoryBuffer::Cursor cursor = history.begin();
+    for (int calls = 0; !history.read(cursor, since_ms, Collector::add, &collector); calls++)
+    {
+      EXPECT_LT(calls, 100000);
+      collector.taken = 0;
+    }
+    return collector.samples;
+  }
+} // namespace
+
+TEST(HistoryBuffer, ResumedReadsMatchSinglePass)
+{
+  HistoryBuffer history;
+  history.configure(4 * HistoryBuffer::BLOCK_SIZE);
+  ASSERT_TRUE(history.setup());
+  uint32_t now = 5000;
+  record(history, now, 1500);
+
+  std::vector<Sample> whole = read_in_chunks(history, SIZE_MAX);
+  ASSERT_FALSE(whole.empty());
+  for (size_t chunk : {1, 7, 64})
+    EXPECT_EQ(read_in_chunks(history, chunk), whole) << "chunk " << chunk;
+
+  // since= drops everything older, the rest is unchanged
+  uint32_t since = whole[whole.size() / 2].time_ms;
+  std::vector<Sample> tail = read_in_chunks(history, 5, since);
+  ASSERT_FALSE(tail.empty());
+  EXPECT_EQ(tail.front().time_ms, since);
+  EXPECT_EQ(tail.back(), whole.back());
+}
+
+TEST(HistoryBuffer, CursorSkipsBlocksOverwrittenBetweenReads)
+{
+  HistoryBuffer history;
+  history.configure(3 * HistoryBuffer::BLOCK_SIZE);
+  ASSERT_TRUE(history.setup());
+  uint32_t now = 1000;
+  record(history, now, 400);
+
+  Collector collector;
+  collector.budget = 10;
+  HistoryBuffer::Cursor cursor = history.begin();
+  ASSERT_FALSE(history.read(cursor, 0, Collector::add, &collector));
+  uint32_t last_read = collector.samples.back().time_ms;
+
+  // The writer laps the reader before it comes back
+  record(history, now, 1200);
+  collector.budget = SIZE_MAX;
+  ASSERT_TRUE(history.read(cursor, 0, Collector::add, &collector));
+  EXPECT_GT(cursor.lost_blocks, 0u);
+  EXPECT_GT(collector.samples[10].time_ms, last_read + 1000);
+  for (size_t i = 1; i < collector.samples.size(); i++)
+    EXPECT_GT(collector.samples[i].time_ms, collector.samples[i - 1].time_ms);
+  EXPECT_EQ(collector.samples.back().time_ms, now - 1000);
+}
+
+TEST(HistoryBuffer, ReaderThreadWhileLoopAdds)
+{
+  // The web server reads in its own task while loop() keeps adding
+  HistoryBuffer history;
+  history.configure(4 * HistoryBuffer::BLOCK_SIZE);
+  ASSERT_TRUE(history.setup());
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    uint32_t now = 1000;
+    for (int i = 0; i < 50000; i++, now += 100)
+      history.add(IDS[i % 8], static_cast<uint16_t>(i), now);
+    done.store(true);
+  });
+
+  bool ordered = true;
+  while (!done.load())
+  {
+    std::vector<Sample> samples = read_in_chunks(history, 16);
+    for (size_t i = 1; i < samples.size(); i++)
+      ordered &= samples[i].time_ms > samples[i - 1].time_ms;
+  }
+  writer.join();
+  EXPECT_TRUE(ordered);
+}
+
+TEST(HistoryBuffer, DecodesRecordedSamplesRoundedToTheTick)
+{
+  HistoryBuffer history;
+  history.configure(16 * HistoryBuffer::BLOCK_SIZE);
+  ASSERT_TRUE(history.setup());
+
+  // Regular polls, jittered ones off the tick, and gaps from seconds to hours that
+  // only fit the delta-of-delta as a varint, shrinking again just as abruptly
+  const uint32_t GAPS_MS[] = {1000, 1000, 1000, 1049, 951, 1234, 100, 99, 15000, 1000, 600000, 1000, 10800000, 1, 5000};
+  std::vector<Sample> expected;
+  uint32_t now = 5049;
+  uint16_t last[8]{};
+  uint32_t recorded[8]{};
+  for (int i = 0; i < 600; i++)
+  {
+    uint8_t series = i % 8;
+    // Mostly small changes, now and then a full-width one, and values that stay the same
+    uint16_t value = last[series];
+    if (i % 5 == 1)
+      value ^= 0xA5C3;
+    else if (i % 5 != 4)
+      value += 3;
+    history.add(IDS[series], value, now);
+    // Unchanged values are only recorded again after REPEAT_INTERVAL_MS
+    if (i < 8 || value != last[series] || now - recorded[series] >= HistoryBuffer::REPEAT_INTERVAL_MS)
+    {
+      expected.push_back({now / HistoryBuffer::TICK_MS * HistoryBuffer::TICK_MS, IDS[series], value});
+      recorded[series] = now;
+    }
+    last[series] = value;
+    now += GAPS_MS[i % (sizeof(GAPS_MS) / sizeof(GAPS_MS[0]))];
+  }
+
+  std::vector<Sample> decoded = read_in_chunks(history, SIZE_MAX);
+  ASSERT_EQ(decoded.size(), expected.size());
+  for (size_t i = 0; i < decoded.size(); i++)
+  {
+    EXPECT_EQ(decoded[i].time_ms, expected[i].time_ms) << "sample " << i;
+    EXPECT_EQ(decoded[i].id, expected[i].id) << "sample " << i;
+    EXPECT_EQ(decoded[i].value, expected[i].value) << "sample " << i;
+  }
+  EXPECT_EQ(history.get_samples(), expected.size());
+  EXPECT_EQ(history.get_skipped(), 600 - expected.size());
+}
+
+TEST(HistoryBuffer, SteadySeriesCostsAboutOneBytePerSample)
+{
+  HistoryBuffer history;
+  history.configure(8 * HistoryBuffer::BLOCK_SIZE);
+  ASSERT_TRUE(history.setup());
+
+  // Tboiler polled every second at a constant value: recorded once a minute, with
+  // the same time delta every time, until the ring has wrapped
+  uint32_t now = 1000;
+  for (int i = 0; i < 200000; i++, now += 1000)
+    history.add(25, 0x2D80, now);
+
+  uint32_t samples;
+  size_t bytes;
+  history.get_usage(samples, bytes);
+  ASSERT_GT(samples, 0u);
+  // Block headers included; each block restarts the encoding from its header,
+  // which costs a few bytes for its first two records
+  double per_sample = static_cast<double>(bytes) / samples;
+  std::printf("steady series: %u samples in %u bytes, %.3f bytes per sample\n", static_cast<unsigned>(samples),
+              static_cast<unsigned>(bytes), per_sample);
+  EXPECT_LE(per_sample, 1.1);
+}
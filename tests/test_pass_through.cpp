@@ -0,0 +1,101 @@
+#include "opentherm_component.h"
+
+#include <gtest/gtest.h>
+
+using namespace esphome::opentherm;
+
+namespace esphome
+{
+  namespace opentherm
+  {
+    // The component with its deadline check opened up, listen-only so setup() stays off the bus
+    class DeadlineGateway : public OpenthermComponent
+    {
+    public:
+      DeadlineGateway() : OpenthermComponent(60000)
+      {
+        set_listen_only(true);
+        set_pass_through_deadline(650);
+      }
+
+      using OpenthermComponent::checkPassThroughResponse;
+      uint32_t misses() const { return deadline_misses_total_; }
+      OpenTherm &bus() { return *ot_; }
+    };
+  } // namespace opentherm
+} // namespace esphome
+
+namespace
+{
+  class PassThroughTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      esphome::test::set_micros(0);
+      gateway.setup();
+    }
+
+    unsigned long read(OpenThermMessageID id, uint16_t data = 0)
+    {
+      return OpenTherm::buildRequest(OpenThermMessageType::READ_DATA, id, data);
+    }
+    unsigned long reply(OpenThermMessageType type, OpenThermMessageID id, uint16_t data)
+    {
+      return OpenTherm::buildResponse(type, id, data);
+    }
+    OpenThermMessageType type_of(unsigned long frame) { return gateway.bus().getMessageType(frame); }
+
+    DeadlineGateway gateway;
+  };
+} // namespace
+
+TEST_F(PassThroughTest, PromptNonAckRepliesAreForwarded)
+{
+  unsigned long ack = reply(OpenThermMessageType::READ_ACK, OpenThermMessageID::Tdhw, 0x3000);
+  ASSERT_EQ(gateway.checkPassThroughResponse(read(OpenThermMessageID::Tdhw), ack), ack);
+
+  unsigned long invalid = reply(OpenThermMessageType::DATA_INVALID, OpenThermMessageID::Tdhw, 0);
+  EXPECT_EQ(gateway.checkPassThroughResponse(read(OpenThermMessageID::Tdhw), invalid), invalid);
+  unsigned long unknown = reply(OpenThermMessageType::UNKNOWN_DATA_ID, OpenThermMessageID::TrOverride, 0);
+  EXPECT_EQ(gateway.checkPassThroughResponse(read(OpenThermMessageID::TrOverride), unknown), unknown);
+  EXPECT_EQ(gateway.misses(), 0u);
+}
+
+TEST_F(PassThroughTest, MissingOrCorruptRepliesFallBack)
+{
+  unsigned long ack = reply(OpenThermMessageType::READ_ACK, OpenThermMessageID::Tdhw, 0x3000);
+  gateway.checkPassThroughResponse(read(OpenThermMessageID::Tdhw), ack);
+
+  EXPECT_EQ(gateway.checkPassThroughResponse(read(OpenThermMessageID::Tdhw), 0), ack);
+  EXPECT_EQ(gateway.checkPassThroughResponse(read(OpenThermMessageID::Tdhw), ack ^ 1), ack); // parity error
+  EXPECT_EQ(gateway.misses(), 2u);
+
+  // Without a cached reply, or for a write, the gateway answers DATA-INVALID itself
+  EXPECT_EQ(type_of(gateway.checkPassThroughResponse(read(OpenThermMessageID::Tret), 0)),
+            OpenThermMessageType::DATA_INVALID);
+  unsigned long write = OpenTherm::buildRequest(OpenThermMessageType::WRITE_DATA, OpenThermMessageID::TSet, 0x2D00);
+  EXPECT_EQ(type_of(gateway.checkPassThroughResponse(write, 0)), OpenThermMessageType::DATA_INVALID);
+}
+
+TEST_F(PassThroughTest, FallbackNeedsSameRequestAndRecentReply)
+{
+  unsigned long status = reply(OpenThermMessageType::READ_ACK, OpenThermMessageID::Status, 0x030A);
+  gateway.checkPassThroughResponse(read(OpenThermMessageID::Status, 0x0300), status);
+  // The master status in the request changed, the cached reply answered another question
+  EXPECT_EQ(type_of(gateway.checkPassThroughResponse(read(OpenThermMessageID::Status, 0x0100), 0)),
+            OpenThermMessageType::DATA_INVALID);
+  EXPECT_EQ(gateway.checkPassThroughResponse(read(OpenThermMessageID::Status, 0x0300), 0), status);
+
+  esphome::test::advance_micros(121000000ULL);
+  EXPECT_EQ(type_of(gateway.checkPassThroughResponse(read(OpenThermMessageID::Status, 0x0300), 0)),
+            OpenThermMessageType::DATA_INVALID);
+}
+
+TEST_F(PassThroughTest, IndexedTablesAreNeverSubstituted)
+{
+  unsigned long entry = reply(OpenThermMessageType::READ_ACK, OpenThermMessageID::TSPindexTSPvalue, 0x0342);
+  gateway.checkPassThroughResponse(read(OpenThermMessageID::TSPindexTSPvalue, 0x0300), entry);
+  EXPECT_EQ(type_of(gateway.checkPassThroughResponse(read(OpenThermMessageID::TSPindexTSPvalue, 0x0300), 0)),
+            OpenThermMessageType::DATA_INVALID);
+}
@@ -0,0 +1,130 @@
+#include "opentherm_transmitter.h"
+
+#include <Arduino.h>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace esphome::opentherm;
+
+namespace
+{
+  const int OUT_PIN = 4;
+  const uint32_t START_US = 1000;
+  const uint32_t FRAME = 0x10190000UL | 0x3C00; // WRITE of ID 25
+
+  // Line levels the transmitter has to produce, one per half bit. The adapter
+  // output is inverted: an active half bit drives the pin LOW.
+  std::vector<uint8_t> expected_halves(uint32_t frame)
+  {
+    std::vector<uint8_t> halves;
+    auto add_bit = [&](bool bit) {
+      halves.push_back(bit ? LOW : HIGH);
+      halves.push_back(bit ? HIGH : LOW);
+    };
+    add_bit(true);
+    for (int i = 31; i >= 0; i--)
+      add_bit((frame >> i) & 1);
+    add_bit(true);
+    return halves;
+  }
+
+  // Runs the frame to the end, firing timer1 when it is due plus latency_us()
+  template <typename Latency> void transmit(FrameTransmitter &transmitter, uint32_t frame, Latency latency_us)
+  {
+    arduino_test::reset();
+    ASSERT_TRUE(transmitter.setup());
+    esphome::test::set_micros(START_US);
+    ASSERT_TRUE(transmitter.start(OUT_PIN, frame));
+
+    auto &timer = arduino_test::timer1();
+    for (int fired = 0; transmitter.is_busy(); fired++)
+    {
+      ASSERT_LT(fired, 100) << "transmitter never finished";
+      ASSERT_TRUE(timer.enabled);
+      ASSERT_TRUE(timer.armed);
+      EXPECT_FALSE(transmitter.start(OUT_PIN, frame)) << "second frame accepted while busy";
+      timer.armed = false;
+      esphome::test::advance_micros(timer.ticks / 5 + latency_us());
+      timer.callback();
+    }
+    EXPECT_FALSE(timer.enabled);
+  }
+
+  // Pin level at each half bit, sampled in the middle of it
+  std::vector<uint8_t> sample_halves(const std::vector<arduino_test::PinWrite> &writes, size_t count)
+  {
+    std::vector<uint8_t> halves;
+    size_t next = 0;
+    uint8_t level = HIGH;
+    for (size_t i = 0; i < count; i++)
+    {
+      uint64_t at = START_US + i * FrameTransmitter::HALF_BIT_US + FrameTransmitter::HALF_BIT_US / 2;
+      while (next < writes.size() && writes[next].timestamp_us <= at)
+        level = writes[next++].value;
+      halves.push_back(level);
+    }
+    return halves;
+  }
+} // namespace
+
+TEST(FrameTransmitter, ClocksOutManchesterFrameOnSchedule)
+{
+  FrameTransmitter transmitter;
+  transmit(transmitter, FRAME, [] { return 0u; });
+
+  const auto &writes = arduino_test::pin_writes();
+  std::vector<uint8_t> expected = expected_halves(FRAME);
+  EXPECT_EQ(sample_halves(writes, expected.size()), expected);
+
+  // Every write lands on a half-bit boundary and, up to the final idle write, only where the level changes
+  ASSERT_GE(writes.size(), 2u);
+  for (size_t i = 0; i < writes.size(); i++)
+  {
+    EXPECT_EQ(writes[i].pin, OUT_PIN);
+    EXPECT_EQ((writes[i].timestamp_us - START_US) % FrameTransmitter::HALF_BIT_US, 0u) << "write " << i;
+  }
+  for (size_t i = 1; i + 1 < writes.size(); i++)
+    EXPECT_NE(writes[i].value, writes[i - 1].value) << "write " << i;
+  // The line is left idle once the stop bit is complete, 34 bits after the start
+  EXPECT_EQ(writes.back().value, HIGH);
+  EXPECT_EQ(writes.back().timestamp_us, START_US + expected.size() * FrameTransmitter::HALF_BIT_US);
+  EXPECT_EQ(transmitter.get_frames(), 1u);
+  EXPECT_EQ(transmitter.get_max_lateness(), 0u);
+}
+
+TEST(FrameTransmitter, InterruptLatencyDoesNotAccumulate)
+{
+  const uint32_t MAX_LATENCY_US = 60;
+  std::mt19937 random(7);
+  std::uniform_int_distribution<uint32_t> latency(0, MAX_LATENCY_US);
+
+  FrameTransmitter transmitter;
+  transmit(transmitter, FRAME, [&] { return latency(random); });
+
+  // Each edge is late by its own callback's latency only, the schedule is absolute
+  const auto &writes = arduino_test::pin_writes();
+  for (size_t i = 1; i < writes.size(); i++)
+  {
+    uint64_t offset = (writes[i].timestamp_us - START_US) % FrameTransmitter::HALF_BIT_US;
+    EXPECT_LE(offset, MAX_LATENCY_US) << "write " << i;
+  }
+  std::vector<uint8_t> expected = expected_halves(FRAME);
+  EXPECT_EQ(sample_halves(writes, expected.size()), expected);
+  EXPECT_GT(transmitter.get_max_lateness(), 0u);
+  EXPECT_LE(transmitter.get_max_lateness(), MAX_LATENCY_US);
+}
+
+TEST(FrameTransmitter, LateCallbackArmsMinimumDelay)
+{
+  // A callback later than a whole step still re-arms the timer instead of a negative delay
+  bool first = true;
+  FrameTransmitter transmitter;
+  transmit(transmitter, 0xFFFFFFFFUL, [&] {
+    bool late = first;
+    first = false;
+    return late ? 1200u : 0u;
+  });
+  EXPECT_GE(transmitter.get_max_lateness(), 1200u);
+  EXPECT_EQ(arduino_test::pin_writes().back().value, HIGH);
+}
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""Compare OpenTherm gateway hot-path timings between two firmware builds.
+
+With `profiler:` enabled the gateway logs one line per hot path every update
+interval, e.g.
+
+  [D][opentherm.profiler]: hotpath v1 path=pass_through n=42 mean_ns=3100 min_ns=2700 max_ns=9800 cpu_mhz=80
+
+Save the logs of both builds (`esphome logs gateway.yaml > before.log`) and run
+
+  compare_hotpaths.py before.log after.log
+
+Per path, samples of all windows are pooled (mean weighted by n).
+"""
+
+import argparse
+import re
+import sys
+
+LINE = re.compile(r"hotpath v1 path=(\w+) n=(\d+) mean_ns=(\d+) min_ns=(\d+) max_ns=(\d+) cpu_mhz=(\d+)")
+
+
+def load(path):
+    paths = {}
+    with open(path, errors="replace") as log:
+        for match in LINE.finditer(log.read()):
+            name = match.group(1)
+            n, mean, low, high = (int(match.group(i)) for i in range(2, 6))
+            entry = paths.setdefault(name, {"n": 0, "total": 0, "min": low, "max": high})
+            entry["n"] += n
+            entry["total"] += mean * n
+            entry["min"] = min(entry["min"], low)
+            entry["max"] = max(entry["max"], high)
+    return {name: dict(e, mean=e["total"] / e["n"]) for name, e in paths.items() if e["n"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("before")
+    parser.add_argument("after", nargs="?")
+    args = parser.parse_args()
+
+    before = load(args.before)
+    if args.after is None:
+        print("path,n,mean_ns,min_ns,max_ns")
+        for name, e in sorted(before.items()):
+            print(f"{name},{e['n']},{e['mean']:.0f},{e['min']},{e['max']}")
+        return 0
+
+    after = load(args.after)
+    print("path,before_mean_ns,after_mean_ns,change_pct,before_n,after_n")
+    for name in sorted(set(before) | set(after)):
+        b, a = before.get(name), after.get(name)
+        if b is None or a is None:
+            print(f"{name},{b['mean'] if b else ''},{a['mean'] if a else ''},,{b['n'] if b else 0},{a['n'] if a else 0}")
+            continue
+        change = (a["mean"] - b["mean"]) / b["mean"] * 100
+        print(f"{name},{b['mean']:.0f},{a['mean']:.0f},{change:+.1f},{b['n']},{a['n']}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
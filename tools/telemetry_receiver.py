@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Receiver for the OpenTherm gateway UDP telemetry stream.
+
+Decodes datagrams sent by the `telemetry:` option and prints the frames,
+or only periodic throughput statistics with --stats.
+
+Datagram layout (little-endian):
+  header:  'O' 'T' version:u8 count:u8 sequence:u16 base_ms:u32
+  records: data_id:u8 delta_ms:u16 value:u16
+"""
+
+import argparse
+import socket
+import struct
+import time
+
+HEADER = struct.Struct("<2sBBHI")
+RECORD = struct.Struct("<BHH")
+
+
+def decode(datagram):
+    magic, version, count, sequence, base_ms = HEADER.unpack_from(datagram)
+    if magic != b"OT" or version != 1:
+        raise ValueError("not an OpenTherm telemetry datagram")
+    if len(datagram) != HEADER.size + count * RECORD.size:
+        raise ValueError("truncated datagram")
+    records = [
+        RECORD.unpack_from(datagram, HEADER.size + i * RECORD.size)
+        for i in range(count)
+    ]
+    return sequence, [(data_id, base_ms + delta, value) for data_id, delta, value in records]
+
+
+def f88(value):
+    """OpenTherm f8.8 fixed point to float."""
+    if value & 0x8000:
+        value -= 0x10000
+    return value / 256.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=7411)
+    parser.add_argument("--stats", type=float, metavar="SECONDS",
+                        help="only print throughput every SECONDS")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+
+    gateways = {}  # source address -> last sequence
+    datagrams = records = octets = lost = errors = 0
+    window_start = time.monotonic()
+
+    while True:
+        datagram, source = sock.recvfrom(2048)
+        try:
+            sequence, frames = decode(datagram)
+        except (ValueError, struct.error):
+            errors += 1
+            continue
+
+        last = gateways.get(source[0])
+        if last is not None:
+            lost += (sequence - last - 1) & 0xFFFF
+        gateways[source[0]] = sequence
+        datagrams += 1
+        records += len(frames)
+        octets += len(datagram)
+
+        if args.stats is None:
+            for data_id, timestamp_ms, value in frames:
+                print(f"{source[0]} {timestamp_ms:>10} id={data_id:<3} raw=0x{value:04X} f88={f88(value):.2f}")
+            continue
+
+        elapsed = time.monotonic() - window_start
+        if elapsed >= args.stats:
+            print(f"{len(gateways)} gateways, {datagrams / elapsed:.1f} datagrams/s, "
+                  f"{records / elapsed:.1f} frames/s, {octets / elapsed:.0f} B/s, "
+                  f"{octets / max(records, 1):.2f} B/frame, {lost} lost, {errors} invalid")
+            datagrams = records = octets = lost = errors = 0
+            window_start = time.monotonic()
+
+
+if __name__ == "__main__":
+    main()